@@ -68,6 +68,14 @@ find_program(PCUT_PREPROCESSOR
 	HINTS ${PCUT_ROOT}
 	PATH_SUFFIXES bin)
 
+# Installed libpcut is a static library thus its own dependencies
+# (threads and dlopen() on Unix) have to be linked explicitly.
+if(UNIX AND PCUT_LIBRARIES AND NOT TARGET pcut
+		AND NOT "Threads::Threads" IN_LIST PCUT_LIBRARIES)
+	find_package(Threads REQUIRED)
+	list(APPEND PCUT_LIBRARIES Threads::Threads ${CMAKE_DL_LIBS})
+endif()
+
 
 if(PCUT_INCLUDE_DIRS)
 	set(PCUT_FOUND true)
@@ -28,15 +28,27 @@
 
 SOURCES = \
 	src/os/helenos.c \
+	src/alloc.c \
 	src/assert.c \
+	src/baseline.c \
+	src/benchmark.c \
 	src/helper.c \
+	src/histogram.c \
 	src/list.c \
+	src/lock.c \
 	src/main.c \
 	src/print.c \
+	src/profile.c \
+	src/report/journal.c \
+	src/report/progress.c \
+	src/report/reorder.c \
 	src/report/report.c \
+	src/report/summary.c \
 	src/report/tap.c \
 	src/report/xml.c \
-	src/run.c
+	src/run.c \
+	src/syscall.c \
+	src/timer.c
 
 EXTRA_CFLAGS = -D__helenos__ -Wno-unknown-pragmas
 
@@ -6,27 +6,60 @@ $(PCUT_TEST_PREFIX)abort$(PCUT_TEST_SUFFIX): tests/abort.o
 # asserts
 $(PCUT_TEST_PREFIX)asserts$(PCUT_TEST_SUFFIX): tests/asserts.o
 
+# baseline
+$(PCUT_TEST_PREFIX)baseline$(PCUT_TEST_SUFFIX): tests/baseline.o
+
 # beforeafter
 $(PCUT_TEST_PREFIX)beforeafter$(PCUT_TEST_SUFFIX): tests/beforeafter.o
 
+# benchcold
+$(PCUT_TEST_PREFIX)benchcold$(PCUT_TEST_SUFFIX): tests/benchcold.o
+
+# benchinstr
+$(PCUT_TEST_PREFIX)benchinstr$(PCUT_TEST_SUFFIX): tests/benchinstr.o
+
+# benchcompare
+$(PCUT_TEST_PREFIX)benchcompare$(PCUT_TEST_SUFFIX): tests/benchcompare.o
+
+# benchmark
+$(PCUT_TEST_PREFIX)benchmark$(PCUT_TEST_SUFFIX): tests/benchmark.o
+
+# complexity
+$(PCUT_TEST_PREFIX)complexity$(PCUT_TEST_SUFFIX): tests/complexity.o
+
 # errno
 $(PCUT_TEST_PREFIX)errno$(PCUT_TEST_SUFFIX): tests/errno.o
 
 # inithook
 $(PCUT_TEST_PREFIX)inithook$(PCUT_TEST_SUFFIX): tests/inithook.o
 
+# latency
+$(PCUT_TEST_PREFIX)latency$(PCUT_TEST_SUFFIX): tests/latency.o
+
 # manytests
 $(PCUT_TEST_PREFIX)manytests$(PCUT_TEST_SUFFIX): tests/manytests.o
 
 # multisuite
 $(PCUT_TEST_PREFIX)multisuite$(PCUT_TEST_SUFFIX): tests/suite_all.o tests/suite1.o tests/suite2.o tests/tested.o
 
+# parallel
+$(PCUT_TEST_PREFIX)parallel$(PCUT_TEST_SUFFIX): tests/parallel.o
+
+# perfcounters
+$(PCUT_TEST_PREFIX)perfcounters$(PCUT_TEST_SUFFIX): tests/perfcounters.o
+
 # preinithook
 $(PCUT_TEST_PREFIX)preinithook$(PCUT_TEST_SUFFIX): tests/inithook.o
 
 # printing
 $(PCUT_TEST_PREFIX)printing$(PCUT_TEST_SUFFIX): tests/printing.o
 
+# printmeasure
+$(PCUT_TEST_PREFIX)printmeasure$(PCUT_TEST_SUFFIX): tests/printmeasure.o
+
+# resume
+$(PCUT_TEST_PREFIX)resume$(PCUT_TEST_SUFFIX): tests/resume.o
+
 # simple
 $(PCUT_TEST_PREFIX)simple$(PCUT_TEST_SUFFIX): tests/simple.o tests/tested.o
 
@@ -36,6 +69,9 @@ $(PCUT_TEST_PREFIX)skip$(PCUT_TEST_SUFFIX): tests/skip.o
 # suites
 $(PCUT_TEST_PREFIX)suites$(PCUT_TEST_SUFFIX): tests/suites.o tests/tested.o
 
+# summary
+$(PCUT_TEST_PREFIX)summary$(PCUT_TEST_SUFFIX): tests/summary.o
+
 # teardownaborts
 $(PCUT_TEST_PREFIX)teardownaborts$(PCUT_TEST_SUFFIX): tests/teardownaborts.o
 
@@ -45,9 +81,15 @@ $(PCUT_TEST_PREFIX)teardown$(PCUT_TEST_SUFFIX): tests/teardown.o tests/tested.o
 # testlist
 $(PCUT_TEST_PREFIX)testlist$(PCUT_TEST_SUFFIX): tests/testlist.o
 
+# timebudget
+$(PCUT_TEST_PREFIX)timebudget$(PCUT_TEST_SUFFIX): tests/timebudget.o
+
 # timeout
 $(PCUT_TEST_PREFIX)timeout$(PCUT_TEST_SUFFIX): tests/timeout.o
 
+# timer
+$(PCUT_TEST_PREFIX)timer$(PCUT_TEST_SUFFIX): tests/timer.o
+
 # xmlreport
 $(PCUT_TEST_PREFIX)xmlreport$(PCUT_TEST_SUFFIX): tests/xmlreport.o tests/tested.o
 
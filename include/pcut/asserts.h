@@ -78,6 +78,49 @@ int pcut_str_equals(const char *a, const char *b);
  */
 void pcut_str_error(int error, char *buffer, int size);
 
+/** Get number of heap allocations made so far by the current test.
+ *
+ * @return Number of allocations.
+ * @retval -1 Allocations are not tracked (pcutalloc is not linked in).
+ */
+long pcut_get_allocation_count(void);
+
+/** Get number of contended lock acquisitions so far in the current test.
+ *
+ * @return Number of acquisitions that had to wait for another thread.
+ * @retval -1 Locks are not tracked (pcutlock is not linked in).
+ */
+long pcut_get_contended_lock_count(void);
+
+/** Get how much the peak resident set size grew during the current test.
+ *
+ * @return Growth in bytes since the start of the test set-up.
+ * @retval -1 Resident set size is not available on this platform.
+ */
+long long pcut_get_peak_rss_growth(void);
+
+/** Get complexity class measured by the last PCUT_MEASURE_COMPLEXITY().
+ *
+ * @return Complexity class (PCUT_O_*).
+ * @retval -1 Complexity was not measured.
+ */
+int pcut_get_complexity(void);
+
+/** Get latency percentile measured by the last PCUT_MEASURE_LATENCY().
+ *
+ * @param percentile Percentile (e.g. 99.9).
+ * @return Latency in nanoseconds.
+ * @retval -1 Latency was not measured.
+ */
+long long pcut_get_latency_percentile(double percentile);
+
+/** Get human-readable name of a complexity class.
+ *
+ * @param complexity Complexity class (PCUT_O_*).
+ * @return Name such as "O(n log n)".
+ */
+const char *pcut_complexity_name(int complexity);
+
 /** Raise assertion error (internal version).
  *
  * We expect to be always called from PCUT_ASSERTION_FAILED() where
@@ -292,6 +335,107 @@ void pcut_str_error(int error, char *buffer, int size);
 #define PCUT_ASSERT_ERRNO(expected) \
 	PCUT_ASSERT_ERRNO_VAL_WITH_NAME(expected, #expected, (errno))
 
+/** Assertion for the number of heap allocations made by the current test.
+ *
+ * Counts allocations since the start of the test body (set-up is
+ * not included).
+ * Use PCUT_ASSERT_MAX_ALLOCATIONS(0) to check that a code path does
+ * not allocate at all.
+ *
+ * The test program has to be linked with the pcutalloc library,
+ * otherwise the assertion always fails.
+ *
+ * @param max Maximum allowed number of allocations.
+ */
+#define PCUT_ASSERT_MAX_ALLOCATIONS(max) \
+	do { \
+		long pcut_allocation_count = pcut_get_allocation_count(); \
+		if (pcut_allocation_count < 0) { \
+			PCUT_ASSERTION_FAILED("Allocations are not tracked (link with pcutalloc)"); \
+		} else if (pcut_allocation_count > (long) (max)) { \
+			PCUT_ASSERTION_FAILED("Expected at most %ld allocations but got %ld", \
+				(long) (max), pcut_allocation_count); \
+		} \
+	} while (0)
+
+/** Assertion for the number of contended lock acquisitions in the current test.
+ *
+ * Counts acquisitions of pthread mutexes and read-write locks that
+ * had to wait for another thread since the start of the test body.
+ *
+ * The test program has to be linked with the pcutlock library,
+ * otherwise the assertion always fails.
+ *
+ * @param max Maximum allowed number of contended acquisitions.
+ */
+#define PCUT_ASSERT_MAX_CONTENDED_LOCKS(max) \
+	do { \
+		long pcut_contended_lock_count = pcut_get_contended_lock_count(); \
+		if (pcut_contended_lock_count < 0) { \
+			PCUT_ASSERTION_FAILED("Locks are not tracked (link with pcutlock)"); \
+		} else if (pcut_contended_lock_count > (long) (max)) { \
+			PCUT_ASSERTION_FAILED("Expected at most %ld contended lock acquisitions but got %ld", \
+				(long) (max), pcut_contended_lock_count); \
+		} \
+	} while (0)
+
+/** Assertion for the peak memory used by the current test.
+ *
+ * Checks growth of the peak resident set size since the start
+ * of the test set-up (see PCUT_TEST_MEMORY_LIMIT()).
+ *
+ * @param bytes Limit in bytes (exclusive).
+ */
+#define PCUT_ASSERT_PEAK_RSS_BELOW(bytes) \
+	do { \
+		long long pcut_peak_rss_growth = pcut_get_peak_rss_growth(); \
+		if (pcut_peak_rss_growth < 0) { \
+			PCUT_ASSERTION_FAILED("Peak RSS is not available on this platform"); \
+		} else if (pcut_peak_rss_growth >= (long long) (bytes)) { \
+			PCUT_ASSERTION_FAILED("Expected peak RSS below %lld bytes but got %lld", \
+				(long long) (bytes), pcut_peak_rss_growth); \
+		} \
+	} while (0)
+
+/** Assertion for latency percentile measured by PCUT_MEASURE_LATENCY().
+ *
+ * @param percentile Percentile to check (e.g. 99.9).
+ * @param ns Limit in nanoseconds (exclusive).
+ */
+#define PCUT_ASSERT_PERCENTILE_BELOW(percentile, ns) \
+	do { \
+		long long pcut_latency = pcut_get_latency_percentile(percentile); \
+		if (pcut_latency < 0) { \
+			PCUT_ASSERTION_FAILED("Latency was not measured"); \
+		} else if (pcut_latency >= (long long) (ns)) { \
+			PCUT_ASSERTION_FAILED("Expected p%g latency below %lld ns but got %lld ns", \
+				(double) (percentile), (long long) (ns), pcut_latency); \
+		} \
+	} while (0)
+
+/** Assertion for 99th percentile of latency measured by PCUT_MEASURE_LATENCY().
+ *
+ * @param ns Limit in nanoseconds (exclusive).
+ */
+#define PCUT_ASSERT_P99_BELOW(ns) \
+	PCUT_ASSERT_PERCENTILE_BELOW(99.0, ns)
+
+/** Assertion for complexity measured by PCUT_MEASURE_COMPLEXITY().
+ *
+ * @param complexity Highest allowed complexity class (PCUT_O_*).
+ */
+#define PCUT_ASSERT_COMPLEXITY_AT_MOST(complexity) \
+	do { \
+		int pcut_complexity = pcut_get_complexity(); \
+		if (pcut_complexity < 0) { \
+			PCUT_ASSERTION_FAILED("Complexity was not measured"); \
+		} else if (pcut_complexity > (complexity)) { \
+			PCUT_ASSERTION_FAILED("Expected complexity at most %s but got %s", \
+				pcut_complexity_name(complexity), \
+				pcut_complexity_name(pcut_complexity)); \
+		} \
+	} while (0)
+
 /**
  * @}
  */
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Primitives for benchmark bodies.
+ *
+ * @defgroup benchmark Benchmark primitives
+ * Keep the compiler from removing the measured code, exclude
+ * per-iteration preparation from the measurement and declare amount
+ * of processed data.
+ * @{
+ */
+#ifndef PCUT_BENCHMARK_H_GUARD
+#define PCUT_BENCHMARK_H_GUARD
+
+#include <pcut/datadef.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/** @cond devel */
+
+/** Variable the escaped pointers are stored to (when inline assembly is not available). */
+extern const void *volatile pcut_optimization_sink;
+
+void pcut_clobber_memory_impl(void);
+void pcut_benchmark_pause_timing(pcut_benchmark_t *benchmark);
+void pcut_benchmark_resume_timing(pcut_benchmark_t *benchmark);
+void pcut_benchmark_set_counter(pcut_benchmark_t *benchmark,
+	const char *name, double per_iteration);
+
+/** @endcond */
+
+#if defined(__GNUC__) || defined(__clang__)
+
+/** Make the compiler believe that the pointed memory is read.
+ *
+ * Use on results of the measured code so that it is not removed
+ * as dead code.
+ *
+ * @param ptr Pointer to the result.
+ */
+#define pcut_do_not_optimize(ptr) \
+	__asm__ __volatile__("" : : "r"(ptr) : "memory")
+
+/** Make the compiler believe that any memory could be read or written.
+ *
+ * Forces pending writes to be done (and values to be reloaded) at this
+ * point.
+ */
+#define pcut_clobber_memory() \
+	__asm__ __volatile__("" : : : "memory")
+
+#elif defined(_MSC_VER)
+
+#define pcut_do_not_optimize(ptr) \
+	do { \
+		pcut_optimization_sink = (const void *) (ptr); \
+		_ReadWriteBarrier(); \
+	} while (0)
+
+#define pcut_clobber_memory() \
+	_ReadWriteBarrier()
+
+#else
+
+#define pcut_do_not_optimize(ptr) \
+	((void) (pcut_optimization_sink = (const void *) (ptr)))
+
+#define pcut_clobber_memory() \
+	pcut_clobber_memory_impl()
+
+#endif
+
+/** Stop measuring the benchmark body.
+ *
+ * Use from within a benchmark body to exclude per-iteration
+ * preparation from the measurement.
+ * Each pause must be followed by PCUT_BENCHMARK_RESUME_TIMING().
+ * Pausing is not free: the body shall still do most of its work
+ * while the timing runs.
+ */
+#define PCUT_BENCHMARK_PAUSE_TIMING() \
+	pcut_benchmark_pause_timing(pcut_benchmark)
+
+/** Resume measuring the benchmark body after PCUT_BENCHMARK_PAUSE_TIMING(). */
+#define PCUT_BENCHMARK_RESUME_TIMING() \
+	pcut_benchmark_resume_timing(pcut_benchmark)
+
+/** Declare number of bytes processed by one iteration.
+ *
+ * Use from within a benchmark body, the throughput is reported
+ * as bytes-rate (in B/s).
+ *
+ * @param bytes Bytes processed per iteration.
+ */
+#define PCUT_BENCHMARK_SET_BYTES_PROCESSED(bytes) \
+	pcut_benchmark_set_counter(pcut_benchmark, "bytes", (double) (bytes))
+
+/** Declare number of items processed by one iteration.
+ *
+ * Use from within a benchmark body, the throughput is reported
+ * as items-rate (in items/s).
+ *
+ * @param items Items processed per iteration.
+ */
+#define PCUT_BENCHMARK_SET_ITEMS_PROCESSED(items) \
+	pcut_benchmark_set_counter(pcut_benchmark, "items", (double) (items))
+
+/** Declare custom counter of one iteration.
+ *
+ * Use from within a benchmark body, the counter is reported as
+ * NAME-rate (in NAME/s).
+ *
+ * @param name Counter name (string literal without spaces).
+ * @param per_iteration Counter value per iteration.
+ */
+#define PCUT_BENCHMARK_SET_COUNTER(name, per_iteration) \
+	pcut_benchmark_set_counter(pcut_benchmark, name, (double) (per_iteration))
+
+/**
+ * @}
+ */
+
+#endif
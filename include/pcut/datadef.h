@@ -41,9 +41,13 @@
 #if defined(__GNUC__) || defined(__clang__)
 #define PCUT_CC_UNUSED_VARIABLE(name, initializer) \
 	name __attribute__((unused)) = initializer
+#define PCUT_CC_UNUSED_PARAMETER(name) \
+	name __attribute__((unused))
 #else
 #define PCUT_CC_UNUSED_VARIABLE(name, initializer) \
 	name = initializer
+#define PCUT_CC_UNUSED_PARAMETER(name) \
+	name
 #endif
 
 
@@ -53,12 +57,17 @@ enum {
 	PCUT_KIND_SETUP,
 	PCUT_KIND_TEARDOWN,
 	PCUT_KIND_TESTSUITE,
-	PCUT_KIND_TEST
+	PCUT_KIND_TEST,
+	PCUT_KIND_BENCHMARK
 };
 
 enum {
 	PCUT_EXTRA_TIMEOUT,
 	PCUT_EXTRA_SKIP,
+	PCUT_EXTRA_MEMORY_LIMIT,
+	PCUT_EXTRA_TIME_BUDGET,
+	PCUT_EXTRA_BENCHMARK,
+	PCUT_EXTRA_SYSCALL_BUDGET,
 	PCUT_EXTRA_LAST
 };
 
@@ -84,6 +93,41 @@ typedef void (*pcut_test_func_t)(void);
 /** Set-up or tear-down method type. */
 typedef void (*pcut_setup_func_t)(void);
 
+/** State of a running benchmark. */
+typedef struct pcut_benchmark pcut_benchmark_t;
+
+/** Benchmark body type. */
+typedef void (*pcut_benchmark_func_t)(pcut_benchmark_t *);
+
+/** @copydoc pcut_benchmark_t */
+struct pcut_benchmark {
+	/** How many times the body shall execute the measured code. */
+	unsigned long iterations;
+	/** Input size when measuring complexity. */
+	unsigned long n;
+	/** Operations counted by the body (per all iterations). */
+	unsigned long long operations;
+	/** Time spent with paused timing in the current execution (ns). */
+	unsigned long long paused_time;
+	/** When the timing was paused (ns). */
+	unsigned long long pause_start;
+	/** Number of pauses in the current execution. */
+	unsigned long pauses;
+	/** Index of the thread executing the body (from zero). */
+	int thread_index;
+	/** Number of threads executing the body concurrently. */
+	int thread_count;
+};
+
+/** Complexity classes for PCUT_ASSERT_COMPLEXITY_AT_MOST(). */
+enum {
+	PCUT_O_1,
+	PCUT_O_LOG_N,
+	PCUT_O_N,
+	PCUT_O_N_LOG_N,
+	PCUT_O_N_SQUARED
+};
+
 /** @copydoc pcut_extra_t */
 struct pcut_extra {
 	/** Discriminator for the union.
@@ -93,6 +137,14 @@ struct pcut_extra {
 	int type;
 	/** Test-specific time-out in seconds. */
 	int timeout;
+	/** Test-specific memory limit in bytes. */
+	unsigned long memory_limit;
+	/** Test-specific time budget for the test body in milliseconds. */
+	int time_budget;
+	/** Name of the system call limited by a syscall budget. */
+	const char *syscall_name;
+	/** Maximum number of calls of syscall_name in the test body. */
+	int syscall_budget;
 };
 
 /** @copydoc pcut_main_extra_t */
@@ -33,7 +33,9 @@
 #define PCUT_PCUT_H_GUARD
 
 #include <pcut/asserts.h>
+#include <pcut/benchmark.h>
 #include <pcut/tests.h>
+#include <pcut/timer.h>
 
 
 /** PCUT outcome: test passed. */
@@ -48,5 +50,11 @@
 /** PCUT outcome: invalid invocation of the final program. */
 #define PCUT_OUTCOME_BAD_INVOCATION 3
 
+/** PCUT outcome: test exceeded its memory limit. */
+#define PCUT_OUTCOME_MEMORY_LIMIT 4
+
+/** PCUT outcome: test body was slower than its time budget. */
+#define PCUT_OUTCOME_TOO_SLOW 5
+
 
 #endif
@@ -153,20 +153,73 @@
  * @param time_out Time-out value in seconds.
  */
 #define PCUT_TEST_SET_TIMEOUT(time_out) \
-	{ PCUT_EXTRA_TIMEOUT, (time_out) }
+	{ PCUT_EXTRA_TIMEOUT, (time_out), 0, 0, NULL, 0 }
 
 /** Skip current test.
  *
  * Use as argument to PCUT_TEST().
  */
 #define PCUT_TEST_SKIP \
-	{ PCUT_EXTRA_SKIP, 0 }
+	{ PCUT_EXTRA_SKIP, 0, 0, 0, NULL, 0 }
+
+/** Limit memory the test may use.
+ *
+ * Use as argument to PCUT_TEST().
+ *
+ * The limit covers growth of the peak resident set size from the
+ * start of the set-up until the end of the tear-down.
+ * When the test runs in its own process, its address space is
+ * limited as well so that a runaway allocation fails early.
+ * A crash after such refused allocation counts as over the limit
+ * only when the program is linked with the pcutalloc library.
+ * Test over the limit ends with PCUT_OUTCOME_MEMORY_LIMIT.
+ *
+ * @param bytes Memory limit in bytes.
+ */
+#define PCUT_TEST_MEMORY_LIMIT(bytes) \
+	{ PCUT_EXTRA_MEMORY_LIMIT, 0, (bytes), 0, NULL, 0 }
+
+/** Limit how long the test body may run.
+ *
+ * Use as argument to PCUT_TEST().
+ *
+ * The body is repeated (with set-up and tear-down around each run
+ * but not measured) and the test ends with PCUT_OUTCOME_TOO_SLOW when
+ * the median duration of the body exceeds the budget.
+ * The number of repetitions is set by --budget-repeats=N.
+ *
+ * @param ms Time budget in milliseconds.
+ */
+#define PCUT_TEST_TIME_BUDGET(ms) \
+	{ PCUT_EXTRA_TIME_BUDGET, 0, 0, (ms), NULL, 0 }
+
+/** Limit how many times the test body may call a system call.
+ *
+ * Use as argument to PCUT_TEST(), it can be used several times
+ * (once for each system call).
+ *
+ * System calls are counted only when the test runs in its own
+ * process and the platform supports it (Linux with seccomp user
+ * notifications), otherwise the budget is not checked (a warning is
+ * printed and the budget is recorded as unmeasured).
+ * Calls made by threads and processes started by the body are
+ * counted as well.
+ *
+ * @param syscall Name of the system call (not quoted, e.g. write)
+ *	or its number for system calls that PCUT does not know by name.
+ * @param count Maximum number of calls.
+ */
+#define PCUT_TEST_SYSCALL_BUDGET(syscall, count) \
+	{ PCUT_EXTRA_SYSCALL_BUDGET, 0, 0, 0, #syscall, (count) }
 
 
 /** @cond devel */
 
 /** Terminate list of extra test options. */
-#define PCUT_TEST_EXTRA_LAST { PCUT_EXTRA_LAST, 0 }
+#define PCUT_TEST_EXTRA_LAST { PCUT_EXTRA_LAST, 0, 0, 0, NULL, 0 }
+
+/** Mark the test as a benchmark (added to all benchmarks automatically). */
+#define PCUT_BENCHMARK_EXTRA_MARK { PCUT_EXTRA_BENCHMARK, 0, 0, 0, NULL, 0 }
 
 /** Define a new test with given name and given item number.
  *
@@ -205,6 +258,335 @@
 
 
 
+/*
+ * Benchmark related macros
+ * ------------------------
+ */
+
+/** Default benchmark body function prefix. */
+#define PCUT_BENCHMARK_FUNC_PREFIX pcut_benchmark__
+
+/** Number of iterations the benchmark body shall execute.
+ *
+ * Use from within PCUT_BENCHMARK() body.
+ */
+#define PCUT_BENCHMARK_ITERATIONS (pcut_benchmark->iterations)
+
+/** Input size the benchmark body shall work with.
+ *
+ * Use from within body passed to PCUT_MEASURE_COMPLEXITY().
+ */
+#define PCUT_BENCHMARK_N (pcut_benchmark->n)
+
+/** Index of the thread executing the benchmark body.
+ *
+ * Use from within PCUT_BENCHMARK_THREADS() body.
+ */
+#define PCUT_BENCHMARK_THREAD_INDEX (pcut_benchmark->thread_index)
+
+/** Number of threads executing the benchmark body concurrently.
+ *
+ * Use from within PCUT_BENCHMARK_THREADS() body.
+ */
+#define PCUT_BENCHMARK_THREAD_COUNT (pcut_benchmark->thread_count)
+
+/** Count operations done by the benchmark body.
+ *
+ * When the body counts operations, complexity is fitted to the
+ * counts instead of the measured times.
+ *
+ * @param count Number of operations to add.
+ */
+#define PCUT_BENCHMARK_COUNT_OPERATIONS(count) \
+	((void) (pcut_benchmark->operations += (count)))
+
+/** @cond devel */
+
+void pcut_run_benchmark(pcut_benchmark_func_t func);
+
+/** Define a new benchmark with given name and given item number.
+ *
+ * The benchmark is registered as a test whose function drives
+ * the measurement of the benchmark body.
+ *
+ * @param benchmarkname A valid C identifier name (not quoted).
+ * @param number Number of the item describing this benchmark.
+ * @param ... Extra test properties.
+ */
+#define PCUT_BENCHMARK_WITH_NUMBER(number, benchmarkname, ...) \
+	PCUT_ITEM_COUNTER_INCREMENT \
+	static pcut_extra_t PCUT_ITEM_EXTRAS_NAME(number)[] = { \
+		PCUT_BENCHMARK_EXTRA_MARK, \
+		__VA_ARGS__ \
+	}; \
+	static int PCUT_CC_UNUSED_VARIABLE(PCUT_JOIN(benchmarkname, 0_test_name_missing_or_duplicated), 0); \
+	static void PCUT_JOIN(PCUT_BENCHMARK_FUNC_PREFIX, benchmarkname)(pcut_benchmark_t *); \
+	static void PCUT_JOIN(PCUT_TEST_FUNC_PREFIX, benchmarkname)(void) { \
+		pcut_run_benchmark(PCUT_JOIN(PCUT_BENCHMARK_FUNC_PREFIX, benchmarkname)); \
+	} \
+	PCUT_ADD_ITEM(number, PCUT_KIND_BENCHMARK, \
+		PCUT_QUOTE(benchmarkname), \
+		PCUT_JOIN(PCUT_TEST_FUNC_PREFIX, benchmarkname), \
+		NULL, NULL, \
+		PCUT_ITEM_EXTRAS_NAME(number), \
+		NULL, NULL \
+	); \
+	void PCUT_JOIN(PCUT_BENCHMARK_FUNC_PREFIX, benchmarkname)(pcut_benchmark_t *pcut_benchmark)
+
+/** @endcond */
+
+/** Define a new benchmark with given name.
+ *
+ * The body is executed repeatedly: the number of iterations is
+ * calibrated so that a single execution of the body takes long
+ * enough to be measured reliably.
+ * The body is expected to execute the measured code
+ * PCUT_BENCHMARK_ITERATIONS times.
+ *
+ * @code
+ * PCUT_BENCHMARK(string_length) {
+ *     unsigned long i;
+ *     for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+ *         strlen(some_string);
+ *     }
+ * }
+ * @endcode
+ *
+ * Benchmarks belong to suites as normal tests and the suite set-up
+ * and tear-down functions are executed around the whole measurement.
+ * Benchmarks are executed only when the --benchmarks option is given.
+ *
+ * @param ... Benchmark name (C identifier) followed by extra test properties.
+ */
+#define PCUT_BENCHMARK(...) \
+	PCUT_BENCHMARK_WITH_NUMBER(PCUT_ITEM_COUNTER, \
+		PCUT_VARG_GET_FIRST(__VA_ARGS__, this_arg_is_ignored), \
+		PCUT_VARG_SKIP_FIRST(__VA_ARGS__, PCUT_TEST_EXTRA_LAST) \
+	)
+
+/** @cond devel */
+
+void pcut_run_benchmark_compare(const char *name_a, pcut_benchmark_func_t func_a,
+	const char *name_b, pcut_benchmark_func_t func_b);
+
+/** Define a comparison of two benchmark variants with given item number.
+ *
+ * @param number Number of the item describing this benchmark.
+ * @param benchmarkname A valid C identifier name (not quoted).
+ * @param variant_a Name of the first variant.
+ * @param variant_b Name of the second variant.
+ * @param ... Extra test properties.
+ */
+#define PCUT_BENCHMARK_COMPARE_WITH_NUMBER(number, benchmarkname, variant_a, variant_b, ...) \
+	PCUT_ITEM_COUNTER_INCREMENT \
+	static pcut_extra_t PCUT_ITEM_EXTRAS_NAME(number)[] = { \
+		PCUT_BENCHMARK_EXTRA_MARK, \
+		__VA_ARGS__ \
+	}; \
+	static int PCUT_CC_UNUSED_VARIABLE(PCUT_JOIN(benchmarkname, 0_test_name_missing_or_duplicated), 0); \
+	static void PCUT_JOIN(PCUT_TEST_FUNC_PREFIX, benchmarkname)(void) { \
+		pcut_run_benchmark_compare( \
+			PCUT_QUOTE(variant_a), PCUT_JOIN(PCUT_BENCHMARK_FUNC_PREFIX, variant_a), \
+			PCUT_QUOTE(variant_b), PCUT_JOIN(PCUT_BENCHMARK_FUNC_PREFIX, variant_b)); \
+	} \
+	PCUT_ADD_ITEM(number, PCUT_KIND_BENCHMARK, \
+		PCUT_QUOTE(benchmarkname), \
+		PCUT_JOIN(PCUT_TEST_FUNC_PREFIX, benchmarkname), \
+		NULL, NULL, \
+		PCUT_ITEM_EXTRAS_NAME(number), \
+		NULL, NULL \
+	)
+
+/** @endcond */
+
+/** Define a benchmark variant for PCUT_BENCHMARK_COMPARE().
+ *
+ * The variant is not run on its own, its body follows the same rules
+ * as the body of PCUT_BENCHMARK().
+ * Variants for PCUT_MEASURE_LATENCY() execute a single operation and
+ * thus need not use PCUT_BENCHMARK_ITERATIONS.
+ *
+ * @param variantname Variant name (a valid C identifier).
+ */
+#define PCUT_BENCHMARK_VARIANT(variantname) \
+	static void PCUT_JOIN(PCUT_BENCHMARK_FUNC_PREFIX, variantname)( \
+		pcut_benchmark_t *PCUT_CC_UNUSED_PARAMETER(pcut_benchmark))
+
+/** Compare two benchmark variants.
+ *
+ * The variants are executed alternately (in random order within each
+ * pair) in the same process and the ratio of their times (second to
+ * first) is reported together with its confidence interval.
+ * The verdict is recorded as the relative change of the second variant
+ * (measurement named second-vs-first, in %) and as a verdict measurement
+ * that is -1 (faster), 1 (slower) or 0 (no significant difference).
+ *
+ * @code
+ * PCUT_BENCHMARK_VARIANT(old_sort) {
+ *     ...
+ * }
+ *
+ * PCUT_BENCHMARK_VARIANT(new_sort) {
+ *     ...
+ * }
+ *
+ * PCUT_BENCHMARK_COMPARE(sorting, old_sort, new_sort);
+ * @endcode
+ *
+ * @param benchmarkname Benchmark name (C identifier).
+ * @param variant_a Name of the first (reference) variant.
+ * @param ... Name of the second variant followed by extra test properties.
+ */
+#define PCUT_BENCHMARK_COMPARE(benchmarkname, variant_a, ...) \
+	PCUT_BENCHMARK_COMPARE_WITH_NUMBER(PCUT_ITEM_COUNTER, benchmarkname, variant_a, \
+		PCUT_VARG_GET_FIRST(__VA_ARGS__, this_arg_is_ignored), \
+		PCUT_VARG_SKIP_FIRST(__VA_ARGS__, PCUT_TEST_EXTRA_LAST) \
+	)
+
+/** @cond devel */
+
+void pcut_run_benchmark_threads(pcut_benchmark_func_t func, int max_threads);
+
+/** Define a new multi-threaded benchmark with given item number.
+ *
+ * @param number Number of the item describing this benchmark.
+ * @param benchmarkname A valid C identifier name (not quoted).
+ * @param max_threads Maximum number of threads.
+ * @param ... Extra test properties.
+ */
+#define PCUT_BENCHMARK_THREADS_WITH_NUMBER(number, benchmarkname, max_threads, ...) \
+	PCUT_ITEM_COUNTER_INCREMENT \
+	static pcut_extra_t PCUT_ITEM_EXTRAS_NAME(number)[] = { \
+		PCUT_BENCHMARK_EXTRA_MARK, \
+		__VA_ARGS__ \
+	}; \
+	static int PCUT_CC_UNUSED_VARIABLE(PCUT_JOIN(benchmarkname, 0_test_name_missing_or_duplicated), 0); \
+	static void PCUT_JOIN(PCUT_BENCHMARK_FUNC_PREFIX, benchmarkname)(pcut_benchmark_t *); \
+	static void PCUT_JOIN(PCUT_TEST_FUNC_PREFIX, benchmarkname)(void) { \
+		pcut_run_benchmark_threads(PCUT_JOIN(PCUT_BENCHMARK_FUNC_PREFIX, benchmarkname), \
+			(max_threads)); \
+	} \
+	PCUT_ADD_ITEM(number, PCUT_KIND_BENCHMARK, \
+		PCUT_QUOTE(benchmarkname), \
+		PCUT_JOIN(PCUT_TEST_FUNC_PREFIX, benchmarkname), \
+		NULL, NULL, \
+		PCUT_ITEM_EXTRAS_NAME(number), \
+		NULL, NULL \
+	); \
+	void PCUT_JOIN(PCUT_BENCHMARK_FUNC_PREFIX, benchmarkname)(pcut_benchmark_t *pcut_benchmark)
+
+/** @endcond */
+
+/** Define a new benchmark measuring scalability over threads.
+ *
+ * The body is executed concurrently by 1, 2, 4, ... up to
+ * @p max_threads threads that are released together from a barrier.
+ * Each thread executes PCUT_BENCHMARK_ITERATIONS iterations (calibrated
+ * with a single thread) and can use PCUT_BENCHMARK_THREAD_INDEX
+ * to select its part of the work.
+ *
+ * For each thread count, the aggregate throughput, the mean latency of
+ * one iteration in a thread and the scaling efficiency (throughput
+ * relative to a perfect scaling of the single-threaded one) are
+ * recorded.
+ *
+ * The body must not use assertions as they cannot abort other threads.
+ *
+ * @code
+ * PCUT_BENCHMARK_THREADS(queue_push_pop, 8) {
+ *     unsigned long i;
+ *     for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+ *         queue_push(queue, i);
+ *         queue_pop(queue);
+ *     }
+ * }
+ * @endcode
+ *
+ * @param benchmarkname Benchmark name (C identifier).
+ * @param ... Maximum number of threads followed by extra test properties.
+ */
+#define PCUT_BENCHMARK_THREADS(benchmarkname, ...) \
+	PCUT_BENCHMARK_THREADS_WITH_NUMBER(PCUT_ITEM_COUNTER, benchmarkname, \
+		PCUT_VARG_GET_FIRST(__VA_ARGS__, this_arg_is_ignored), \
+		PCUT_VARG_SKIP_FIRST(__VA_ARGS__, PCUT_TEST_EXTRA_LAST) \
+	)
+
+/** @cond devel */
+
+void pcut_measure_complexity(pcut_benchmark_func_t func,
+	unsigned long n_min, unsigned long n_max);
+
+/** @endcond */
+
+/** Measure how a benchmark variant scales with input size.
+ *
+ * The variant body is run for input sizes from @p n_min to @p n_max
+ * (doubling the size each time) and the costs are fitted to
+ * O(1), O(log n), O(n), O(n log n) and O(n^2).
+ * The best fit is recorded as measurements (its class, e.g. O(n), is
+ * the unit of the complexity measurement, together with its coefficient
+ * and error) and can be checked with PCUT_ASSERT_COMPLEXITY_AT_MOST().
+ *
+ * @code
+ * PCUT_BENCHMARK_VARIANT(sort_n) {
+ *     unsigned long i;
+ *     for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+ *         sort(data, PCUT_BENCHMARK_N);
+ *     }
+ * }
+ *
+ * PCUT_TEST(sort_scales) {
+ *     PCUT_MEASURE_COMPLEXITY(sort_n, 64, 65536);
+ *     PCUT_ASSERT_COMPLEXITY_AT_MOST(PCUT_O_N_LOG_N);
+ * }
+ * @endcode
+ *
+ * @param variantname Variant defined by PCUT_BENCHMARK_VARIANT().
+ * @param n_min Smallest input size.
+ * @param n_max Largest input size.
+ */
+#define PCUT_MEASURE_COMPLEXITY(variantname, n_min, n_max) \
+	pcut_measure_complexity(PCUT_JOIN(PCUT_BENCHMARK_FUNC_PREFIX, variantname), \
+		(n_min), (n_max))
+
+/** @cond devel */
+
+void pcut_measure_latency(pcut_benchmark_func_t func);
+
+/** @endcond */
+
+/** Measure distribution of per-operation latency of a benchmark variant.
+ *
+ * Each execution of the variant body is one operation
+ * (PCUT_BENCHMARK_ITERATIONS is always one) and is timed separately.
+ * The durations are collected in a log-linear histogram and
+ * the 50th, 90th, 99th and 99.9th percentiles and the maximum
+ * are recorded.
+ * The percentiles can be checked with PCUT_ASSERT_P99_BELOW()
+ * or PCUT_ASSERT_PERCENTILE_BELOW().
+ *
+ * Run the tests with --latency-json=FILE to export the histograms
+ * (one JSON object per line).
+ *
+ * @code
+ * PCUT_BENCHMARK_VARIANT(handle_request) {
+ *     handle(&request);
+ * }
+ *
+ * PCUT_TEST(request_slo) {
+ *     PCUT_MEASURE_LATENCY(handle_request);
+ *     PCUT_ASSERT_P99_BELOW(50000);
+ * }
+ * @endcode
+ *
+ * @param variantname Variant defined by PCUT_BENCHMARK_VARIANT().
+ */
+#define PCUT_MEASURE_LATENCY(variantname) \
+	pcut_measure_latency(PCUT_JOIN(PCUT_BENCHMARK_FUNC_PREFIX, variantname))
+
+
+
+
 
 /*
  * Test suite related macros
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * High-resolution timer.
+ *
+ * @defgroup timer Timer
+ * Monotonic clock with nanosecond units usable from tests and
+ * benchmarks.
+ *
+ * The clock uses the processor time-stamp counter (calibrated on
+ * first use) when it is invariant and the best monotonic clock of
+ * the operating system otherwise.
+ * @{
+ */
+#ifndef PCUT_TIMER_H_GUARD
+#define PCUT_TIMER_H_GUARD
+
+/** Timer measuring elapsed time. */
+typedef struct {
+	/** Time when the timer was started (in nanoseconds). */
+	unsigned long long start;
+} pcut_timer_t;
+
+/** Read current time.
+ *
+ * @return Time in nanoseconds since an unspecified point in the past.
+ */
+unsigned long long pcut_timer_now(void);
+
+/** Get name of the clock used by the timer.
+ *
+ * @return Clock name such as "tsc" or "CLOCK_MONOTONIC_RAW".
+ */
+const char *pcut_timer_source(void);
+
+/** Get resolution of the timer.
+ *
+ * Measured on first use as the smallest observed difference between
+ * two different readings.
+ *
+ * @return Resolution in nanoseconds.
+ */
+double pcut_timer_resolution(void);
+
+/** Get overhead of reading the timer.
+ *
+ * Measured on first use as the mean duration of a reading.
+ *
+ * @return Overhead in nanoseconds.
+ */
+double pcut_timer_overhead(void);
+
+/** Start a timer.
+ *
+ * @param timer Timer to start.
+ */
+void pcut_timer_start(pcut_timer_t *timer);
+
+/** Get time elapsed since the timer was started.
+ *
+ * @param timer Started timer.
+ * @return Elapsed time in nanoseconds.
+ */
+unsigned long long pcut_timer_elapsed(const pcut_timer_t *timer);
+
+/**
+ * @}
+ */
+
+#endif
@@ -30,11 +30,21 @@
 # We expect following variables would be set:
 # TEST_EXECUTABLE - PCUT executable with the tests to perform
 # EXPECTED_OUTPUT - file with expected stdout from ${TEST_EXECUTABLE}
+# TEST_ARGUMENTS - optional space-separated arguments for ${TEST_EXECUTABLE}
+# TEST_INPUT - optional file given to ${TEST_EXECUTABLE} as stdin
 #
 
+separate_arguments(TEST_ARGUMENTS)
+
+set(test_input_arguments)
+if(DEFINED TEST_INPUT)
+	set(test_input_arguments INPUT_FILE ${TEST_INPUT})
+endif()
+
 # Run the tests
 execute_process(
-	COMMAND ${TEST_EXECUTABLE}
+	COMMAND ${TEST_EXECUTABLE} ${TEST_ARGUMENTS}
+	${test_input_arguments}
 	OUTPUT_FILE ${TEST_EXECUTABLE}.output
 	RESULT_VARIABLE test_result
 )
@@ -56,6 +66,8 @@ string(REPLACE "[" "\\[" expected "${expected}")
 string(REPLACE "]" "\\]" expected "${expected}")
 string(REPLACE "+" "\\+" expected "${expected}")
 string(REPLACE "?" "\\?" expected "${expected}")
+string(REPLACE "^" "\\^" expected "${expected}")
+string(REPLACE "$" "\\$" expected "${expected}")
 string(REGEX REPLACE "\r?\n" "\\n" expected "${expected}")
 string(REPLACE "." "\\." expected "${expected}")
 string(REPLACE "*****" ".*" expected "${expected}")
@@ -0,0 +1,647 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Per-test statistics of heap allocations.
+ *
+ * The allocator itself is interposed by a separate library (pcutalloc)
+ * that the test program has to be linked with.
+ * The interposed functions call the hooks below and these update the
+ * statistics while the test body is running.
+ *
+ * Call sites are identified by a short backtrace (taken by following
+ * frame pointers) of the allocation function and aggregated in a small
+ * fixed-size hash table.
+ * The hooks can be called from several threads at once, the counters
+ * are updated atomically and the table of live blocks is guarded by
+ * a spin lock.
+ *
+ * Leak detection keeps the set of live blocks in another hash table
+ * (open addressing with tombstones).
+ * The set is emptied after the suite set-up and whatever remains in it
+ * after the tear-down was leaked by the test.
+ * The table is rehashed when too many tombstones accumulate so that
+ * long tests do not end up probing the whole table.
+ */
+
+#include "internal.h"
+
+#ifdef __helenos__
+#include <mem.h>
+#else
+#pragma warning(push, 0)
+#include <string.h>
+#pragma warning(pop)
+#endif
+
+
+/** Number of slots in the table of allocation sites. */
+#define SITE_TABLE_SIZE 256
+
+/** How many most frequent allocation sites to report. */
+#define SITE_REPORT_COUNT 5
+
+/** Number of return addresses identifying an allocation site. */
+#define SITE_DEPTH 4
+
+/** Number of innermost frames that may precede the allocation function. */
+#define SITE_SKIPPED_FRAMES 4
+
+#ifdef __GNUC__
+/** Atomically add @p value to @p var. */
+#define ATOMIC_ADD(var, value) ((void) __sync_fetch_and_add(&(var), (value)))
+/** Atomically add @p value to @p var, evaluate to the new value. */
+#define ATOMIC_ADD_FETCH(var, value) __sync_add_and_fetch(&(var), (value))
+/** Atomically replace @p expected in @p var with @p value, evaluate to the previous content. */
+#define ATOMIC_CAS(var, expected, value) __sync_val_compare_and_swap(&(var), (expected), (value))
+/** Take a spin lock. */
+#define SPIN_LOCK(lock) while (__sync_lock_test_and_set(&(lock), 1)) { }
+/** Release a spin lock. */
+#define SPIN_UNLOCK(lock) __sync_lock_release(&(lock))
+#else
+/* The interposer needs GCC anyway. */
+#define ATOMIC_ADD(var, value) ((void) ((var) += (value)))
+#define ATOMIC_ADD_FETCH(var, value) ((var) += (value))
+#define ATOMIC_CAS(var, expected, value) ((var) == (expected) ? ((var) = (value), (expected)) : (var))
+#define SPIN_LOCK(lock) ((void) 0)
+#define SPIN_UNLOCK(lock) ((void) 0)
+#endif
+
+/** Aggregated allocations from a single call site. */
+typedef struct {
+	/** Hash of the backtrace (zero for empty slot). */
+	size_t key;
+	/** Return addresses, the innermost is the caller of the allocation function. */
+	void *frames[SITE_DEPTH];
+	/** Number of valid items in frames. */
+	int depth;
+	/** Number of allocations. */
+	unsigned long count;
+	/** Requested bytes. */
+	unsigned long long bytes;
+} alloc_site_t;
+
+/** Number of slots in the table of live blocks. */
+#define LIVE_TABLE_SIZE 8192
+
+/** Marker of a removed entry in the table of live blocks. */
+#define LIVE_TOMBSTONE ((void *) 1)
+
+/** Number of tombstones that triggers rehashing of the table of live blocks. */
+#define LIVE_TOMBSTONE_LIMIT (LIVE_TABLE_SIZE / 4)
+
+/** Live heap block. */
+typedef struct {
+	/** Address of the block (NULL for empty slot). */
+	void *block;
+	/** Requested size in bytes. */
+	size_t size;
+	/** Return address of the allocation function. */
+	void *caller;
+} live_block_t;
+
+/** Whether to report allocation statistics of each test. */
+int pcut_alloc_report = 0;
+
+/** How to check for leaks (PCUT_LEAK_CHECK_*). */
+int pcut_leak_check = PCUT_LEAK_CHECK_NONE;
+
+/** Whether to aggregate allocations by their call sites. */
+int pcut_alloc_sites = 0;
+
+/** Describes call sites (NULL when the interposer is not linked in). */
+static pcut_alloc_site_describer_t site_describer = NULL;
+
+/** Whether the statistics are being collected. */
+static volatile int tracking_active = 0;
+
+/** Number of allocations in the current test. */
+static unsigned long allocation_count;
+
+/** Number of requested bytes in the current test. */
+static unsigned long long allocated_bytes;
+
+/** Currently live bytes (usable sizes) allocated in the current test. */
+static long long live_bytes;
+
+/** Maximum of live_bytes. */
+static long long peak_live_bytes;
+
+/** Allocation sites. */
+static alloc_site_t sites[SITE_TABLE_SIZE];
+
+/** Whether the live blocks are being tracked. */
+static volatile int leak_tracking_active = 0;
+
+/** Spin lock guarding the table of live blocks and its counters. */
+static volatile int live_blocks_lock = 0;
+
+/** Whether an allocation was refused in this process. */
+static volatile int allocation_refused = 0;
+
+/** Number of blocks that did not fit into the table. */
+static unsigned long untracked_blocks;
+
+/** Number of tombstones in the table of live blocks. */
+static int live_tombstones;
+
+/** Live blocks allocated since the start of leak tracking. */
+static live_block_t live_blocks[LIVE_TABLE_SIZE];
+
+/** Copy of live_blocks used when rehashing. */
+static live_block_t live_blocks_rehashed[LIVE_TABLE_SIZE];
+
+/** Compute starting slot in the table of live blocks.
+ *
+ * @param block Address of the block.
+ * @return Slot index.
+ */
+static size_t live_block_hash(void *block) {
+	return (size_t) (((size_t) block >> 4) * 2654435761UL % LIVE_TABLE_SIZE);
+}
+
+/** Remember new live block.
+ *
+ * @param block Address of the block.
+ * @param size Requested size in bytes.
+ * @param caller Return address of the allocation function.
+ */
+static void live_block_add(void *block, size_t size, void *caller) {
+	size_t index = live_block_hash(block);
+	int probes;
+
+	for (probes = 0; probes < LIVE_TABLE_SIZE; probes++) {
+		live_block_t *it = &live_blocks[index];
+		if ((it->block == NULL) || (it->block == LIVE_TOMBSTONE)) {
+			if (it->block == LIVE_TOMBSTONE) {
+				live_tombstones--;
+			}
+			it->block = block;
+			it->size = size;
+			it->caller = caller;
+			return;
+		}
+		index = (index + 1) % LIVE_TABLE_SIZE;
+	}
+
+	untracked_blocks++;
+}
+
+/** Forget released block.
+ *
+ * Blocks allocated before leak tracking started are not in the table.
+ *
+ * @param block Address of the block.
+ */
+static void live_block_remove(void *block) {
+	size_t index = live_block_hash(block);
+	int probes;
+
+	for (probes = 0; probes < LIVE_TABLE_SIZE; probes++) {
+		live_block_t *it = &live_blocks[index];
+		if (it->block == NULL) {
+			return;
+		}
+		if (it->block == block) {
+			it->block = LIVE_TOMBSTONE;
+			live_tombstones++;
+			return;
+		}
+		index = (index + 1) % LIVE_TABLE_SIZE;
+	}
+}
+
+/** Rebuild the table of live blocks without tombstones. */
+static void live_blocks_rehash(void) {
+	int i;
+
+	memcpy(live_blocks_rehashed, live_blocks, sizeof(live_blocks));
+	memset(live_blocks, 0, sizeof(live_blocks));
+	live_tombstones = 0;
+
+	for (i = 0; i < LIVE_TABLE_SIZE; i++) {
+		live_block_t *it = &live_blocks_rehashed[i];
+		if ((it->block != NULL) && (it->block != LIVE_TOMBSTONE)) {
+			live_block_add(it->block, it->size, it->caller);
+		}
+	}
+}
+
+/** Get backtrace identifying an allocation site.
+ *
+ * Frames of the interposer and of the hooks are skipped, the backtrace
+ * starts at @p caller.
+ * Only @p caller is used when frame pointers cannot be followed.
+ *
+ * @param caller Return address of the allocation function.
+ * @param frames Where to store SITE_DEPTH return addresses.
+ * @return Number of stored return addresses.
+ */
+static int site_backtrace(void *caller, void **frames) {
+	void *stack[SITE_SKIPPED_FRAMES + SITE_DEPTH];
+	int depth = pcut_backtrace(stack, SITE_SKIPPED_FRAMES + SITE_DEPTH);
+	int start, i;
+
+	for (start = 0; start < depth; start++) {
+		if (stack[start] != caller) {
+			continue;
+		}
+		for (i = 0; (i < SITE_DEPTH) && (start + i < depth); i++) {
+			frames[i] = stack[start + i];
+		}
+		return i;
+	}
+
+	frames[0] = caller;
+	return 1;
+}
+
+/** Compute hash of a backtrace (FNV-1a).
+ *
+ * @param frames Return addresses.
+ * @param depth Number of items in @p frames.
+ * @return Non-zero hash.
+ */
+static size_t site_hash(void **frames, int depth) {
+	size_t hash = (size_t) 2166136261UL;
+	int i;
+
+	for (i = 0; i < depth; i++) {
+		hash = (hash ^ (size_t) frames[i]) * 16777619UL;
+	}
+
+	return hash == 0 ? 1 : hash;
+}
+
+/** Add allocation to a table of sites.
+ *
+ * Allocations from new sites are dropped when the table is full.
+ * Safe to call from several threads at once.
+ *
+ * @param table Table of SITE_TABLE_SIZE sites.
+ * @param frames Backtrace of the allocation.
+ * @param depth Number of items in @p frames.
+ * @param size Requested size in bytes.
+ */
+static void site_add(alloc_site_t *table, void **frames, int depth, size_t size) {
+	size_t key = site_hash(frames, depth);
+	size_t index = (key >> 4) % SITE_TABLE_SIZE;
+	int probes;
+
+	for (probes = 0; probes < SITE_TABLE_SIZE; probes++) {
+		alloc_site_t *site = &table[index];
+		size_t owner = ATOMIC_CAS(site->key, (size_t) 0, key);
+		if ((owner == 0) || (owner == key)) {
+			if (owner == 0) {
+				int i;
+				for (i = 0; i < depth; i++) {
+					site->frames[i] = frames[i];
+				}
+				site->depth = depth;
+			}
+			ATOMIC_ADD(site->count, 1);
+			ATOMIC_ADD(site->bytes, size);
+			return;
+		}
+		index = (index + 1) % SITE_TABLE_SIZE;
+	}
+}
+
+/** Describe allocation site by its two innermost frames.
+ *
+ * @param site The allocation site.
+ * @param buffer Where to store the description.
+ * @param size Size of @p buffer in bytes.
+ */
+static void site_describe(const alloc_site_t *site, char *buffer, size_t size) {
+	char outer[PCUT_MEASUREMENT_NAME_SIZE];
+	size_t used;
+
+	site_describer(site->frames[0], buffer, size);
+	if (site->depth < 2) {
+		return;
+	}
+
+	site_describer(site->frames[1], outer, PCUT_MEASUREMENT_NAME_SIZE);
+	used = (size_t) pcut_str_size(buffer);
+	pcut_snprintf(buffer + used, size - used, "<%s", outer);
+}
+
+/** Remove the most significant site from a table of sites.
+ *
+ * @param table Table of SITE_TABLE_SIZE sites.
+ * @param by_bytes Whether to compare by bytes (or by counts).
+ * @param site Where to store the removed site.
+ * @return Whether there was any site left.
+ */
+static int site_take_top(alloc_site_t *table, int by_bytes, alloc_site_t *site) {
+	alloc_site_t *best = NULL;
+	int i;
+
+	for (i = 0; i < SITE_TABLE_SIZE; i++) {
+		if ((table[i].key == 0) || (table[i].count == 0)) {
+			continue;
+		}
+		if ((best == NULL)
+				|| (by_bytes && (table[i].bytes > best->bytes))
+				|| (!by_bytes && (table[i].count > best->count))) {
+			best = &table[i];
+		}
+	}
+	if (best == NULL) {
+		return 0;
+	}
+
+	*site = *best;
+	best->count = 0;
+	return 1;
+}
+
+/** Register the allocator interposer.
+ *
+ * @param describer Function that describes allocation call sites.
+ */
+void pcut_alloc_register(pcut_alloc_site_describer_t describer) {
+	site_describer = describer;
+}
+
+/** Record a new allocation (hook for the interposer).
+ *
+ * @param block The allocated block.
+ * @param size Requested size in bytes.
+ * @param usable Size of the allocated block in bytes.
+ * @param caller Return address of the allocation function.
+ */
+void pcut_alloc_hook_allocate(void *block, size_t size, size_t usable, void *caller) {
+	long long live, peak;
+
+	if (leak_tracking_active) {
+		SPIN_LOCK(live_blocks_lock);
+		if (leak_tracking_active) {
+			if (live_tombstones > LIVE_TOMBSTONE_LIMIT) {
+				live_blocks_rehash();
+			}
+			live_block_add(block, size, caller);
+		}
+		SPIN_UNLOCK(live_blocks_lock);
+	}
+
+	if (!tracking_active) {
+		return;
+	}
+
+	ATOMIC_ADD(allocation_count, 1);
+	ATOMIC_ADD(allocated_bytes, size);
+	live = ATOMIC_ADD_FETCH(live_bytes, (long long) usable);
+	peak = peak_live_bytes;
+	while (live > peak) {
+		long long seen = ATOMIC_CAS(peak_live_bytes, peak, live);
+		if (seen == peak) {
+			break;
+		}
+		peak = seen;
+	}
+
+	if (pcut_alloc_sites) {
+		void *frames[SITE_DEPTH];
+		int depth = site_backtrace(caller, frames);
+		site_add(sites, frames, depth, size);
+	}
+}
+
+/** Record release of a block (hook for the interposer).
+ *
+ * @param block The released block.
+ * @param usable Size of the released block in bytes.
+ */
+void pcut_alloc_hook_release(void *block, size_t usable) {
+	if (leak_tracking_active) {
+		SPIN_LOCK(live_blocks_lock);
+		if (leak_tracking_active) {
+			live_block_remove(block);
+		}
+		SPIN_UNLOCK(live_blocks_lock);
+	}
+
+	if (!tracking_active) {
+		return;
+	}
+
+	ATOMIC_ADD(live_bytes, -(long long) usable);
+}
+
+/** Record an allocation that failed (hook for the interposer).
+ *
+ * @param size Requested size in bytes.
+ */
+void pcut_alloc_hook_refused(size_t size) {
+	if (size > 0) {
+		allocation_refused = 1;
+	}
+}
+
+/** Tell whether the interposer saw a refused allocation.
+ *
+ * Safe to call from a signal handler.
+ *
+ * @return Whether any allocation of this process failed.
+ */
+int pcut_alloc_refused(void) {
+	return allocation_refused;
+}
+
+/** Get number of allocations made so far by the current test.
+ *
+ * @return Number of allocations.
+ * @retval -1 Allocations are not tracked (the interposer is not linked).
+ */
+long pcut_get_allocation_count(void) {
+	if (site_describer == NULL) {
+		return -1;
+	}
+	return (long) allocation_count;
+}
+
+/** Start collecting statistics for the current test body. */
+void pcut_alloc_begin(void) {
+	allocation_count = 0;
+	allocated_bytes = 0;
+	live_bytes = 0;
+	peak_live_bytes = 0;
+	if (pcut_alloc_sites) {
+		void *frames[1];
+		int i;
+		for (i = 0; i < SITE_TABLE_SIZE; i++) {
+			sites[i].key = 0;
+			sites[i].count = 0;
+			sites[i].bytes = 0;
+		}
+		/*
+		 * The first backtrace in the main thread looks up the stack
+		 * bounds which allocates: do not count that into the test.
+		 */
+		(void) pcut_backtrace(frames, 1);
+	}
+
+	tracking_active = (site_describer != NULL);
+}
+
+/** Record the most frequent allocation sites as measurements. */
+static void record_sites(void) {
+	alloc_site_t site;
+	int reported;
+
+	for (reported = 0; reported < SITE_REPORT_COUNT; reported++) {
+		char name[PCUT_MEASUREMENT_NAME_SIZE];
+		char where[PCUT_MEASUREMENT_NAME_SIZE];
+
+		if (!site_take_top(sites, 0, &site)) {
+			break;
+		}
+
+		site_describe(&site, where, PCUT_MEASUREMENT_NAME_SIZE);
+		pcut_snprintf(name, PCUT_MEASUREMENT_NAME_SIZE, "alloc-site:%s", where);
+		pcut_record_measurement(name, (double) site.count, "x");
+	}
+}
+
+/** Stop collecting statistics and record them as measurements.
+ *
+ * Does nothing when the statistics are not being collected.
+ */
+void pcut_alloc_end(void) {
+	if (!tracking_active) {
+		return;
+	}
+	tracking_active = 0;
+
+	if (!pcut_alloc_report) {
+		return;
+	}
+
+	pcut_record_measurement("allocations", (double) allocation_count, "x");
+	pcut_record_measurement("allocated-bytes", (double) allocated_bytes, "B");
+	pcut_record_measurement("peak-heap", (double) peak_live_bytes, "B");
+	if (pcut_alloc_sites) {
+		record_sites();
+	}
+}
+
+/** Start tracking live blocks of the current test.
+ *
+ * Expected to be called after the suite set-up.
+ */
+void pcut_leaks_begin(void) {
+	if ((pcut_leak_check == PCUT_LEAK_CHECK_NONE) || (site_describer == NULL)) {
+		return;
+	}
+
+	SPIN_LOCK(live_blocks_lock);
+	memset(live_blocks, 0, sizeof(live_blocks));
+	untracked_blocks = 0;
+	live_tombstones = 0;
+	leak_tracking_active = 1;
+	SPIN_UNLOCK(live_blocks_lock);
+}
+
+/** Stop tracking live blocks and report the leaked ones.
+ *
+ * Expected to be called after the suite tear-down.
+ * Leaked bytes and blocks are recorded as measurements together
+ * with the sites that allocated them.
+ * Blocks that did not fit into the table might have leaked as well,
+ * a full table is thus reported instead of passing silently.
+ *
+ * @param message Where to store description of the leaks.
+ * @param size Size of @p message in bytes.
+ * @return Number of leaked and untracked blocks.
+ */
+int pcut_leaks_end(char *message, size_t size) {
+	alloc_site_t site;
+	unsigned long long leaked_bytes = 0;
+	int leaked_blocks = 0;
+	int reported;
+	int i;
+
+	if (!leak_tracking_active) {
+		return 0;
+	}
+
+	/* Wait for hooks running in other threads. */
+	SPIN_LOCK(live_blocks_lock);
+	leak_tracking_active = 0;
+	SPIN_UNLOCK(live_blocks_lock);
+
+	for (i = 0; i < LIVE_TABLE_SIZE; i++) {
+		if ((live_blocks[i].block != NULL) && (live_blocks[i].block != LIVE_TOMBSTONE)) {
+			leaked_bytes += live_blocks[i].size;
+			leaked_blocks++;
+		}
+	}
+
+	pcut_record_measurement("leaked-blocks", (double) leaked_blocks, "x");
+	pcut_record_measurement("leaked-bytes", (double) leaked_bytes, "B");
+	if (untracked_blocks > 0) {
+		pcut_record_measurement("leak-untracked-blocks", (double) untracked_blocks, "x");
+		pcut_snprintf(message, size,
+			"Table of live blocks is full, %lu blocks not checked for leaks",
+			untracked_blocks);
+	}
+	if (leaked_blocks == 0) {
+		return (int) untracked_blocks;
+	}
+
+	/* Group leaked blocks by their sites, biggest first. */
+	memset(sites, 0, sizeof(sites));
+	for (i = 0; i < LIVE_TABLE_SIZE; i++) {
+		if ((live_blocks[i].block != NULL) && (live_blocks[i].block != LIVE_TOMBSTONE)) {
+			site_add(sites, &live_blocks[i].caller, 1, live_blocks[i].size);
+		}
+	}
+
+	for (reported = 0; reported < SITE_REPORT_COUNT; reported++) {
+		char name[PCUT_MEASUREMENT_NAME_SIZE];
+		char where[PCUT_MEASUREMENT_NAME_SIZE];
+
+		if (!site_take_top(sites, 1, &site)) {
+			break;
+		}
+
+		site_describe(&site, where, PCUT_MEASUREMENT_NAME_SIZE);
+		pcut_snprintf(name, PCUT_MEASUREMENT_NAME_SIZE, "leak-site:%s", where);
+		pcut_record_measurement(name, (double) site.bytes, "B");
+		if ((reported == 0) && (untracked_blocks == 0)) {
+			pcut_snprintf(message, size,
+				"Leaked %llu bytes in %d blocks (most at %s)",
+				leaked_bytes, leaked_blocks, where);
+		}
+	}
+
+	return leaked_blocks + (int) untracked_blocks;
+}
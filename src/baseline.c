@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Saving benchmark results as a baseline and comparing against it.
+ *
+ * The baseline file has one line per benchmark:
+ * @code
+ * suite.benchmark metric count sample1 sample2 ...
+ * @endcode
+ * where metric names what the samples measure (e.g. ns per iteration).
+ *
+ * Benchmarks are executed in spawned processes, possibly concurrently.
+ * Thus each benchmark appends its line on its own with a single write.
+ *
+ * Comparison uses Mann-Whitney U test (normal approximation with tie
+ * correction) on the samples.
+ * A benchmark is a regression when the difference is significant and
+ * its median is slower by more than the minimum effect size.
+ */
+
+#include "internal.h"
+
+#ifdef __helenos__
+#include <mem.h>
+#else
+#pragma warning(push, 0)
+#include <string.h>
+#pragma warning(pop)
+#endif
+
+#pragma warning(push, 0)
+#include <stdio.h>
+#pragma warning(pop)
+
+
+/** Maximum length of a line in the baseline file. */
+#define BASELINE_LINE_SIZE 4096
+
+/** Size of the buffer for full benchmark name (suite.benchmark). */
+#define BASELINE_NAME_SIZE 256
+
+/** Critical value of the standard normal distribution (two-sided, 5%). */
+#define BASELINE_CRITICAL_Z 1.96
+
+/** Minimum relative slowdown (in %) that is considered a regression. */
+int pcut_baseline_min_effect = 5;
+
+/** File where to save the baseline (NULL when not saving). */
+static const char *save_filename = NULL;
+
+/** File with the baseline to compare with (NULL when not comparing). */
+static const char *compare_filename = NULL;
+
+/** Samples loaded from the baseline. */
+static double baseline_samples[PCUT_BENCHMARK_MAX_SAMPLES];
+
+/** Set where the baseline is saved and where it is loaded from.
+ *
+ * @param save File where to save results of this run (can be NULL).
+ * @param compare File with results to compare with (can be NULL).
+ */
+void pcut_baseline_set_files(const char *save, const char *compare) {
+	save_filename = save;
+	compare_filename = compare;
+}
+
+/** Prepare the baseline file before the whole run.
+ *
+ * @return Whether the file could be created.
+ */
+int pcut_baseline_start(void) {
+	FILE *output;
+
+	if (save_filename == NULL) {
+		return 1;
+	}
+
+	output = fopen(save_filename, "w");
+	if (output == NULL) {
+		return 0;
+	}
+	fclose(output);
+
+	return 1;
+}
+
+/** Compose full name of the current benchmark.
+ *
+ * @param buffer Where to store the name.
+ */
+static void get_current_name(char *buffer) {
+	pcut_snprintf(buffer, BASELINE_NAME_SIZE, "%s.%s",
+		pcut_get_current_suite()->name, pcut_get_current_test()->name);
+}
+
+/** Append samples of the current benchmark to the baseline file.
+ *
+ * @param metric What the samples measure.
+ * @param samples The samples.
+ * @param count Number of samples.
+ */
+static void save_samples(const char *metric, const double *samples, int count) {
+	char line[BASELINE_LINE_SIZE];
+	char name[BASELINE_NAME_SIZE];
+	FILE *output;
+	int used;
+	int i;
+
+	get_current_name(name);
+	used = pcut_snprintf(line, BASELINE_LINE_SIZE, "%s %s %d", name, metric, count);
+	for (i = 0; i < count; i++) {
+		if ((used < 0) || (used >= BASELINE_LINE_SIZE)) {
+			return;
+		}
+		used += pcut_snprintf(line + used, BASELINE_LINE_SIZE - used,
+			" %.9g", samples[i]);
+	}
+	if ((used < 0) || (used >= BASELINE_LINE_SIZE - 1)) {
+		return;
+	}
+	line[used] = '\n';
+	line[used + 1] = 0;
+
+	output = fopen(save_filename, "a");
+	if (output == NULL) {
+		return;
+	}
+	fputs(line, output);
+	fclose(output);
+}
+
+/** Load samples of the current benchmark from the baseline file.
+ *
+ * @param metric What the samples shall measure.
+ * @return Number of samples loaded into baseline_samples.
+ * @retval 0 The benchmark is not in the baseline.
+ */
+static int load_samples(const char *metric) {
+	char line[BASELINE_LINE_SIZE];
+	char name[BASELINE_NAME_SIZE];
+	size_t name_len;
+	size_t metric_len = pcut_str_size(metric);
+	int count = 0;
+	FILE *input;
+
+	input = fopen(compare_filename, "r");
+	if (input == NULL) {
+		return 0;
+	}
+
+	get_current_name(name);
+	name_len = pcut_str_size(name);
+
+	while (fgets(line, BASELINE_LINE_SIZE, input) != NULL) {
+		char *it;
+
+		if (!pcut_str_start_equals(line, name, name_len)
+				|| (line[name_len] != ' ')) {
+			continue;
+		}
+		it = line + name_len + 1;
+		if (!pcut_str_start_equals(it, metric, metric_len)
+				|| (it[metric_len] != ' ')) {
+			continue;
+		}
+		it += metric_len + 1;
+
+		/* The count is implied by the samples themselves. */
+		(void) strtod(it, &it);
+		count = 0;
+		while (count < PCUT_BENCHMARK_MAX_SAMPLES) {
+			char *end;
+			double value = strtod(it, &end);
+			if (end == it) {
+				break;
+			}
+			baseline_samples[count] = value;
+			count++;
+			it = end;
+		}
+	}
+
+	fclose(input);
+
+	return count;
+}
+
+/** Compute median of the samples.
+ *
+ * @param samples The samples (at least one).
+ * @param count Number of samples.
+ * @return The median.
+ */
+static double median(const double *samples, int count) {
+	double sorted[PCUT_BENCHMARK_MAX_SAMPLES];
+	int i, j;
+
+	for (i = 0; i < count; i++) {
+		double value = samples[i];
+		for (j = i; (j > 0) && (sorted[j - 1] > value); j--) {
+			sorted[j] = sorted[j - 1];
+		}
+		sorted[j] = value;
+	}
+
+	if (count % 2 == 1) {
+		return sorted[count / 2];
+	}
+	return (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+}
+
+/** Compute z-score of the Mann-Whitney U test.
+ *
+ * Positive value means that @p current tends to be larger than
+ * @p baseline.
+ *
+ * @param current Samples of the current run.
+ * @param current_count Number of samples in @p current.
+ * @param baseline Samples of the baseline.
+ * @param baseline_count Number of samples in @p baseline.
+ * @return The z-score.
+ */
+static double mann_whitney_z(const double *current, int current_count,
+		const double *baseline, int baseline_count) {
+	double n1 = current_count;
+	double n2 = baseline_count;
+	double n = n1 + n2;
+	double u = 0.0;
+	double ties = 0.0;
+	double mean, variance, diff;
+	int i, j;
+
+	/*
+	 * U is the number of pairs where the current sample is larger
+	 * (ties count one half), which equals rank sum based definition.
+	 */
+	for (i = 0; i < current_count; i++) {
+		for (j = 0; j < baseline_count; j++) {
+			if (current[i] > baseline[j]) {
+				u += 1.0;
+			} else if (current[i] == baseline[j]) {
+				u += 0.5;
+			}
+		}
+	}
+
+	/* Tie correction: sum of t^3 - t over groups of equal values. */
+	for (i = 0; i < current_count + baseline_count; i++) {
+		double value = i < current_count ? current[i] : baseline[i - current_count];
+		double t = 0.0;
+		int first = 1;
+		for (j = 0; j < current_count + baseline_count; j++) {
+			double other = j < current_count ? current[j] : baseline[j - current_count];
+			if (other == value) {
+				if (j < i) {
+					first = 0;
+					break;
+				}
+				t += 1.0;
+			}
+		}
+		if (first) {
+			ties += t * t * t - t;
+		}
+	}
+
+	mean = n1 * n2 / 2.0;
+	variance = n1 * n2 / 12.0 * ((n + 1.0) - ties / (n * (n - 1.0)));
+	if (variance <= 0.0) {
+		return 0.0;
+	}
+
+	/* Continuity correction. */
+	diff = u - mean;
+	if (diff > 0.5) {
+		diff -= 0.5;
+	} else if (diff < -0.5) {
+		diff += 0.5;
+	} else {
+		diff = 0.0;
+	}
+
+	return diff / pcut_square_root(variance);
+}
+
+/** Save and compare results of the current benchmark.
+ *
+ * When the benchmark is slower than the baseline, the current test
+ * fails (this function does not return in such case).
+ *
+ * @param metric What the samples measure (also used as unit).
+ * @param samples The samples.
+ * @param count Number of samples.
+ */
+void pcut_baseline_process(const char *metric, const double *samples, int count) {
+	static char message[BASELINE_LINE_SIZE];
+	char current_formatted[PCUT_MEASUREMENT_NAME_SIZE];
+	char baseline_formatted[PCUT_MEASUREMENT_NAME_SIZE];
+	pcut_measurement_t formatted;
+	double current_median, baseline_median, change, z;
+	int baseline_count;
+
+	if (save_filename != NULL) {
+		save_samples(metric, samples, count);
+	}
+
+	if (compare_filename == NULL) {
+		return;
+	}
+
+	baseline_count = load_samples(metric);
+	if (baseline_count == 0) {
+		return;
+	}
+
+	current_median = median(samples, count);
+	baseline_median = median(baseline_samples, baseline_count);
+	if (baseline_median <= 0.0) {
+		return;
+	}
+	change = (current_median - baseline_median) * 100.0 / baseline_median;
+	z = mann_whitney_z(samples, count, baseline_samples, baseline_count);
+
+	pcut_record_measurement("baseline-median", baseline_median, metric);
+	pcut_record_measurement("change", change, "%");
+	pcut_record_measurement("z-score", z, "sigma");
+
+	if ((z < BASELINE_CRITICAL_Z) || (change <= pcut_baseline_min_effect)) {
+		return;
+	}
+
+	formatted.value = current_median;
+	pcut_snprintf(formatted.unit, PCUT_MEASUREMENT_UNIT_SIZE, "%s", metric);
+	pcut_format_measurement(current_formatted, PCUT_MEASUREMENT_NAME_SIZE, &formatted);
+	formatted.value = baseline_median;
+	pcut_format_measurement(baseline_formatted, PCUT_MEASUREMENT_NAME_SIZE, &formatted);
+
+	pcut_snprintf(message, BASELINE_LINE_SIZE,
+		"Performance regression: median %s but baseline %s (+%.1f%%, z=%.2f)",
+		current_formatted, baseline_formatted, change, z);
+	pcut_failed_assertion(message);
+}
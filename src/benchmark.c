@@ -0,0 +1,1152 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Execution of benchmarks.
+ *
+ * The benchmark body is first calibrated: the number of iterations
+ * grows until a single execution of the body takes at least
+ * PCUT_BENCHMARK_MIN_SAMPLE_TIME.
+ * Then the body is executed repeatedly (each execution is one sample)
+ * until the confidence interval of the mean is tight enough or until
+ * the maximum number of samples (or time) is reached.
+ *
+ * The statistics are recorded as measurements of the current test.
+ *
+ * In the instruction-count mode, there is no calibration: the body is
+ * executed with a fixed iteration count and each sample is the number
+ * of retired user-space instructions per iteration.
+ * Such counts are nearly deterministic, so even small regressions
+ * can be detected reliably.
+ *
+ * When comparing two variants, each sample consists of one execution
+ * of both variants in a random order and the ratio of their times is
+ * computed from each such pair.
+ * That way slow drifts (e.g. frequency scaling) affect both variants
+ * equally.
+ *
+ * Counters declared by the body (bytes, items or custom ones) are
+ * converted to rates per second using the mean time.
+ *
+ * In the cold-cache mode, the body is additionally executed with
+ * a single iteration several times and before each execution the
+ * processor caches are evicted by sweeping a buffer larger than the
+ * last-level cache.
+ * Optionally, the buffer pages are discarded before the sweep so that
+ * they are faulted in again (this also flushes the TLB).
+ * Cold results are recorded next to the warm ones.
+ *
+ * Measured times exclude paused parts of the body and the overhead
+ * of reading the clock (calibrated once per measurement).
+ *
+ * Scalability benchmarks execute the body concurrently in several
+ * threads with the iteration count calibrated for a single thread.
+ * They always measure time and they are never pinned.
+ *
+ * When requested, other benchmarks pin their process to the quietest
+ * processor (isolated one or the one with least load on its core).
+ *
+ * Latency is measured by timing each execution of the body (with
+ * a single iteration) separately and collecting the durations in
+ * a log-linear histogram that provides the tail percentiles.
+ *
+ * Complexity is measured by running the body for doubling input sizes.
+ * Cost for each size (fastest sample or counted operations) is fitted
+ * to each complexity model by least squares and the model with the
+ * smallest relative error wins.
+ */
+
+#include "internal.h"
+
+
+/** Quantiles of Student's t-distribution for 95% two-sided interval.
+ *
+ * Indexed by degrees of freedom minus one.
+ */
+static const double student_t_95[PCUT_BENCHMARK_MAX_SAMPLES - 1] = {
+	12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+	2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045
+};
+
+/** How benchmarks are measured (PCUT_BENCHMARK_MODE_*). */
+int pcut_benchmark_mode = PCUT_BENCHMARK_MODE_TIME;
+
+/** Whether benchmarks are pinned to the quietest processor. */
+int pcut_benchmark_pin = 0;
+
+/** Whether benchmarks are measured with cold caches (PCUT_BENCHMARK_CACHE_*). */
+int pcut_benchmark_cache = PCUT_BENCHMARK_CACHE_WARM;
+
+/** Number of iterations in the instruction-count mode. */
+int pcut_benchmark_iterations = PCUT_BENCHMARK_DEFAULT_ITERATIONS;
+
+/** Variable the escaped pointers are stored to (see pcut_do_not_optimize()). */
+const void *volatile pcut_optimization_sink;
+
+/** Processor the benchmarks are pinned to (-1 when not pinned). */
+static int pinned_cpu = -1;
+
+/** Number of clock readings used to estimate their overhead. */
+#define TIMER_OVERHEAD_ROUNDS 64
+
+/** Duration of an empty timed block (in nanoseconds). */
+static unsigned long long timer_overhead;
+
+/** Counter declared by a benchmark body. */
+typedef struct {
+	/** Counter name. */
+	const char *name;
+	/** Value of the counter per iteration. */
+	double per_iteration;
+} benchmark_counter_t;
+
+/** Counters declared by the current benchmark body. */
+static benchmark_counter_t counters[PCUT_BENCHMARK_MAX_COUNTERS];
+
+/** Number of valid items in counters. */
+static int counter_count;
+
+/** Sum of per-iteration cycles over samples (instruction-count mode). */
+static double cycles_total;
+
+/** Per-iteration times of individual samples (in nanoseconds). */
+static double samples[PCUT_BENCHMARK_MAX_SAMPLES];
+
+/** Per-iteration times of samples of the second compared variant. */
+static double samples_other[PCUT_BENCHMARK_MAX_SAMPLES];
+
+/** Ratios of paired samples of compared variants. */
+static double ratios[PCUT_BENCHMARK_MAX_SAMPLES];
+
+/** State of the pseudo-random generator for ordering of variants. */
+static unsigned long long random_state;
+
+/** Input sizes used when measuring complexity. */
+static double complexity_sizes[PCUT_COMPLEXITY_MAX_SIZES];
+
+/** Cost per iteration for each of complexity_sizes. */
+static double complexity_costs[PCUT_COMPLEXITY_MAX_SIZES];
+
+/** Complexity class found by the last measurement (-1 when none). */
+static int measured_complexity = -1;
+
+/** Buffer swept to evict processor caches (NULL until needed). */
+static volatile unsigned char *eviction_buffer = NULL;
+
+/** Size of eviction_buffer in bytes. */
+static size_t eviction_buffer_size;
+
+/** Per-operation durations collected by the last latency measurement. */
+static pcut_histogram_t latency_histogram;
+
+/** Whether latency was measured in the current test. */
+static int latency_measured = 0;
+
+/** Names of complexity classes (indexed by PCUT_O_*). */
+static const char *complexity_names[] = {
+	"O(1)", "O(log n)", "O(n)", "O(n log n)", "O(n^2)"
+};
+
+/** Statistics computed over the samples. */
+typedef struct {
+	/** Arithmetic mean. */
+	double mean;
+	/** Median. */
+	double median;
+	/** Sample standard deviation. */
+	double stddev;
+	/** Minimum. */
+	double min;
+	/** Half-width of the 95% confidence interval of the mean. */
+	double ci_half_width;
+} benchmark_stats_t;
+
+/** Compute square root without depending on libm.
+ *
+ * @param value Non-negative value.
+ * @return Square root of @p value.
+ */
+double pcut_square_root(double value) {
+	double result = value;
+	int i;
+
+	if (value <= 0.0) {
+		return 0.0;
+	}
+	if (result < 1.0) {
+		result = 1.0;
+	}
+	for (i = 0; i < 64; i++) {
+		double next = (result + value / result) / 2.0;
+		if (next == result) {
+			break;
+		}
+		result = next;
+	}
+
+	return result;
+}
+
+/** Initialize benchmark state.
+ *
+ * @param state State to initialize.
+ */
+static void init_state(pcut_benchmark_t *state) {
+	state->iterations = 1;
+	state->n = 0;
+	state->operations = 0;
+	state->paused_time = 0;
+	state->pause_start = 0;
+	state->pauses = 0;
+	state->thread_index = 0;
+	state->thread_count = 1;
+}
+
+/** Estimate overhead of measuring time.
+ *
+ * The smallest observed duration of an empty block is used so that
+ * the overhead is never overestimated.
+ */
+static void calibrate_timer_overhead(void) {
+	int i;
+
+	timer_overhead = 0;
+	for (i = 0; i < TIMER_OVERHEAD_ROUNDS; i++) {
+		unsigned long long start = pcut_timer_now();
+		unsigned long long duration = pcut_timer_now() - start;
+		if ((i == 0) || (duration < timer_overhead)) {
+			timer_overhead = duration;
+		}
+	}
+}
+
+/** Execute the benchmark body once and measure its duration.
+ *
+ * Paused parts of the body and the overhead of the clock are
+ * not included.
+ *
+ * @param func Benchmark body.
+ * @param state Benchmark state with the iteration count set.
+ * @return Duration in nanoseconds.
+ */
+static unsigned long long run_once(pcut_benchmark_func_t func,
+		pcut_benchmark_t *state) {
+	unsigned long long start, duration, excluded;
+
+	state->paused_time = 0;
+	state->pauses = 0;
+
+	start = pcut_timer_now();
+	func(state);
+	duration = pcut_timer_now() - start;
+
+	excluded = state->paused_time + timer_overhead * (state->pauses + 1);
+	return duration > excluded ? duration - excluded : 0;
+}
+
+/** Find number of iterations that takes at least minimal sample time.
+ *
+ * @param func Benchmark body.
+ * @param state Benchmark state where the iteration count is stored.
+ */
+static void calibrate(pcut_benchmark_func_t func, pcut_benchmark_t *state) {
+	state->iterations = 1;
+	while (1) {
+		unsigned long long duration = run_once(func, state);
+		unsigned long next;
+
+		if (duration >= PCUT_BENCHMARK_MIN_SAMPLE_TIME) {
+			return;
+		}
+
+		if (duration * 10 < PCUT_BENCHMARK_MIN_SAMPLE_TIME) {
+			next = state->iterations * 10;
+		} else {
+			/* Aim slightly above the minimum to avoid another round. */
+			next = (unsigned long) ((double) state->iterations * 1.2
+				* (double) PCUT_BENCHMARK_MIN_SAMPLE_TIME
+				/ (double) duration) + 1;
+		}
+
+		if (next <= state->iterations) {
+			/* Overflow, use what we have. */
+			return;
+		}
+		state->iterations = next;
+	}
+}
+
+/** Measure one sample of the benchmark body.
+ *
+ * @param func Benchmark body.
+ * @param state Benchmark state with the iteration count set.
+ * @return Time (in nanoseconds) or number of instructions per iteration.
+ */
+static double measure_sample(pcut_benchmark_func_t func, pcut_benchmark_t *state) {
+	unsigned long long instructions, cycles;
+
+	if (pcut_benchmark_mode == PCUT_BENCHMARK_MODE_TIME) {
+		return (double) run_once(func, state) / state->iterations;
+	}
+
+	pcut_instruction_counters_begin();
+	func(state);
+	pcut_instruction_counters_end(&instructions, &cycles);
+
+	cycles_total += (double) cycles / state->iterations;
+	return (double) instructions / state->iterations;
+}
+
+/** Prepare benchmark for measurement.
+ *
+ * @param func Benchmark body.
+ * @param state Benchmark state where the iteration count is stored.
+ */
+static void prepare(pcut_benchmark_func_t func, pcut_benchmark_t *state) {
+	if (pcut_benchmark_mode == PCUT_BENCHMARK_MODE_TIME) {
+		calibrate(func, state);
+	} else {
+		state->iterations = pcut_benchmark_iterations > 0
+			? (unsigned long) pcut_benchmark_iterations : 1;
+	}
+}
+
+/** Pin the current process to the quietest processor when requested.
+ *
+ * The processor is selected only once per process and recorded
+ * as a measurement of each benchmark.
+ */
+static void pin_when_requested(void) {
+	if (!pcut_benchmark_pin) {
+		return;
+	}
+	if (pinned_cpu < 0) {
+		pinned_cpu = pcut_pin_to_quiet_cpu();
+	}
+	if (pinned_cpu >= 0) {
+		pcut_record_measurement("pinned-cpu", (double) pinned_cpu, "x");
+	}
+}
+
+/** Start measurement in the current process.
+ *
+ * In the instruction-count mode, the process is pinned and the counters
+ * are opened (the current test fails when they are not available).
+ */
+static void start_measurement(void) {
+	cycles_total = 0.0;
+	counter_count = 0;
+
+	pin_when_requested();
+	if (pcut_benchmark_mode == PCUT_BENCHMARK_MODE_TIME) {
+		calibrate_timer_overhead();
+		return;
+	}
+
+	if (pinned_cpu < 0) {
+		pcut_pin_to_cpu();
+	}
+	if (!pcut_instruction_counters_open()) {
+		pcut_instruction_counters_close();
+		pcut_failed_assertion("Instruction counters are not available.");
+	}
+}
+
+/** Finish measurement started by start_measurement(). */
+static void finish_measurement(void) {
+	if (pcut_benchmark_mode != PCUT_BENCHMARK_MODE_TIME) {
+		pcut_instruction_counters_close();
+	}
+}
+
+/** Unit of the samples in the current mode.
+ *
+ * @return Unit name (also used as the baseline metric).
+ */
+static const char *sample_unit(void) {
+	if (pcut_benchmark_mode == PCUT_BENCHMARK_MODE_TIME) {
+		return "ns";
+	}
+	return "instructions";
+}
+
+/** Declare counter of the benchmark body.
+ *
+ * Called from PCUT_BENCHMARK_SET_COUNTER() and similar macros.
+ * Setting the same counter again overwrites its value.
+ *
+ * @param benchmark State of the running benchmark.
+ * @param name Counter name.
+ * @param per_iteration Value of the counter per iteration.
+ */
+void pcut_benchmark_set_counter(pcut_benchmark_t *benchmark,
+		const char *name, double per_iteration) {
+	int i;
+
+	PCUT_UNUSED(benchmark);
+
+	for (i = 0; i < counter_count; i++) {
+		if (pcut_str_equals(counters[i].name, name)) {
+			counters[i].per_iteration = per_iteration;
+			return;
+		}
+	}
+	if (counter_count < PCUT_BENCHMARK_MAX_COUNTERS) {
+		counters[counter_count].name = name;
+		counters[counter_count].per_iteration = per_iteration;
+		counter_count++;
+	}
+}
+
+/** Record rates of the declared counters.
+ *
+ * Rates make sense only for measured time, counters are recorded per
+ * iteration in the instruction-count mode.
+ *
+ * @param mean Mean time (or instruction count) of one iteration.
+ */
+static void record_counters(double mean) {
+	char name[PCUT_MEASUREMENT_NAME_SIZE];
+	char unit[PCUT_MEASUREMENT_NAME_SIZE];
+	int i;
+
+	for (i = 0; i < counter_count; i++) {
+		const char *unit_name = pcut_str_equals(counters[i].name, "bytes")
+			? "B" : counters[i].name;
+
+		if (pcut_benchmark_mode != PCUT_BENCHMARK_MODE_TIME) {
+			pcut_record_measurement(counters[i].name,
+				counters[i].per_iteration, unit_name);
+			continue;
+		}
+		if (mean <= 0.0) {
+			continue;
+		}
+
+		pcut_snprintf(name, PCUT_MEASUREMENT_NAME_SIZE, "%s-rate",
+			counters[i].name);
+		pcut_snprintf(unit, PCUT_MEASUREMENT_NAME_SIZE, "%s/s", unit_name);
+		pcut_record_measurement(name,
+			counters[i].per_iteration * 1000000000.0 / mean, unit);
+	}
+}
+
+/** Compute statistics of given samples.
+ *
+ * @param values The samples.
+ * @param count Number of samples (at least one).
+ * @param stats Where to store the statistics.
+ */
+static void compute_stats(const double *values, int count, benchmark_stats_t *stats) {
+	double sorted[PCUT_BENCHMARK_MAX_SAMPLES];
+	double sum = 0.0;
+	double sum_sq = 0.0;
+	int i, j;
+
+	for (i = 0; i < count; i++) {
+		sum += values[i];
+	}
+	stats->mean = sum / count;
+
+	for (i = 0; i < count; i++) {
+		double diff = values[i] - stats->mean;
+		sum_sq += diff * diff;
+	}
+	if (count > 1) {
+		stats->stddev = pcut_square_root(sum_sq / (count - 1));
+		stats->ci_half_width = student_t_95[count - 2]
+			* stats->stddev / pcut_square_root(count);
+	} else {
+		stats->stddev = 0.0;
+		stats->ci_half_width = stats->mean;
+	}
+
+	/* Insertion sort is good enough for this few samples. */
+	for (i = 0; i < count; i++) {
+		double value = values[i];
+		for (j = i; (j > 0) && (sorted[j - 1] > value); j--) {
+			sorted[j] = sorted[j - 1];
+		}
+		sorted[j] = value;
+	}
+	stats->min = sorted[0];
+	if (count % 2 == 1) {
+		stats->median = sorted[count / 2];
+	} else {
+		stats->median = (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+	}
+}
+
+/** Allocate the buffer used for evicting processor caches.
+ *
+ * @return Whether the buffer is available.
+ */
+static int prepare_eviction_buffer(void) {
+	size_t size, i;
+
+	if (eviction_buffer != NULL) {
+		return 1;
+	}
+
+	size = pcut_get_last_level_cache_size();
+	if (size == 0) {
+		size = PCUT_COLD_CACHE_DEFAULT_SIZE;
+	}
+	/* Caches are not perfectly LRU, sweep more than their size. */
+	size += size / 2;
+	if (size > PCUT_COLD_CACHE_MAX_SIZE) {
+		size = PCUT_COLD_CACHE_MAX_SIZE;
+	}
+
+	eviction_buffer = pcut_map_pages(size);
+	if (eviction_buffer == NULL) {
+		return 0;
+	}
+	eviction_buffer_size = size;
+
+	/* Untouched pages could all map the same zero page. */
+	for (i = 0; i < size; i += PCUT_COLD_CACHE_LINE_SIZE) {
+		eviction_buffer[i] = 1;
+	}
+
+	return 1;
+}
+
+/** Evict processor caches by writing to every line of the buffer. */
+static void evict_caches(void) {
+	size_t i;
+
+	if (pcut_benchmark_cache == PCUT_BENCHMARK_CACHE_COLD_REFAULT) {
+		pcut_discard_pages((void *) eviction_buffer, eviction_buffer_size);
+	}
+	for (i = 0; i < eviction_buffer_size; i += PCUT_COLD_CACHE_LINE_SIZE) {
+		eviction_buffer[i]++;
+	}
+}
+
+/** Measure the benchmark body with cold caches and record the results.
+ *
+ * Nothing is recorded when the eviction buffer cannot be allocated.
+ *
+ * @param func Benchmark body.
+ * @param warm_median Median time per iteration with warm caches.
+ */
+static void measure_cold(pcut_benchmark_func_t func, double warm_median) {
+	pcut_benchmark_t state;
+	benchmark_stats_t stats;
+	int i;
+
+	if (!prepare_eviction_buffer()) {
+		return;
+	}
+
+	init_state(&state);
+	for (i = 0; i < PCUT_COLD_CACHE_SAMPLES; i++) {
+		evict_caches();
+		samples_other[i] = (double) run_once(func, &state);
+	}
+	compute_stats(samples_other, PCUT_COLD_CACHE_SAMPLES, &stats);
+
+	pcut_record_measurement("cold-mean", stats.mean, "ns");
+	pcut_record_measurement("cold-median", stats.median, "ns");
+	pcut_record_measurement("cold-min", stats.min, "ns");
+	pcut_record_measurement("cold-slowdown",
+		warm_median > 0.0 ? stats.median / warm_median : 0.0, "x");
+}
+
+/** Run a benchmark body and record its statistics.
+ *
+ * Called from the test function generated by PCUT_BENCHMARK().
+ *
+ * @param func Benchmark body.
+ */
+void pcut_run_benchmark(pcut_benchmark_func_t func) {
+	pcut_benchmark_t state;
+	benchmark_stats_t stats;
+	unsigned long long start_time;
+	int count = 0;
+
+	init_state(&state);
+	start_measurement();
+	prepare(func, &state);
+
+	start_time = pcut_timer_now();
+	while (count < PCUT_BENCHMARK_MAX_SAMPLES) {
+		samples[count] = measure_sample(func, &state);
+		count++;
+
+		compute_stats(samples, count, &stats);
+		if ((count >= PCUT_BENCHMARK_MIN_SAMPLES) && (stats.ci_half_width
+				<= stats.mean * PCUT_BENCHMARK_PRECISION / 100.0)) {
+			break;
+		}
+		if ((count > 1) && (pcut_timer_now() - start_time >= PCUT_BENCHMARK_MAX_TIME)) {
+			break;
+		}
+	}
+
+	finish_measurement();
+
+	pcut_record_measurement("iterations", (double) state.iterations, "x");
+	pcut_record_measurement("samples", (double) count, "x");
+	pcut_record_measurement("mean", stats.mean, sample_unit());
+	pcut_record_measurement("median", stats.median, sample_unit());
+	pcut_record_measurement("stddev", stats.stddev, sample_unit());
+	pcut_record_measurement("min", stats.min, sample_unit());
+	pcut_record_measurement("ci95-low", stats.mean - stats.ci_half_width, sample_unit());
+	pcut_record_measurement("ci95-high", stats.mean + stats.ci_half_width, sample_unit());
+	if (cycles_total > 0.0) {
+		pcut_record_measurement("cycles", cycles_total / count, "cycles");
+	}
+	record_counters(stats.mean);
+
+	if ((pcut_benchmark_cache != PCUT_BENCHMARK_CACHE_WARM)
+			&& (pcut_benchmark_mode == PCUT_BENCHMARK_MODE_TIME)) {
+		measure_cold(func, stats.median);
+	}
+
+	pcut_baseline_process(sample_unit(), samples, count);
+}
+
+/** Stop measuring the benchmark body.
+ *
+ * Called from PCUT_BENCHMARK_PAUSE_TIMING().
+ *
+ * @param benchmark State of the running benchmark.
+ */
+void pcut_benchmark_pause_timing(pcut_benchmark_t *benchmark) {
+	benchmark->pauses++;
+	if (pcut_benchmark_mode == PCUT_BENCHMARK_MODE_TIME) {
+		benchmark->pause_start = pcut_timer_now();
+	} else {
+		pcut_instruction_counters_pause();
+	}
+}
+
+/** Resume measuring the benchmark body.
+ *
+ * Called from PCUT_BENCHMARK_RESUME_TIMING().
+ *
+ * @param benchmark State of the running benchmark.
+ */
+void pcut_benchmark_resume_timing(pcut_benchmark_t *benchmark) {
+	if (pcut_benchmark_mode == PCUT_BENCHMARK_MODE_TIME) {
+		benchmark->paused_time += pcut_timer_now() - benchmark->pause_start;
+	} else {
+		pcut_instruction_counters_resume();
+	}
+}
+
+/** Prevent the compiler from optimizing memory accesses around the call.
+ *
+ * Used by pcut_clobber_memory() when inline assembly is not available,
+ * the compiler cannot see into this function.
+ */
+void pcut_clobber_memory_impl(void) {
+	pcut_optimization_sink = pcut_optimization_sink;
+}
+
+/** Get next pseudo-random bit (xorshift generator).
+ *
+ * @return Zero or one.
+ */
+static int random_bit(void) {
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+	return (int) ((random_state >> 32) & 1);
+}
+
+/** Run two variants of a benchmark and record their ratio.
+ *
+ * Called from the test function generated by PCUT_BENCHMARK_COMPARE().
+ * The ratio (B to A) and its confidence interval are recorded as
+ * measurements together with the verdict: the relative change of B
+ * against A (named after both variants, negative when B is faster) and
+ * whether B is faster (-1), slower (1) or not significantly different (0)
+ * as decided by the confidence interval of the ratio containing 1.
+ *
+ * @param name_a Name of the first (reference) variant.
+ * @param func_a Body of the first variant.
+ * @param name_b Name of the second variant.
+ * @param func_b Body of the second variant.
+ */
+void pcut_run_benchmark_compare(const char *name_a, pcut_benchmark_func_t func_a,
+		const char *name_b, pcut_benchmark_func_t func_b) {
+	pcut_benchmark_t state_a;
+	pcut_benchmark_t state_b;
+	benchmark_stats_t stats_a, stats_b, stats_ratio;
+	unsigned long long start_time;
+	char verdict_name[PCUT_MEASUREMENT_NAME_SIZE];
+	double low, high;
+	int count = 0;
+
+	random_state = pcut_timer_now() | 1;
+	init_state(&state_a);
+	init_state(&state_b);
+
+	start_measurement();
+	prepare(func_a, &state_a);
+	prepare(func_b, &state_b);
+
+	start_time = pcut_timer_now();
+	while (count < PCUT_BENCHMARK_MAX_SAMPLES) {
+		if (random_bit()) {
+			samples[count] = measure_sample(func_a, &state_a);
+			samples_other[count] = measure_sample(func_b, &state_b);
+		} else {
+			samples_other[count] = measure_sample(func_b, &state_b);
+			samples[count] = measure_sample(func_a, &state_a);
+		}
+		ratios[count] = samples[count] > 0.0 ? samples_other[count] / samples[count] : 1.0;
+		count++;
+
+		compute_stats(ratios, count, &stats_ratio);
+		if ((count >= PCUT_BENCHMARK_MIN_SAMPLES) && (stats_ratio.ci_half_width
+				<= stats_ratio.mean * PCUT_BENCHMARK_PRECISION / 100.0)) {
+			break;
+		}
+		if ((count > 1) && (pcut_timer_now() - start_time >= PCUT_BENCHMARK_MAX_TIME)) {
+			break;
+		}
+	}
+
+	finish_measurement();
+
+	compute_stats(samples, count, &stats_a);
+	compute_stats(samples_other, count, &stats_b);
+	low = stats_ratio.mean - stats_ratio.ci_half_width;
+	high = stats_ratio.mean + stats_ratio.ci_half_width;
+
+	pcut_record_measurement("samples", (double) count, "x");
+	pcut_record_measurement("a-mean", stats_a.mean, sample_unit());
+	pcut_record_measurement("b-mean", stats_b.mean, sample_unit());
+	pcut_record_measurement("ratio", stats_ratio.mean, "x");
+	pcut_record_measurement("ratio-ci95-low", low, "x");
+	pcut_record_measurement("ratio-ci95-high", high, "x");
+
+	pcut_snprintf(verdict_name, PCUT_MEASUREMENT_NAME_SIZE, "%s-vs-%s",
+		name_b, name_a);
+	pcut_record_measurement(verdict_name, (stats_ratio.mean - 1.0) * 100.0, "%");
+	if (high < 1.0) {
+		pcut_record_measurement("verdict", -1, "faster");
+	} else if (low > 1.0) {
+		pcut_record_measurement("verdict", 1, "slower");
+	} else {
+		pcut_record_measurement("verdict", 0, "no-difference");
+	}
+}
+
+/** Threads executing a scalability benchmark. */
+typedef struct {
+	/** Benchmark body. */
+	pcut_benchmark_func_t func;
+	/** State of each thread. */
+	pcut_benchmark_t states[PCUT_BENCHMARK_MAX_THREADS];
+	/** Duration of the body in each thread. */
+	unsigned long long durations[PCUT_BENCHMARK_MAX_THREADS];
+} benchmark_threads_t;
+
+/** Threads of the running scalability benchmark. */
+static benchmark_threads_t benchmark_threads;
+
+/** Execute benchmark body in one of the threads.
+ *
+ * @param index Thread index.
+ * @param arg The benchmark_threads_t structure.
+ */
+static void run_benchmark_thread(int index, void *arg) {
+	benchmark_threads_t *threads = arg;
+	threads->durations[index] = run_once(threads->func, &threads->states[index]);
+}
+
+/** Measure body executed by given number of threads.
+ *
+ * @param func Benchmark body.
+ * @param state State with calibrated iteration count.
+ * @param count Number of threads.
+ * @param rate Where to store aggregate throughput (iterations per second).
+ * @param latency Where to store mean time of one iteration in a thread.
+ */
+static void measure_threads(pcut_benchmark_func_t func, pcut_benchmark_t *state,
+		int count, double *rate, double *latency) {
+	benchmark_stats_t stats;
+	int sample, i;
+
+	benchmark_threads.func = func;
+	for (sample = 0; sample < PCUT_BENCHMARK_THREAD_SAMPLES; sample++) {
+		unsigned long long wall_time = 0;
+		double duration_sum = 0.0;
+
+		for (i = 0; i < count; i++) {
+			benchmark_threads.states[i] = *state;
+			benchmark_threads.states[i].thread_index = i;
+			benchmark_threads.states[i].thread_count = count;
+		}
+		if (!pcut_run_threads(count, run_benchmark_thread, &benchmark_threads)) {
+			pcut_failed_assertion("Failed to start benchmark threads.");
+		}
+
+		/* Threads start together so the slowest one is the wall time. */
+		for (i = 0; i < count; i++) {
+			if (benchmark_threads.durations[i] > wall_time) {
+				wall_time = benchmark_threads.durations[i];
+			}
+			duration_sum += (double) benchmark_threads.durations[i];
+		}
+		samples[sample] = (double) wall_time;
+		samples_other[sample] = duration_sum / count / state->iterations;
+	}
+
+	compute_stats(samples, PCUT_BENCHMARK_THREAD_SAMPLES, &stats);
+	*rate = stats.median > 0.0
+		? (double) count * state->iterations * 1000000000.0 / stats.median
+		: 0.0;
+	compute_stats(samples_other, PCUT_BENCHMARK_THREAD_SAMPLES, &stats);
+	*latency = stats.median;
+}
+
+/** Run a benchmark body with increasing number of threads.
+ *
+ * Called from the test function generated by PCUT_BENCHMARK_THREADS().
+ *
+ * @param func Benchmark body.
+ * @param max_threads Maximum number of threads.
+ */
+void pcut_run_benchmark_threads(pcut_benchmark_func_t func, int max_threads) {
+	pcut_benchmark_t state;
+	char name[PCUT_MEASUREMENT_NAME_SIZE];
+	double single_rate = 0.0;
+	int count = 1;
+
+	if (max_threads > PCUT_BENCHMARK_MAX_THREADS) {
+		max_threads = PCUT_BENCHMARK_MAX_THREADS;
+	}
+	if (max_threads < 1) {
+		max_threads = 1;
+	}
+
+	init_state(&state);
+	calibrate_timer_overhead();
+	counter_count = 0;
+	calibrate(func, &state);
+	pcut_record_measurement("iterations", (double) state.iterations, "x");
+
+	while (1) {
+		double rate, latency;
+
+		measure_threads(func, &state, count, &rate, &latency);
+		if (count == 1) {
+			single_rate = rate;
+		}
+
+		pcut_snprintf(name, PCUT_MEASUREMENT_NAME_SIZE, "threads-%d-rate", count);
+		pcut_record_measurement(name, rate, "ops/s");
+		pcut_snprintf(name, PCUT_MEASUREMENT_NAME_SIZE, "threads-%d-latency", count);
+		pcut_record_measurement(name, latency, "ns");
+		pcut_snprintf(name, PCUT_MEASUREMENT_NAME_SIZE, "threads-%d-efficiency", count);
+		pcut_record_measurement(name,
+			single_rate > 0.0 ? rate / (count * single_rate) * 100.0 : 0.0, "%");
+
+		if (count >= max_threads) {
+			break;
+		}
+		count = count * 2 > max_threads ? max_threads : count * 2;
+	}
+}
+
+/** Measure distribution of per-operation latency of a benchmark body.
+ *
+ * Called from PCUT_MEASURE_LATENCY().
+ * The percentiles are recorded as measurements so that
+ * PCUT_ASSERT_PERCENTILE_BELOW() can check them.
+ *
+ * @param func Benchmark body (one execution is one operation).
+ */
+void pcut_measure_latency(pcut_benchmark_func_t func) {
+	pcut_benchmark_t state;
+	unsigned long long start;
+	int i;
+
+	init_state(&state);
+	pin_when_requested();
+	calibrate_timer_overhead();
+	pcut_histogram_clear(&latency_histogram);
+
+	for (i = 0; i < PCUT_LATENCY_WARMUP_OPERATIONS; i++) {
+		run_once(func, &state);
+	}
+
+	start = pcut_timer_now();
+	while (latency_histogram.total < PCUT_LATENCY_MAX_OPERATIONS) {
+		pcut_histogram_add(&latency_histogram, run_once(func, &state));
+		if (pcut_timer_now() - start >= PCUT_BENCHMARK_MAX_TIME) {
+			break;
+		}
+	}
+	latency_measured = 1;
+
+	pcut_record_measurement("operations", (double) latency_histogram.total, "x");
+	pcut_record_measurement("latency-p50",
+		(double) pcut_histogram_percentile(&latency_histogram, 50.0), "ns");
+	pcut_record_measurement("latency-p90",
+		(double) pcut_histogram_percentile(&latency_histogram, 90.0), "ns");
+	pcut_record_measurement("latency-p99",
+		(double) pcut_histogram_percentile(&latency_histogram, 99.0), "ns");
+	pcut_record_measurement("latency-p99.9",
+		(double) pcut_histogram_percentile(&latency_histogram, 99.9), "ns");
+	pcut_record_measurement("latency-max", (double) latency_histogram.max, "ns");
+
+	pcut_histogram_export(&latency_histogram, "ns");
+}
+
+/** Get latency percentile measured by the last PCUT_MEASURE_LATENCY().
+ *
+ * @param percentile Percentile (e.g. 99.9).
+ * @return Latency in nanoseconds.
+ * @retval -1 Latency was not measured.
+ */
+long long pcut_get_latency_percentile(double percentile) {
+	if (!latency_measured) {
+		return -1;
+	}
+	return (long long) pcut_histogram_percentile(&latency_histogram, percentile);
+}
+
+/** Compute binary logarithm without depending on libm.
+ *
+ * @param value Positive value.
+ * @return Binary logarithm of @p value.
+ */
+static double binary_logarithm(double value) {
+	double result = 0.0;
+	double y, y_squared, term;
+	int i;
+
+	while (value >= 2.0) {
+		value /= 2.0;
+		result += 1.0;
+	}
+	while (value < 1.0) {
+		value *= 2.0;
+		result -= 1.0;
+	}
+
+	/* ln(value) = 2 * (y + y^3 / 3 + y^5 / 5 + ...) */
+	y = (value - 1.0) / (value + 1.0);
+	y_squared = y * y;
+	term = y;
+	for (i = 1; i < 40; i += 2) {
+		result += 2.0 * term / i / 0.69314718055994531;
+		term *= y_squared;
+	}
+
+	return result;
+}
+
+/** Evaluate complexity model for given input size.
+ *
+ * @param complexity Complexity class (PCUT_O_*).
+ * @param n Input size.
+ * @return Value of the model function.
+ */
+static double complexity_model(int complexity, double n) {
+	switch (complexity) {
+	case PCUT_O_1:
+		return 1.0;
+	case PCUT_O_LOG_N:
+		return n > 1.0 ? binary_logarithm(n) : 1.0;
+	case PCUT_O_N:
+		return n;
+	case PCUT_O_N_LOG_N:
+		return n > 1.0 ? n * binary_logarithm(n) : 1.0;
+	default:
+		return n * n;
+	}
+}
+
+/** Fit the measured costs to given complexity model.
+ *
+ * @param complexity Complexity class (PCUT_O_*).
+ * @param count Number of measured input sizes.
+ * @param coefficient Where to store the coefficient of the model.
+ * @return Root mean square error relative to the mean cost.
+ */
+static double fit_complexity(int complexity, int count, double *coefficient) {
+	double sum_cost_model = 0.0;
+	double sum_model_squared = 0.0;
+	double sum_cost = 0.0;
+	double sum_error_squared = 0.0;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		double model = complexity_model(complexity, complexity_sizes[i]);
+		sum_cost_model += complexity_costs[i] * model;
+		sum_model_squared += model * model;
+		sum_cost += complexity_costs[i];
+	}
+	*coefficient = sum_cost_model / sum_model_squared;
+
+	for (i = 0; i < count; i++) {
+		double error = complexity_costs[i] - *coefficient
+			* complexity_model(complexity, complexity_sizes[i]);
+		sum_error_squared += error * error;
+	}
+
+	if (sum_cost <= 0.0) {
+		return 0.0;
+	}
+	return pcut_square_root(sum_error_squared / count) / (sum_cost / count);
+}
+
+/** Measure cost of one iteration of the body for current input size.
+ *
+ * @param func Benchmark body.
+ * @param state Benchmark state with the input size set.
+ * @param counting Whether the body counts operations.
+ * @return Cost of one iteration.
+ */
+static double measure_complexity_cost(pcut_benchmark_func_t func,
+		pcut_benchmark_t *state, int counting) {
+	double best = 0.0;
+	int i;
+
+	if (counting) {
+		state->iterations = 1;
+		state->operations = 0;
+		func(state);
+		return (double) state->operations;
+	}
+
+	prepare(func, state);
+	for (i = 0; i < PCUT_COMPLEXITY_SAMPLES; i++) {
+		double sample = measure_sample(func, state);
+		if ((i == 0) || (sample < best)) {
+			best = sample;
+		}
+	}
+
+	return best;
+}
+
+/** Measure how a benchmark body scales with input size.
+ *
+ * Called from PCUT_MEASURE_COMPLEXITY().
+ * The best fit is recorded as measurements (the class is the unit of
+ * the complexity measurement, e.g. O(n)) and remembered so that
+ * PCUT_ASSERT_COMPLEXITY_AT_MOST() can check it.
+ *
+ * @param func Benchmark body.
+ * @param n_min Smallest input size.
+ * @param n_max Largest input size.
+ */
+void pcut_measure_complexity(pcut_benchmark_func_t func,
+		unsigned long n_min, unsigned long n_max) {
+	pcut_benchmark_t state;
+	const char *unit;
+	double best_coefficient = 0.0;
+	double best_error = 0.0;
+	int count = 0;
+	int counting;
+	int complexity;
+
+	measured_complexity = -1;
+	init_state(&state);
+	if (n_min < 1) {
+		n_min = 1;
+	}
+
+	/* Bodies counting operations do so already for the first size. */
+	state.n = n_min;
+	func(&state);
+	counting = state.operations > 0;
+
+	if (!counting) {
+		start_measurement();
+	}
+	while ((state.n <= n_max) && (count < PCUT_COMPLEXITY_MAX_SIZES)) {
+		complexity_sizes[count] = (double) state.n;
+		complexity_costs[count] = measure_complexity_cost(func, &state, counting);
+		count++;
+		if (state.n * 2 <= state.n) {
+			break;
+		}
+		state.n *= 2;
+	}
+	if (!counting) {
+		finish_measurement();
+	}
+
+	if (count < PCUT_COMPLEXITY_MIN_SIZES) {
+		pcut_failed_assertion("Complexity needs at least three input sizes.");
+	}
+	unit = counting ? "operations" : sample_unit();
+
+	for (complexity = PCUT_O_1; complexity <= PCUT_O_N_SQUARED; complexity++) {
+		double coefficient;
+		double error = fit_complexity(complexity, count, &coefficient);
+		/*
+		 * Prefer the simpler model unless the more complex one is
+		 * clearly better (noise must not push the fit up).
+		 */
+		if ((measured_complexity < 0) || (error < best_error * 0.9)) {
+			measured_complexity = complexity;
+			best_coefficient = coefficient;
+			best_error = error;
+		}
+	}
+
+	pcut_record_measurement("complexity", (double) measured_complexity,
+		complexity_names[measured_complexity]);
+	pcut_record_measurement("complexity-sizes", (double) count, "x");
+	pcut_record_measurement("complexity-coefficient", best_coefficient, unit);
+	pcut_record_measurement("complexity-error", best_error * 100.0, "%");
+}
+
+/** Get complexity class measured by the last PCUT_MEASURE_COMPLEXITY().
+ *
+ * @return Complexity class (PCUT_O_*).
+ * @retval -1 Complexity was not measured.
+ */
+int pcut_get_complexity(void) {
+	return measured_complexity;
+}
+
+/** Get human-readable name of a complexity class.
+ *
+ * @param complexity Complexity class (PCUT_O_*).
+ * @return Name such as "O(n log n)".
+ */
+const char *pcut_complexity_name(int complexity) {
+	if ((complexity < PCUT_O_1) || (complexity > PCUT_O_N_SQUARED)) {
+		return "O(?)";
+	}
+	return complexity_names[complexity];
+}
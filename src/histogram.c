@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Log-linear latency histograms.
+ *
+ * Values below PCUT_HISTOGRAM_SUB_BUCKETS have a bucket each.
+ * Each larger power-of-two range is split into
+ * PCUT_HISTOGRAM_SUB_BUCKETS / 2 buckets of equal width, thus any
+ * value is known with relative precision better than 2/SUB_BUCKETS
+ * while the whole 64-bit range fits into a fixed number of buckets.
+ *
+ * Percentiles are reported as the highest value of the bucket that
+ * contains them (never above the recorded maximum).
+ *
+ * When requested, histograms are appended to a JSON Lines file
+ * (one object per measurement) with a single write as tests might
+ * run concurrently.
+ */
+
+#include "internal.h"
+
+#pragma warning(push, 0)
+#include <stdio.h>
+#pragma warning(pop)
+
+
+/** Number of buckets in the same power-of-two range above the linear part. */
+#define HALF_SUB_BUCKETS (PCUT_HISTOGRAM_SUB_BUCKETS / 2)
+
+/** Binary logarithm of HALF_SUB_BUCKETS. */
+#define HALF_SUB_BUCKETS_BITS (PCUT_HISTOGRAM_SUB_BUCKETS_BITS - 1)
+
+/** Size of the buffer for one formatted part of the JSON line. */
+#define HISTOGRAM_ITEM_SIZE 512
+
+/** File where histograms are exported (NULL when not exporting). */
+static const char *json_filename = NULL;
+
+/** Buffer for composing the JSON line. */
+static char json_buffer[PCUT_HISTOGRAM_JSON_SIZE];
+
+/** Find bucket for given value.
+ *
+ * @param value The value.
+ * @return Bucket index.
+ */
+static int get_bucket_index(unsigned long long value) {
+	int shift = 0;
+
+	if (value < PCUT_HISTOGRAM_SUB_BUCKETS) {
+		return (int) value;
+	}
+
+	while ((value >> shift) >= PCUT_HISTOGRAM_SUB_BUCKETS) {
+		shift++;
+	}
+	return PCUT_HISTOGRAM_SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS
+		+ (int) ((value >> shift) - HALF_SUB_BUCKETS);
+}
+
+/** Get the lowest value that falls into a bucket.
+ *
+ * @param index Bucket index.
+ * @return Lowest value of the bucket.
+ */
+static unsigned long long get_bucket_low(int index) {
+	int shift;
+
+	if (index < PCUT_HISTOGRAM_SUB_BUCKETS) {
+		return (unsigned long long) index;
+	}
+	index -= PCUT_HISTOGRAM_SUB_BUCKETS;
+	shift = index / HALF_SUB_BUCKETS + 1;
+	return ((unsigned long long) (HALF_SUB_BUCKETS + index % HALF_SUB_BUCKETS)) << shift;
+}
+
+/** Get the highest value that falls into a bucket.
+ *
+ * @param index Bucket index.
+ * @return Highest value of the bucket.
+ */
+static unsigned long long get_bucket_high(int index) {
+	int shift;
+
+	if (index < PCUT_HISTOGRAM_SUB_BUCKETS) {
+		return (unsigned long long) index;
+	}
+	shift = (index - PCUT_HISTOGRAM_SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+	return get_bucket_low(index) + ((1ULL << shift) - 1);
+}
+
+/** Remove all values from a histogram.
+ *
+ * @param histogram Histogram to clear.
+ */
+void pcut_histogram_clear(pcut_histogram_t *histogram) {
+	int i;
+
+	for (i = 0; i < PCUT_HISTOGRAM_BUCKETS; i++) {
+		histogram->counts[i] = 0;
+	}
+	histogram->total = 0;
+	histogram->min = 0;
+	histogram->max = 0;
+}
+
+/** Add value to a histogram.
+ *
+ * @param histogram Histogram to update.
+ * @param value Value to add.
+ */
+void pcut_histogram_add(pcut_histogram_t *histogram, unsigned long long value) {
+	if ((histogram->total == 0) || (value < histogram->min)) {
+		histogram->min = value;
+	}
+	if (value > histogram->max) {
+		histogram->max = value;
+	}
+	histogram->counts[get_bucket_index(value)]++;
+	histogram->total++;
+}
+
+/** Get value at given percentile.
+ *
+ * @param histogram The histogram.
+ * @param percentile Percentile (e.g. 99.9).
+ * @return Value such that given percentage of values are not above it.
+ * @retval 0 The histogram is empty.
+ */
+unsigned long long pcut_histogram_percentile(const pcut_histogram_t *histogram,
+		double percentile) {
+	unsigned long long rank, seen = 0;
+	int i;
+
+	if ((histogram->total == 0) || (percentile >= 100.0)) {
+		return histogram->max;
+	}
+	if (percentile < 0.0) {
+		percentile = 0.0;
+	}
+
+	rank = (unsigned long long) (percentile / 100.0 * (double) histogram->total);
+	if ((double) rank < percentile / 100.0 * (double) histogram->total) {
+		rank++;
+	}
+	if (rank == 0) {
+		rank = 1;
+	}
+
+	for (i = 0; i < PCUT_HISTOGRAM_BUCKETS; i++) {
+		seen += histogram->counts[i];
+		if (seen >= rank) {
+			unsigned long long high = get_bucket_high(i);
+			return high < histogram->max ? high : histogram->max;
+		}
+	}
+
+	return histogram->max;
+}
+
+/** Set where the histograms are exported.
+ *
+ * @param filename JSON Lines file (NULL to disable export).
+ */
+void pcut_histogram_set_json_file(const char *filename) {
+	json_filename = filename;
+}
+
+/** Prepare the export file before the whole run.
+ *
+ * @return Whether the file could be created.
+ */
+int pcut_histogram_json_start(void) {
+	FILE *output;
+
+	if (json_filename == NULL) {
+		return 1;
+	}
+
+	output = fopen(json_filename, "w");
+	if (output == NULL) {
+		return 0;
+	}
+	fclose(output);
+
+	return 1;
+}
+
+/** Append text to the JSON buffer.
+ *
+ * @param used Number of bytes already used (updated).
+ * @param text Text to append.
+ * @return Whether the text fit into the buffer.
+ */
+static int append_json(int *used, const char *text) {
+	int rc;
+
+	if ((*used < 0) || (*used >= PCUT_HISTOGRAM_JSON_SIZE)) {
+		return 0;
+	}
+	rc = pcut_snprintf(json_buffer + *used, PCUT_HISTOGRAM_JSON_SIZE - *used,
+		"%s", text);
+	if ((rc < 0) || (rc >= PCUT_HISTOGRAM_JSON_SIZE - *used)) {
+		*used = PCUT_HISTOGRAM_JSON_SIZE;
+		return 0;
+	}
+	*used += rc;
+	return 1;
+}
+
+/** Append histogram of the current test to the export file.
+ *
+ * Buckets are exported as [low, high, count] triplets and only
+ * the non-empty ones are included.
+ *
+ * @param histogram Histogram to export.
+ * @param unit Unit of the values.
+ */
+void pcut_histogram_export(const pcut_histogram_t *histogram, const char *unit) {
+	char item[HISTOGRAM_ITEM_SIZE];
+	FILE *output;
+	int used = 0;
+	int first = 1;
+	int i;
+
+	if (json_filename == NULL) {
+		return;
+	}
+
+	pcut_snprintf(item, HISTOGRAM_ITEM_SIZE, "{\"name\": \"%s.%s\", \"unit\": \"%s\"",
+		pcut_get_current_suite()->name, pcut_get_current_test()->name, unit);
+	append_json(&used, item);
+	pcut_snprintf(item, HISTOGRAM_ITEM_SIZE,
+		", \"count\": %llu, \"min\": %llu, \"max\": %llu",
+		histogram->total, histogram->min, histogram->max);
+	append_json(&used, item);
+	pcut_snprintf(item, HISTOGRAM_ITEM_SIZE,
+		", \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"p99.9\": %llu",
+		pcut_histogram_percentile(histogram, 50.0),
+		pcut_histogram_percentile(histogram, 90.0),
+		pcut_histogram_percentile(histogram, 99.0),
+		pcut_histogram_percentile(histogram, 99.9));
+	append_json(&used, item);
+
+	append_json(&used, ", \"buckets\": [");
+	for (i = 0; i < PCUT_HISTOGRAM_BUCKETS; i++) {
+		if (histogram->counts[i] == 0) {
+			continue;
+		}
+		pcut_snprintf(item, HISTOGRAM_ITEM_SIZE, "%s[%llu, %llu, %llu]",
+			first ? "" : ", ", get_bucket_low(i), get_bucket_high(i),
+			histogram->counts[i]);
+		append_json(&used, item);
+		first = 0;
+	}
+	if (!append_json(&used, "]}\n")) {
+		/* Truncated line would not be valid JSON. */
+		return;
+	}
+
+	output = fopen(json_filename, "a");
+	if (output == NULL) {
+		return;
+	}
+	setvbuf(output, NULL, _IONBF, 0);
+	fputs(json_buffer, output);
+	fclose(output);
+}
@@ -37,6 +37,7 @@
 
 #pragma warning(push, 0)
 #include <stdlib.h>
+#include <stdio.h>
 #pragma warning(pop)
 
 
@@ -85,6 +86,343 @@
 
 extern int pcut_run_mode;
 
+/** Whether to measure duration of each test.
+ *
+ * Enabled by any feature that needs timing information (e.g. the
+ * end-of-run summary).
+ */
+extern int pcut_measure_durations;
+
+/** How many slowest tests (and suites) to list in the end-of-run summary.
+ *
+ * Zero means that the summary is not printed at all.
+ */
+extern int pcut_summary_size;
+
+/** Maximum number of slowest items listed in the summary. */
+#define PCUT_SUMMARY_MAX_SIZE 64
+
+/** Default number of slowest items listed in the summary. */
+#define PCUT_SUMMARY_DEFAULT_SIZE 10
+
+/** Size of a buffer for measurement name (including terminating zero). */
+#define PCUT_MEASUREMENT_NAME_SIZE 64
+
+/** Size of a buffer for measurement unit (including terminating zero). */
+#define PCUT_MEASUREMENT_UNIT_SIZE 16
+
+/** Maximum number of measurements attached to a single test. */
+#define PCUT_MEASUREMENT_MAX_COUNT 32
+
+/** Type byte of an error message printed by a forked test. */
+#define PCUT_RECORD_ERROR 'E'
+
+/** Type byte of a measurement printed by a forked test. */
+#define PCUT_RECORD_MEASUREMENT 'M'
+
+/** Single value measured during test execution. */
+typedef struct {
+	/** Name of the measured quantity (e.g. duration). */
+	char name[PCUT_MEASUREMENT_NAME_SIZE];
+	/** Unit of the value (e.g. ns). */
+	char unit[PCUT_MEASUREMENT_UNIT_SIZE];
+	/** The actual value. */
+	double value;
+} pcut_measurement_t;
+
+/** All measurements collected for a single test. */
+typedef struct {
+	/** Number of valid items. */
+	int count;
+	/** The measurements themselves. */
+	pcut_measurement_t items[PCUT_MEASUREMENT_MAX_COUNT];
+} pcut_measurements_t;
+
+void pcut_measurements_clear(pcut_measurements_t *measurements);
+void pcut_measurements_add(pcut_measurements_t *measurements,
+		const char *name, double value, const char *unit);
+const pcut_measurement_t *pcut_measurements_find(
+		const pcut_measurements_t *measurements, const char *name);
+void pcut_record_measurement(const char *name, double value, const char *unit);
+void pcut_print_measurement(const char *name, double value, const char *unit);
+void pcut_format_measurement(char *buffer, size_t size,
+		const pcut_measurement_t *measurement);
+void pcut_format_duration(char *buffer, size_t size, double duration);
+
+/** Minimum duration of a single benchmark sample (in nanoseconds). */
+#define PCUT_BENCHMARK_MIN_SAMPLE_TIME 10000000ULL
+
+/** Minimum number of benchmark samples before stopping early. */
+#define PCUT_BENCHMARK_MIN_SAMPLES 5
+
+/** Maximum number of benchmark samples. */
+#define PCUT_BENCHMARK_MAX_SAMPLES 30
+
+/** Stop sampling after this time even if the interval is still wide (ns). */
+#define PCUT_BENCHMARK_MAX_TIME 1000000000ULL
+
+/** Confidence interval half-width (in % of the mean) that is tight enough. */
+#define PCUT_BENCHMARK_PRECISION 1.0
+
+/** Maximum number of counters declared by a benchmark body. */
+#define PCUT_BENCHMARK_MAX_COUNTERS 8
+
+/** Maximum number of threads of a scalability benchmark. */
+#define PCUT_BENCHMARK_MAX_THREADS 64
+
+/** Number of samples for each thread count (median is used). */
+#define PCUT_BENCHMARK_THREAD_SAMPLES 5
+
+/** Maximum number of input sizes when measuring complexity. */
+#define PCUT_COMPLEXITY_MAX_SIZES 40
+
+/** Minimum number of input sizes needed to fit the complexity. */
+#define PCUT_COMPLEXITY_MIN_SIZES 3
+
+/** Number of timed samples per input size (the fastest one is used). */
+#define PCUT_COMPLEXITY_SAMPLES 3
+
+/** Maximum number of operations timed when measuring latency. */
+#define PCUT_LATENCY_MAX_OPERATIONS 100000
+
+/** Number of untimed operations before measuring latency. */
+#define PCUT_LATENCY_WARMUP_OPERATIONS 16
+
+/** Binary logarithm of PCUT_HISTOGRAM_SUB_BUCKETS. */
+#define PCUT_HISTOGRAM_SUB_BUCKETS_BITS 7
+
+/** Number of linear buckets (determines precision of the histogram). */
+#define PCUT_HISTOGRAM_SUB_BUCKETS (1 << PCUT_HISTOGRAM_SUB_BUCKETS_BITS)
+
+/** Number of buckets covering all 64-bit values. */
+#define PCUT_HISTOGRAM_BUCKETS \
+	(PCUT_HISTOGRAM_SUB_BUCKETS \
+	+ (64 - PCUT_HISTOGRAM_SUB_BUCKETS_BITS) * (PCUT_HISTOGRAM_SUB_BUCKETS / 2))
+
+/** Size of the buffer for one exported histogram. */
+#define PCUT_HISTOGRAM_JSON_SIZE (256 * 1024)
+
+/** Log-linear histogram of non-negative values. */
+typedef struct {
+	/** Number of values in each bucket. */
+	unsigned long long counts[PCUT_HISTOGRAM_BUCKETS];
+	/** Number of values. */
+	unsigned long long total;
+	/** Smallest value. */
+	unsigned long long min;
+	/** Largest value. */
+	unsigned long long max;
+} pcut_histogram_t;
+
+void pcut_histogram_clear(pcut_histogram_t *histogram);
+void pcut_histogram_add(pcut_histogram_t *histogram, unsigned long long value);
+unsigned long long pcut_histogram_percentile(const pcut_histogram_t *histogram,
+		double percentile);
+void pcut_histogram_set_json_file(const char *filename);
+int pcut_histogram_json_start(void);
+void pcut_histogram_export(const pcut_histogram_t *histogram, const char *unit);
+
+/** Last-level cache size assumed when it cannot be detected. */
+#define PCUT_COLD_CACHE_DEFAULT_SIZE (32 * 1024 * 1024)
+
+/** Upper limit on the size of the buffer evicting the caches. */
+#define PCUT_COLD_CACHE_MAX_SIZE (1024 * 1024 * 1024)
+
+/** Stride when sweeping the buffer evicting the caches. */
+#define PCUT_COLD_CACHE_LINE_SIZE 64
+
+/** Number of cold samples (each one is a single iteration). */
+#define PCUT_COLD_CACHE_SAMPLES 10
+
+/** Benchmarks run with warm caches only. */
+#define PCUT_BENCHMARK_CACHE_WARM 0
+
+/** Benchmarks are also measured with caches evicted before each iteration. */
+#define PCUT_BENCHMARK_CACHE_COLD 1
+
+/** As PCUT_BENCHMARK_CACHE_COLD and evicting pages are faulted in again. */
+#define PCUT_BENCHMARK_CACHE_COLD_REFAULT 2
+
+/** Whether benchmarks are measured with cold caches (PCUT_BENCHMARK_CACHE_*). */
+extern int pcut_benchmark_cache;
+
+/** Benchmarks measure wall-clock time. */
+#define PCUT_BENCHMARK_MODE_TIME 0
+
+/** Benchmarks count retired user-space instructions. */
+#define PCUT_BENCHMARK_MODE_INSTRUCTIONS 1
+
+/** How benchmarks are measured (PCUT_BENCHMARK_MODE_*). */
+extern int pcut_benchmark_mode;
+
+/** Number of iterations in the instruction-count mode. */
+extern int pcut_benchmark_iterations;
+
+/** Whether benchmarks are pinned to the quietest processor. */
+extern int pcut_benchmark_pin;
+
+/** Load average (per processor) above which benchmarks are considered noisy. */
+#define PCUT_NOISY_LOAD_RATIO 0.5
+
+/** Default number of iterations in the instruction-count mode. */
+#define PCUT_BENCHMARK_DEFAULT_ITERATIONS 1000
+
+double pcut_square_root(double value);
+
+/** Minimum relative slowdown (in %) of a benchmark that fails it. */
+extern int pcut_baseline_min_effect;
+
+void pcut_baseline_set_files(const char *save, const char *compare);
+int pcut_baseline_start(void);
+void pcut_baseline_process(const char *metric, const double *samples, int count);
+
+/** Whether to report allocation statistics of each test. */
+extern int pcut_alloc_report;
+
+/** Whether to aggregate allocations by their call sites. */
+extern int pcut_alloc_sites;
+
+/** Describe allocation call site.
+ *
+ * @param address Return address of the allocation function.
+ * @param buffer Where to store the description.
+ * @param size Size of @p buffer in bytes.
+ */
+typedef void (*pcut_alloc_site_describer_t)(void *address, char *buffer, size_t size);
+
+void pcut_alloc_register(pcut_alloc_site_describer_t describer);
+void pcut_alloc_hook_allocate(void *block, size_t size, size_t usable, void *caller);
+void pcut_alloc_hook_release(void *block, size_t usable);
+void pcut_alloc_hook_refused(size_t size);
+int pcut_alloc_refused(void);
+void pcut_alloc_begin(void);
+void pcut_alloc_end(void);
+
+/** Do not check for leaks. */
+#define PCUT_LEAK_CHECK_NONE 0
+
+/** Report leaked blocks as measurements. */
+#define PCUT_LEAK_CHECK_REPORT 1
+
+/** Report leaked blocks and fail the test. */
+#define PCUT_LEAK_CHECK_FAIL 2
+
+/** How to check for leaks (PCUT_LEAK_CHECK_*). */
+extern int pcut_leak_check;
+
+void pcut_leaks_begin(void);
+int pcut_leaks_end(char *message, size_t size);
+
+/** Whether to report lock statistics of each test. */
+extern int pcut_lock_report;
+
+/** Describe lock call site.
+ *
+ * @param address Return address of the locking function.
+ * @param buffer Where to store the description.
+ * @param size Size of @p buffer in bytes.
+ */
+typedef void (*pcut_lock_site_describer_t)(void *address, char *buffer, size_t size);
+
+void pcut_lock_register(pcut_lock_site_describer_t describer);
+void pcut_lock_hook_acquired(void *caller, int contended, unsigned long long wait_time);
+void pcut_lock_hook_cond_wait(unsigned long long wait_time);
+void pcut_lock_begin(void);
+void pcut_lock_end(void);
+
+/** Whether to report system calls made by each test. */
+extern int pcut_syscall_report;
+
+/** Number of system call numbers that are counted. */
+#define PCUT_SYSCALL_MAX_NUMBER 1024
+
+/** How many most frequent system calls to report. */
+#define PCUT_SYSCALL_REPORT_COUNT 10
+
+void pcut_syscalls_begin(pcut_item_t *test);
+void pcut_syscalls_end(void);
+int pcut_syscall_budget_exceeded(pcut_item_t *test, char *message, size_t size);
+void pcut_syscalls_check_support(pcut_item_t *items);
+
+/** Maximum number of frames in a stack sampled by the profiler. */
+#define PCUT_PROFILE_MAX_DEPTH 32
+
+/** Number of stack samples stored for a single test. */
+#define PCUT_PROFILE_MAX_SAMPLES 8192
+
+/** Profiler sampling interval (in microseconds of processor time). */
+#define PCUT_PROFILE_INTERVAL_US 1000
+
+/** How many functions with most samples to report. */
+#define PCUT_PROFILE_REPORT_COUNT 5
+
+/** Size of the buffer for folded stacks of one test. */
+#define PCUT_PROFILE_FOLDED_SIZE (1024 * 1024)
+
+/** Size of the buffer for a name of a profiled function. */
+#define PCUT_PROFILE_FUNCTION_NAME_SIZE 256
+
+/** Stack sampled by the profiler. */
+typedef struct {
+	/** Number of valid frames. */
+	int depth;
+	/** Code addresses, the innermost frame first. */
+	void *frames[PCUT_PROFILE_MAX_DEPTH];
+} pcut_profile_sample_t;
+
+/** Whether to profile test bodies. */
+extern int pcut_profile;
+
+void pcut_profile_set_folded_file(const char *filename);
+int pcut_profile_folded_start(void);
+void pcut_profile_begin(void);
+void pcut_profile_end(void);
+
+/** Number of tests to run concurrently. */
+extern int pcut_jobs;
+
+/** Maximum number of tests running concurrently. */
+#define PCUT_MAX_JOBS 32
+
+/** Maximum number of slots in the reorder buffer. */
+#define PCUT_REORDER_MAX_WINDOW (2 * PCUT_MAX_JOBS)
+
+/** Size of a buffer for output of a test in the reorder buffer. */
+#define PCUT_REORDER_OUTPUT_SIZE 8192
+
+/** Size of a buffer for an error message of the launcher. */
+#define PCUT_REORDER_ERROR_SIZE 256
+
+/** Result of a test waiting in the reorder buffer. */
+typedef struct {
+	/** Suite the test belongs to. */
+	pcut_item_t *suite;
+	/** The test. */
+	pcut_item_t *test;
+	/** Whether the test has completed. */
+	int done;
+	/** Outcome of the test. */
+	int outcome;
+	/** Error of the launcher (empty when the test was run). */
+	char error_message[PCUT_REORDER_ERROR_SIZE];
+	/** Unparsed output of the test (zero-padded). */
+	char output[PCUT_REORDER_OUTPUT_SIZE];
+	/** Measurements made by the launcher. */
+	pcut_measurements_t measurements;
+} pcut_reorder_slot_t;
+
+void pcut_reorder_init(int window);
+pcut_reorder_slot_t *pcut_reorder_acquire(pcut_item_t *suite, pcut_item_t *test);
+void pcut_reorder_complete(pcut_reorder_slot_t *slot, int outcome);
+void pcut_reorder_done(void);
+
+/** Number of journal records between synchronizations to disk (0 = never). */
+extern int pcut_journal_sync_interval;
+
+int pcut_journal_open(const char *filename, int resume);
+int pcut_journal_replay(pcut_item_t *suite, pcut_item_t *test,
+		char *output, size_t output_size, pcut_measurements_t *measurements);
+
 
 pcut_item_t *pcut_fix_list_get_real_head(pcut_item_t *last);
 int pcut_count_tests(pcut_item_t *it);
@@ -96,14 +434,55 @@ void pcut_print_tests(pcut_item_t *first);
 int pcut_is_arg_with_number(const char *arg, const char *opt, int *value);
 
 int pcut_run_test_forking(const char *self_path, pcut_item_t *test);
+
+/** Run all tests concurrently (pcut_jobs at a time).
+ *
+ * Results are reported in the same order as when running serially.
+ *
+ * @param self_path Path to the current binary.
+ * @param first First item of the list.
+ * @return Error code.
+ * @retval -1 Concurrent execution is not supported on this platform.
+ */
+int pcut_run_tests_parallel(const char *self_path, pcut_item_t *first);
+
 int pcut_run_test_forked(pcut_item_t *test);
 int pcut_run_test_single(pcut_item_t *test);
 
 int pcut_get_test_timeout(pcut_item_t *test);
+unsigned long pcut_get_test_memory_limit(pcut_item_t *test);
+int pcut_get_test_time_budget(pcut_item_t *test);
+int pcut_is_benchmark(pcut_item_t *test);
+
+/** How many times to run a test body with a time budget. */
+extern int pcut_time_budget_repeats;
+
+/** Default number of runs of a test body with a time budget. */
+#define PCUT_TIME_BUDGET_DEFAULT_REPEATS 5
+
+/** Maximum number of runs of a test body with a time budget. */
+#define PCUT_TIME_BUDGET_MAX_REPEATS 100
 
 void pcut_failed_assertion(const char *message);
+pcut_item_t *pcut_get_current_test(void);
+pcut_item_t *pcut_get_current_suite(void);
 void pcut_print_fail_message(const char *msg);
 
+/** Size of buffer for the name of the frequency governor. */
+#define PCUT_GOVERNOR_NAME_SIZE 32
+
+/** Conditions affecting stability of benchmarks. */
+typedef struct {
+	/** Frequency governor (empty when not known). */
+	char governor[PCUT_GOVERNOR_NAME_SIZE];
+	/** Whether turbo boost is enabled (-1 when not known). */
+	int turbo;
+	/** Load average over the last minute (negative when not known). */
+	double load;
+	/** Number of online processors. */
+	int cpu_count;
+} pcut_cpu_environment_t;
+
 /** Reporting callbacks structure. */
 typedef struct pcut_report_ops pcut_report_ops_t;
 
@@ -121,20 +500,24 @@ struct pcut_report_ops {
 	void (*test_start)(pcut_item_t *);
 	/** Test completed. */
 	void (*test_done)(pcut_item_t *, int, const char *, const char *,
-		const char *);
+		const char *, const pcut_measurements_t *);
+	/** Conditions the benchmarks run in (after init, optional). */
+	void (*environment)(const pcut_cpu_environment_t *);
 };
 
 void pcut_report_register_handler(pcut_report_ops_t *ops);
 
 void pcut_report_init(pcut_item_t *all_items);
+void pcut_report_environment(const pcut_cpu_environment_t *environment);
 void pcut_report_suite_start(pcut_item_t *suite);
 void pcut_report_suite_done(pcut_item_t *suite);
 void pcut_report_test_start(pcut_item_t *test);
 void pcut_report_test_done(pcut_item_t *test, int outcome,
 		const char *error_message, const char *teardown_error_message,
-		const char *extra_output);
+		const char *extra_output, const pcut_measurements_t *measurements);
 void pcut_report_test_done_unparsed(pcut_item_t *test, int outcome,
-		const char *unparsed_output, size_t unparsed_output_size);
+		const char *unparsed_output, size_t unparsed_output_size,
+		pcut_measurements_t *measurements);
 void pcut_report_done(void);
 
 /* OS-dependent functions. */
@@ -151,6 +534,255 @@ void pcut_report_done(void);
  */
 void pcut_hook_before_test(pcut_item_t *test);
 
+/** Prepare the timer behind pcut_timer_now().
+ *
+ * Called once from pcut_main() before any test runs, forked tests
+ * inherit the prepared timer.
+ * Until then pcut_timer_now() falls back to a slower clock.
+ */
+void pcut_timer_init(void);
+
+/** Open a new stream for the terminal connected to stdout.
+ *
+ * The stream stays connected to the terminal even when stdout is
+ * later redirected to a file.
+ *
+ * @return Stream for writing to the terminal.
+ * @retval NULL stdout is not a terminal (or this is not supported).
+ */
+FILE *pcut_open_terminal(void);
+
+/** Write buffered data of a file to the disk.
+ *
+ * @param file File to synchronize.
+ */
+void pcut_sync_file(FILE *file);
+
+/** Whether to count hardware events during test bodies. */
+extern int pcut_perf_counters;
+
+/** Check whether hardware performance counters can be used.
+ *
+ * @return Whether at least one counter can be opened.
+ */
+int pcut_perf_counters_available(void);
+
+/** Start counting hardware events of the current process. */
+void pcut_perf_counters_start(void);
+
+/** Stop counting and record the counts as measurements of the current test.
+ *
+ * Does nothing when the counters are not running.
+ */
+void pcut_perf_counters_stop(void);
+
+/** Open counters of user-space instructions and cycles.
+ *
+ * @return Whether at least the instruction counter is available.
+ */
+int pcut_instruction_counters_open(void);
+
+/** Reset and start the counters opened by pcut_instruction_counters_open(). */
+void pcut_instruction_counters_begin(void);
+
+/** Stop the counters and read them.
+ *
+ * @param instructions Where to store the number of retired instructions.
+ * @param cycles Where to store the number of cycles (0 when not available).
+ */
+void pcut_instruction_counters_end(unsigned long long *instructions,
+		unsigned long long *cycles);
+
+/** Temporarily stop counting instructions (counters stay open). */
+void pcut_instruction_counters_pause(void);
+
+/** Continue counting after pcut_instruction_counters_pause(). */
+void pcut_instruction_counters_resume(void);
+
+/** Close the counters opened by pcut_instruction_counters_open(). */
+void pcut_instruction_counters_close(void);
+
+/** Start counting system calls of the current process.
+ *
+ * Calls made until pcut_syscall_counting_stop() are counted in
+ * @p counts (indexed by the system call number).
+ * Counting can be started again in the same process.
+ *
+ * @param counts Where to count the calls.
+ * @param size Number of items in @p counts.
+ * @return Whether the counting was started.
+ */
+int pcut_syscall_counting_start(unsigned long *counts, int size);
+
+/** Check whether system calls can be counted on this platform.
+ *
+ * Counting can still fail at run-time (e.g. on an old kernel).
+ *
+ * @return Whether pcut_syscall_counting_start() can succeed.
+ */
+int pcut_syscall_counting_available(void);
+
+/** Stop counting started by pcut_syscall_counting_start(). */
+void pcut_syscall_counting_stop(void);
+
+/** Get number of a system call.
+ *
+ * @param name Name of the system call (e.g. write).
+ * @return System call number.
+ * @retval -1 Unknown system call.
+ */
+int pcut_syscall_number(const char *name);
+
+/** Get name of a system call.
+ *
+ * @param number System call number.
+ * @return Name of the system call.
+ * @retval NULL Unknown system call.
+ */
+const char *pcut_syscall_name(int number);
+
+/** Check whether the sampling profiler is supported.
+ *
+ * @return Whether pcut_profiler_start() can succeed.
+ */
+int pcut_profiler_available(void);
+
+/** Start sampling stacks of the current process.
+ *
+ * A timer of consumed processor time interrupts the process
+ * periodically and the interrupted stack is stored into the next
+ * free slot of @p samples (the handler does not allocate).
+ *
+ * @param samples Preallocated storage for the samples.
+ * @param capacity Number of items in @p samples.
+ * @param interval_us Sampling interval in microseconds.
+ * @return Whether the sampling was started.
+ */
+int pcut_profiler_start(pcut_profile_sample_t *samples, int capacity,
+		int interval_us);
+
+/** Stop sampling started by pcut_profiler_start().
+ *
+ * @return Number of taken samples (can be higher than the capacity).
+ */
+int pcut_profiler_stop(void);
+
+/** Get name of the function containing given code address.
+ *
+ * When the symbol is not known, the module name and offset is used.
+ *
+ * @param address Code address.
+ * @param buffer Where to store the name.
+ * @param size Size of @p buffer in bytes.
+ */
+void pcut_describe_function(void *address, char *buffer, size_t size);
+
+/** Get return addresses on the stack of the current thread.
+ *
+ * The stack is unwound by following frame pointers, the innermost
+ * item is the return address into the caller of this function.
+ * Does not allocate (safe to call from the allocator).
+ *
+ * @param frames Where to store the return addresses.
+ * @param max_depth Number of items in @p frames.
+ * @return Number of stored return addresses (zero when not supported).
+ */
+int pcut_backtrace(void **frames, int max_depth);
+
+/** Pin the current process to the processor it is running on.
+ *
+ * @return Whether the process was pinned.
+ */
+int pcut_pin_to_cpu(void);
+
+/** Pin the current process to the quietest processor.
+ *
+ * Isolated processors are preferred, otherwise the processor with
+ * the smallest recent load (including the load of its SMT siblings)
+ * is used.
+ *
+ * @return Index of the processor the process was pinned to.
+ * @retval -1 The process was not pinned.
+ */
+int pcut_pin_to_quiet_cpu(void);
+
+/** Find out conditions affecting stability of benchmarks.
+ *
+ * @param environment Where to store the information.
+ */
+void pcut_get_cpu_environment(pcut_cpu_environment_t *environment);
+
+/** Function executed by each thread started by pcut_run_threads().
+ *
+ * The first argument is the thread index, the second is the argument
+ * given to pcut_run_threads().
+ */
+typedef void (*pcut_thread_func_t)(int, void *);
+
+/** Run a function in several threads started together.
+ *
+ * The threads wait on a barrier until all of them are created
+ * and the function returns when all of them terminated.
+ *
+ * @param count Number of threads (at most PCUT_BENCHMARK_MAX_THREADS).
+ * @param func Function to execute in each thread.
+ * @param arg Argument passed to @p func.
+ * @return Whether all threads were started.
+ */
+int pcut_run_threads(int count, pcut_thread_func_t func, void *arg);
+
+/** Get peak resident set size of the current process.
+ *
+ * @return Peak resident set size in bytes.
+ * @retval 0 Not supported on this platform.
+ */
+unsigned long long pcut_get_peak_rss(void);
+
+/** Limit address space of the current process.
+ *
+ * The limit is relative to the current size of the address space.
+ * It is expected to be called only in a process running a single test.
+ * When the test crashes after the allocator interposer saw a refused
+ * allocation (see pcut_alloc_refused()), the process exits with
+ * PCUT_OUTCOME_MEMORY_LIMIT, other crashes are left as they are.
+ *
+ * @param bytes By how much the address space may grow.
+ * @return Whether the limit was set.
+ */
+int pcut_set_memory_limit(unsigned long bytes);
+
+/** Get size of the last-level processor cache.
+ *
+ * @return Cache size in bytes.
+ * @retval 0 Size is not known.
+ */
+size_t pcut_get_last_level_cache_size(void);
+
+/** Map zero-filled pages outside of the heap.
+ *
+ * @param size Size in bytes.
+ * @return Address of the pages.
+ * @retval NULL Not supported or out of memory.
+ */
+void *pcut_map_pages(size_t size);
+
+/** Drop contents of pages mapped by pcut_map_pages().
+ *
+ * The pages are zero-filled again and each of them is faulted in on
+ * the next access.
+ *
+ * @param pages Address of the pages.
+ * @param size Size in bytes.
+ */
+void pcut_discard_pages(void *pages, size_t size);
+
+/** Command-line arguments that need to be passed to spawned tests.
+ *
+ * Only relevant for platforms where the test is executed as a new
+ * process (and not by fork()-ing the launcher).
+ */
+extern char pcut_child_arguments[];
+
 /** Tell whether two strings start with the same prefix.
  *
  * @param a First string.
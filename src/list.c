@@ -144,7 +144,7 @@ static void detect_skipped_tests(pcut_item_t *first) {
 	for (it = first; it != NULL; it = pcut_get_real_next(it)) {
 		pcut_extra_t *extras;
 
-		if (it->kind != PCUT_KIND_TEST) {
+		if ((it->kind != PCUT_KIND_TEST) && (it->kind != PCUT_KIND_BENCHMARK)) {
 			continue;
 		}
 
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Per-test statistics of lock contention.
+ *
+ * Locking functions are interposed by a separate library (pcutlock)
+ * that the test program has to be linked with.
+ * The interposed functions call the hooks below whenever a lock is
+ * acquired and these update the statistics while the test body is
+ * running.
+ *
+ * Unlike allocations, locks are taken by several threads at once,
+ * thus the hooks update the statistics atomically.
+ * Call sites of contended acquisitions are identified by the return
+ * address of the locking function and aggregated in a small
+ * fixed-size hash table.
+ */
+
+#include "internal.h"
+
+
+/** Number of slots in the table of contended call sites. */
+#define SITE_TABLE_SIZE 256
+
+/** How many most contended call sites to report. */
+#define SITE_REPORT_COUNT 5
+
+#ifdef __GNUC__
+/** Atomically add @p value to @p var. */
+#define ATOMIC_ADD(var, value) ((void) __sync_fetch_and_add(&(var), (value)))
+/** Atomically store @p value to an empty @p slot, evaluate to the previous content. */
+#define ATOMIC_CLAIM(slot, value) __sync_val_compare_and_swap(&(slot), NULL, (value))
+#else
+/* The interposer needs GCC anyway. */
+#define ATOMIC_ADD(var, value) ((void) ((var) += (value)))
+#define ATOMIC_CLAIM(slot, value) ((slot) == NULL ? ((slot) = (value), (void *) NULL) : (slot))
+#endif
+
+/** Contended acquisitions from a single call site. */
+typedef struct {
+	/** Return address of the locking function (NULL for empty slot). */
+	void *address;
+	/** Number of contended acquisitions. */
+	unsigned long count;
+	/** Time spent waiting for the lock (in nanoseconds). */
+	unsigned long long wait_time;
+} lock_site_t;
+
+/** Whether to report lock statistics of each test. */
+int pcut_lock_report = 0;
+
+/** Describes call sites (NULL when the interposer is not linked in). */
+static pcut_lock_site_describer_t site_describer = NULL;
+
+/** Whether the statistics are being collected. */
+static volatile int tracking_active = 0;
+
+/** Number of lock acquisitions in the current test. */
+static unsigned long acquisition_count;
+
+/** Number of acquisitions that had to wait for another thread. */
+static unsigned long contended_count;
+
+/** Time spent waiting for contended locks (in nanoseconds). */
+static unsigned long long contended_wait_time;
+
+/** Number of waits on condition variables. */
+static unsigned long cond_wait_count;
+
+/** Time spent waiting on condition variables (in nanoseconds). */
+static unsigned long long cond_wait_time;
+
+/** Call sites of contended acquisitions. */
+static lock_site_t sites[SITE_TABLE_SIZE];
+
+/** Register the lock interposer.
+ *
+ * @param describer Function that describes lock call sites.
+ */
+void pcut_lock_register(pcut_lock_site_describer_t describer) {
+	site_describer = describer;
+}
+
+/** Add contended acquisition to the table of sites.
+ *
+ * Acquisitions from new sites are dropped when the table is full.
+ *
+ * @param caller Return address of the locking function.
+ * @param wait_time Time spent waiting for the lock.
+ */
+static void site_add(void *caller, unsigned long long wait_time) {
+	unsigned long index = (unsigned long) (((size_t) caller >> 2)
+		* 2654435761UL % SITE_TABLE_SIZE);
+	int probes;
+
+	for (probes = 0; probes < SITE_TABLE_SIZE; probes++) {
+		lock_site_t *site = &sites[index];
+		void *owner = ATOMIC_CLAIM(site->address, caller);
+		if ((owner == NULL) || (owner == caller)) {
+			ATOMIC_ADD(site->count, 1);
+			ATOMIC_ADD(site->wait_time, wait_time);
+			return;
+		}
+		index = (index + 1) % SITE_TABLE_SIZE;
+	}
+}
+
+/** Record acquisition of a lock (hook for the interposer).
+ *
+ * @param caller Return address of the locking function.
+ * @param contended Whether the lock was held by someone else.
+ * @param wait_time Time spent waiting for the lock (in nanoseconds).
+ */
+void pcut_lock_hook_acquired(void *caller, int contended,
+		unsigned long long wait_time) {
+	if (!tracking_active) {
+		return;
+	}
+
+	ATOMIC_ADD(acquisition_count, 1);
+	if (contended) {
+		ATOMIC_ADD(contended_count, 1);
+		ATOMIC_ADD(contended_wait_time, wait_time);
+		site_add(caller, wait_time);
+	}
+}
+
+/** Record a wait on a condition variable (hook for the interposer).
+ *
+ * @param wait_time Time spent waiting (in nanoseconds).
+ */
+void pcut_lock_hook_cond_wait(unsigned long long wait_time) {
+	if (!tracking_active) {
+		return;
+	}
+
+	ATOMIC_ADD(cond_wait_count, 1);
+	ATOMIC_ADD(cond_wait_time, wait_time);
+}
+
+/** Get number of contended lock acquisitions so far in the current test.
+ *
+ * @return Number of contended acquisitions.
+ * @retval -1 Locks are not tracked (the interposer is not linked).
+ */
+long pcut_get_contended_lock_count(void) {
+	if (site_describer == NULL) {
+		return -1;
+	}
+	return (long) contended_count;
+}
+
+/** Start collecting statistics for the current test body. */
+void pcut_lock_begin(void) {
+	int i;
+
+	acquisition_count = 0;
+	contended_count = 0;
+	contended_wait_time = 0;
+	cond_wait_count = 0;
+	cond_wait_time = 0;
+	for (i = 0; i < SITE_TABLE_SIZE; i++) {
+		sites[i].address = NULL;
+		sites[i].count = 0;
+		sites[i].wait_time = 0;
+	}
+
+	tracking_active = (site_describer != NULL);
+}
+
+/** Record the most contended call sites as measurements. */
+static void record_sites(void) {
+	int reported;
+
+	for (reported = 0; reported < SITE_REPORT_COUNT; reported++) {
+		char name[PCUT_MEASUREMENT_NAME_SIZE];
+		char where[PCUT_MEASUREMENT_NAME_SIZE];
+		lock_site_t *best = NULL;
+		int i;
+
+		for (i = 0; i < SITE_TABLE_SIZE; i++) {
+			if ((sites[i].address != NULL) && (sites[i].count > 0)
+					&& ((best == NULL) || (sites[i].count > best->count))) {
+				best = &sites[i];
+			}
+		}
+		if (best == NULL) {
+			break;
+		}
+
+		site_describer(best->address, where, PCUT_MEASUREMENT_NAME_SIZE);
+		pcut_snprintf(name, PCUT_MEASUREMENT_NAME_SIZE, "lock-site:%s", where);
+		pcut_record_measurement(name, (double) best->count, "x");
+		best->count = 0;
+	}
+}
+
+/** Stop collecting statistics and record them as measurements.
+ *
+ * Does nothing when the statistics are not being collected.
+ */
+void pcut_lock_end(void) {
+	if (!tracking_active) {
+		return;
+	}
+	tracking_active = 0;
+
+	if (!pcut_lock_report) {
+		return;
+	}
+
+	pcut_record_measurement("lock-acquisitions", (double) acquisition_count, "x");
+	pcut_record_measurement("lock-contended", (double) contended_count, "x");
+	pcut_record_measurement("lock-wait-time", (double) contended_wait_time, "ns");
+	pcut_record_measurement("cond-waits", (double) cond_wait_count, "x");
+	pcut_record_measurement("cond-wait-time", (double) cond_wait_time, "ns");
+	record_sites();
+}
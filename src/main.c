@@ -44,6 +44,27 @@
 /** Current running mode. */
 int pcut_run_mode = PCUT_RUN_MODE_FORKING;
 
+/** Whether to measure test durations. */
+int pcut_measure_durations = 0;
+
+/** Number of slowest tests in the summary (zero disables it). */
+int pcut_summary_size = 0;
+
+/** Number of tests to run concurrently. */
+int pcut_jobs = 1;
+
+/** Whether to count hardware events during test bodies. */
+int pcut_perf_counters = 0;
+
+/** Maximum length of command-line arguments passed to spawned tests. */
+#define CHILD_ARGUMENTS_SIZE 512
+
+/** Command-line arguments passed to spawned tests. */
+char pcut_child_arguments[CHILD_ARGUMENTS_SIZE];
+
+/** First argument that did not fit into pcut_child_arguments (NULL if none). */
+static const char *child_argument_overflow = NULL;
+
 /** Empty list to bypass special handling for NULL. */
 static pcut_main_extra_t empty_main_extra[] = {
 	PCUT_MAIN_EXTRA_SET_LAST
@@ -70,6 +91,28 @@ int pcut_is_arg_with_number(const char *arg, const char *opt, int *value) {
 }
 
 
+/** Remember argument that shall be passed to spawned tests too.
+ *
+ * An argument that does not fit is not truncated, it is remembered
+ * in child_argument_overflow and the invocation is rejected later.
+ *
+ * @param arg Argument to remember.
+ */
+static void add_child_argument(const char *arg) {
+	int used = pcut_str_size(pcut_child_arguments);
+	int needed = pcut_str_size(arg) + (used > 0 ? 1 : 0);
+
+	if (used + needed >= CHILD_ARGUMENTS_SIZE) {
+		if (child_argument_overflow == NULL) {
+			child_argument_overflow = arg;
+		}
+		return;
+	}
+
+	pcut_snprintf(pcut_child_arguments + used, CHILD_ARGUMENTS_SIZE - used,
+		"%s%s", used > 0 ? " " : "", arg);
+}
+
 /** Find item by its id.
  *
  * @param first List to search.
@@ -88,6 +131,33 @@ static pcut_item_t *pcut_find_by_id(pcut_item_t *first, int id) {
 	return NULL;
 }
 
+/** Buffer for output of a test replayed from the journal. */
+static char replay_output[PCUT_REORDER_OUTPUT_SIZE];
+
+/** Measurements of a test replayed from the journal. */
+static pcut_measurements_t replay_measurements;
+
+/** Report result of a test recorded in the journal.
+ *
+ * @param suite Suite the test belongs to.
+ * @param test The test.
+ * @return Outcome of the recorded test.
+ * @retval -1 The test is not in the journal and needs to be run.
+ */
+static int replay_test(pcut_item_t *suite, pcut_item_t *test) {
+	int outcome = pcut_journal_replay(suite, test, replay_output,
+		PCUT_REORDER_OUTPUT_SIZE, &replay_measurements);
+	if (outcome == -1) {
+		return -1;
+	}
+
+	pcut_report_test_start(test);
+	pcut_report_test_done_unparsed(test, outcome, replay_output,
+		PCUT_REORDER_OUTPUT_SIZE, &replay_measurements);
+
+	return outcome;
+}
+
 /** Run the whole test suite.
  *
  * @param suite Suite to run.
@@ -119,7 +189,10 @@ static int run_suite(pcut_item_t *suite, pcut_item_t **last, const char *prog_pa
 			is_first_test = 0;
 		}
 
-		if (pcut_run_mode == PCUT_RUN_MODE_FORKING) {
+		ret_code_tmp = replay_test(suite, it);
+		if (ret_code_tmp != -1) {
+			/* Result recorded in the journal of an interrupted run. */
+		} else if (pcut_run_mode == PCUT_RUN_MODE_FORKING) {
 			ret_code_tmp = pcut_run_test_forking(prog_path, it);
 		} else {
 			ret_code_tmp = pcut_run_test_single(it);
@@ -181,6 +254,45 @@ static void set_setup_teardown_callbacks(pcut_item_t *first) {
 	}
 }
 
+/** Decide whether benchmarks are run or hidden.
+ *
+ * Benchmarks that shall run are turned into normal tests (their test
+ * function drives the measurement), others are skipped.
+ *
+ * @param first First item of the list.
+ * @param run_benchmarks Whether to run the benchmarks.
+ */
+static void set_benchmarks_kind(pcut_item_t *first, int run_benchmarks) {
+	pcut_item_t *it;
+	for (it = first; it != NULL; it = pcut_get_real_next(it)) {
+		if (it->kind == PCUT_KIND_BENCHMARK) {
+			it->kind = run_benchmarks ? PCUT_KIND_TEST : PCUT_KIND_SKIP;
+		}
+	}
+}
+
+/** Report conditions for benchmarks and warn when they are noisy. */
+static void report_benchmark_environment(void) {
+	pcut_cpu_environment_t environment;
+
+	pcut_get_cpu_environment(&environment);
+	pcut_report_environment(&environment);
+
+	if ((environment.governor[0] != 0)
+			&& !pcut_str_equals(environment.governor, "performance")) {
+		fprintf(stderr, "Warning: CPU frequency governor is %s, benchmarks may be noisy.\n",
+			environment.governor);
+	}
+	if (environment.turbo > 0) {
+		fprintf(stderr, "Warning: turbo boost is enabled, benchmarks may be noisy.\n");
+	}
+	if ((environment.load >= 0.0)
+			&& (environment.load > environment.cpu_count * PCUT_NOISY_LOAD_RATIO)) {
+		fprintf(stderr, "Warning: system load is %.2f on %d CPUs, benchmarks may be noisy.\n",
+			environment.load, environment.cpu_count);
+	}
+}
+
 /** The main function of PCUT.
  *
  * This function is expected to be called as the only function in
@@ -199,6 +311,14 @@ int pcut_main(pcut_item_t *last, int argc, char *argv[]) {
 
 	int run_only_suite = -1;
 	int run_only_test = -1;
+	const char *report_filename = NULL;
+	const char *journal_filename = NULL;
+	int resume = 0;
+	int run_benchmarks = 0;
+	const char *baseline_save_filename = NULL;
+	const char *baseline_filename = NULL;
+	const char *latency_json_filename = NULL;
+	const char *profile_filename = NULL;
 
 	int rc, rc_tmp;
 
@@ -229,6 +349,137 @@ int pcut_main(pcut_item_t *last, int argc, char *argv[]) {
 			if (pcut_str_equals(argv[i], "-x")) {
 				pcut_report_register_handler(&pcut_report_xml);
 			}
+			if (pcut_is_arg_with_number(argv[i], "-j", &pcut_jobs)) {
+				if (pcut_jobs > PCUT_MAX_JOBS) {
+					pcut_jobs = PCUT_MAX_JOBS;
+				}
+				if (pcut_jobs < 1) {
+					pcut_jobs = 1;
+				}
+			}
+			if (pcut_str_equals(argv[i], "--summary")) {
+				pcut_summary_size = PCUT_SUMMARY_DEFAULT_SIZE;
+				pcut_measure_durations = 1;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_is_arg_with_number(argv[i], "--summary=", &pcut_summary_size)) {
+				if (pcut_summary_size > PCUT_SUMMARY_MAX_SIZE) {
+					pcut_summary_size = PCUT_SUMMARY_MAX_SIZE;
+				}
+				if (pcut_summary_size < 0) {
+					pcut_summary_size = 0;
+				}
+				pcut_measure_durations = 1;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_start_equals(argv[i], "--progress=", 11)) {
+				report_filename = argv[i] + 11;
+				pcut_measure_durations = 1;
+			}
+			if (pcut_str_start_equals(argv[i], "--history=", 10)) {
+				pcut_progress_set_history_file(argv[i] + 10);
+				pcut_measure_durations = 1;
+			}
+			if (pcut_str_start_equals(argv[i], "--journal=", 10)) {
+				journal_filename = argv[i] + 10;
+			}
+			pcut_is_arg_with_number(argv[i], "--journal-sync=", &pcut_journal_sync_interval);
+			if (pcut_str_equals(argv[i], "--resume")) {
+				resume = 1;
+			}
+			if (pcut_str_equals(argv[i], "--alloc-stats")) {
+				pcut_alloc_report = 1;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--alloc-sites")) {
+				pcut_alloc_report = 1;
+				pcut_alloc_sites = 1;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--lock-stats")) {
+				pcut_lock_report = 1;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--syscalls")) {
+				pcut_syscall_report = 1;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--leaks")) {
+				pcut_leak_check = PCUT_LEAK_CHECK_REPORT;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--leaks=fail")) {
+				pcut_leak_check = PCUT_LEAK_CHECK_FAIL;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_is_arg_with_number(argv[i], "--budget-repeats=", &pcut_time_budget_repeats)) {
+				if (pcut_time_budget_repeats > PCUT_TIME_BUDGET_MAX_REPEATS) {
+					pcut_time_budget_repeats = PCUT_TIME_BUDGET_MAX_REPEATS;
+				}
+				if (pcut_time_budget_repeats < 1) {
+					pcut_time_budget_repeats = 1;
+				}
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--perf-counters")) {
+				pcut_perf_counters = 1;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--benchmark-mode=time")) {
+				pcut_benchmark_mode = PCUT_BENCHMARK_MODE_TIME;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--benchmark-mode=instructions")) {
+				pcut_benchmark_mode = PCUT_BENCHMARK_MODE_INSTRUCTIONS;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--benchmark-cache=warm")) {
+				pcut_benchmark_cache = PCUT_BENCHMARK_CACHE_WARM;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--benchmark-cache=cold")) {
+				pcut_benchmark_cache = PCUT_BENCHMARK_CACHE_COLD;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--benchmark-cache=cold-refault")) {
+				pcut_benchmark_cache = PCUT_BENCHMARK_CACHE_COLD_REFAULT;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_is_arg_with_number(argv[i], "--benchmark-iterations=", &pcut_benchmark_iterations)) {
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--pin-cpu")) {
+				pcut_benchmark_pin = 1;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--benchmarks")) {
+				run_benchmarks = 1;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_start_equals(argv[i], "--save-baseline=", 16)) {
+				baseline_save_filename = argv[i] + 16;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_start_equals(argv[i], "--baseline=", 11)) {
+				baseline_filename = argv[i] + 11;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_is_arg_with_number(argv[i], "--min-effect=", &pcut_baseline_min_effect)) {
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_start_equals(argv[i], "--latency-json=", 15)) {
+				latency_json_filename = argv[i] + 15;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_equals(argv[i], "--profile")) {
+				pcut_profile = 1;
+				add_child_argument(argv[i]);
+			}
+			if (pcut_str_start_equals(argv[i], "--profile=", 10)) {
+				pcut_profile = 1;
+				profile_filename = argv[i] + 10;
+				add_child_argument(argv[i]);
+			}
 #ifndef PCUT_NO_LONG_JUMP
 			if (pcut_str_equals(argv[i], "-u")) {
 				pcut_run_mode = PCUT_RUN_MODE_SINGLE;
@@ -237,8 +488,58 @@ int pcut_main(pcut_item_t *last, int argc, char *argv[]) {
 		}
 	}
 
+	if (child_argument_overflow != NULL) {
+		printf("Arguments for spawned tests are too long (at %s)!\n",
+			child_argument_overflow);
+		return PCUT_OUTCOME_BAD_INVOCATION;
+	}
+
+	if (report_filename != NULL) {
+		pcut_progress_set_terminal(pcut_open_terminal());
+		if (freopen(report_filename, "w", stdout) == NULL) {
+			fprintf(stderr, "Failed to open %s for writing!\n", report_filename);
+			return PCUT_OUTCOME_BAD_INVOCATION;
+		}
+	}
+
+	if (resume && (journal_filename == NULL)) {
+		printf("--resume requires --journal=FILE!\n");
+		return PCUT_OUTCOME_BAD_INVOCATION;
+	}
+
+	if ((baseline_save_filename != NULL) && (baseline_filename != NULL)
+			&& pcut_str_equals(baseline_save_filename, baseline_filename)) {
+		printf("--save-baseline and --baseline must use different files!\n");
+		return PCUT_OUTCOME_BAD_INVOCATION;
+	}
+	pcut_baseline_set_files(baseline_save_filename, baseline_filename);
+	pcut_histogram_set_json_file(latency_json_filename);
+	pcut_profile_set_folded_file(profile_filename);
+
+	if (pcut_perf_counters && !pcut_perf_counters_available()) {
+		fprintf(stderr, "Hardware performance counters are not available, ignoring --perf-counters.\n");
+		pcut_perf_counters = 0;
+	}
+
+	if (pcut_benchmark_mode == PCUT_BENCHMARK_MODE_INSTRUCTIONS) {
+		int available = pcut_instruction_counters_open();
+		pcut_instruction_counters_close();
+		if (!available) {
+			fprintf(stderr, "Instruction counters are not available, using --benchmark-mode=time.\n");
+			pcut_benchmark_mode = PCUT_BENCHMARK_MODE_TIME;
+		}
+	}
+
+	if (pcut_profile && !pcut_profiler_available()) {
+		fprintf(stderr, "Sampling profiler is not available, ignoring --profile.\n");
+		pcut_profile = 0;
+	}
+
+	pcut_timer_init();
+
 	setvbuf(stdout, NULL, _IONBF, 0);
 	set_setup_teardown_callbacks(items);
+	set_benchmarks_kind(items, run_benchmarks);
 
 	FOR_EACH_MAIN_EXTRA(main_extras, main_extras_it) {
 		if (main_extras_it->type == PCUT_MAIN_EXTRA_INIT_HOOK) {
@@ -289,21 +590,53 @@ int pcut_main(pcut_item_t *last, int argc, char *argv[]) {
 	}
 
 	/* Otherwise, run the whole thing. */
+	if ((journal_filename != NULL) && !pcut_journal_open(journal_filename, resume)) {
+		printf("Failed to open journal %s!\n", journal_filename);
+		return PCUT_OUTCOME_BAD_INVOCATION;
+	}
+
+	if (!pcut_baseline_start()) {
+		printf("Failed to create baseline %s!\n", baseline_save_filename);
+		return PCUT_OUTCOME_BAD_INVOCATION;
+	}
+
+	if (!pcut_histogram_json_start()) {
+		printf("Failed to create %s!\n", latency_json_filename);
+		return PCUT_OUTCOME_BAD_INVOCATION;
+	}
+
+	if (!pcut_profile_folded_start()) {
+		printf("Failed to create %s!\n", profile_filename);
+		return PCUT_OUTCOME_BAD_INVOCATION;
+	}
+
+	pcut_syscalls_check_support(items);
+
 	pcut_report_init(items);
+	if (run_benchmarks) {
+		report_benchmark_environment();
+	}
 
-	rc = PCUT_OUTCOME_PASS;
+	rc = -1;
+	if ((pcut_jobs > 1) && (pcut_run_mode == PCUT_RUN_MODE_FORKING)) {
+		rc = pcut_run_tests_parallel(argv[0], items);
+	}
 
-	it = items;
-	while (it != NULL) {
-		if (it->kind == PCUT_KIND_TESTSUITE) {
-			pcut_item_t *tmp;
-			rc_tmp = run_suite(it, &tmp, argv[0]);
-			if (rc_tmp != PCUT_OUTCOME_PASS) {
-				rc = rc_tmp;
+	if (rc == -1) {
+		rc = PCUT_OUTCOME_PASS;
+
+		it = items;
+		while (it != NULL) {
+			if (it->kind == PCUT_KIND_TESTSUITE) {
+				pcut_item_t *tmp;
+				rc_tmp = run_suite(it, &tmp, argv[0]);
+				if (rc_tmp != PCUT_OUTCOME_PASS) {
+					rc = rc_tmp;
+				}
+				it = tmp;
+			} else {
+				it = pcut_get_real_next(it);
 			}
-			it = tmp;
-		} else {
-			it = pcut_get_real_next(it);
 		}
 	}
 
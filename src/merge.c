@@ -0,0 +1,1061 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Merge several PCUT reports into one.
+ *
+ * Usage: pcutmerge [-x] FILE...
+ *
+ * Inputs can be TAP or XML reports produced by PCUT or journals
+ * written with --journal (the format is detected from the first
+ * character that is not a white-space).
+ * A dash reads the report from standard input.
+ * The merged report is printed as TAP (or as XML with -x) with tests
+ * renumbered and totals recomputed.
+ *
+ * Each input is read only once, from start to end, thus pipes work too.
+ * The merged tests are spooled into a temporary file because the report
+ * header with the total count of tests must be printed first.
+ * Captured output is copied as it is read, never stored as a whole
+ * (journal records are, but they are limited like in --resume).
+ */
+
+#pragma warning(push, 0)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#pragma warning(pop)
+#include <pcut/pcut.h>
+
+
+/** Size of the buffer for a line of TAP or XML report. */
+#define LINE_BUFFER_SIZE 4096
+
+/** Size of buffers for names (and other short values). */
+#define NAME_BUFFER_SIZE 256
+
+/** Maximum length of a journal record (longer records are ignored). */
+#define JOURNAL_LINE_SIZE 65536
+
+/** Format of the input report. */
+typedef enum {
+	FORMAT_TAP,
+	FORMAT_XML,
+	FORMAT_JOURNAL
+} format_t;
+
+/** Test outcome as far as the merged report is concerned. */
+typedef enum {
+	STATUS_PASS,
+	STATUS_FAIL,
+	STATUS_ERROR,
+	STATUS_MEMORY_LIMIT,
+	STATUS_TOO_SLOW
+} status_t;
+
+/** Kind of captured text (TEXT_NONE means the text is dropped). */
+typedef enum {
+	TEXT_NONE,
+	TEXT_ERROR,
+	TEXT_STDIO
+} text_kind_t;
+
+/** Whether to print XML instead of TAP. */
+static int output_xml = 0;
+
+/** Where the merged tests are printed (the report header comes later). */
+static FILE *output;
+
+/** Number of tests printed so far. */
+static int test_counter = 0;
+
+/** Number of failed tests printed so far. */
+static int failed_test_counter = 0;
+
+/** Number of tests in the current suite. */
+static int tests_in_suite = 0;
+
+/** Number of failed tests in the current suite. */
+static int failed_tests_in_suite = 0;
+
+/** Name of the current suite. */
+static char current_suite[NAME_BUFFER_SIZE];
+
+/** Whether a suite was started and not finished yet. */
+static int suite_open = 0;
+
+/** Name of the current test. */
+static char current_test[NAME_BUFFER_SIZE];
+
+/** Whether a test was started and not finished yet. */
+static int test_open = 0;
+
+/** Kind of the captured text being printed. */
+static text_kind_t current_text = TEXT_NONE;
+
+/** Whether the next character of the text starts a new line. */
+static int text_at_line_start = 1;
+
+/** Buffer for a single journal record. */
+static char journal_line[JOURNAL_LINE_SIZE];
+
+/** Copy a name, truncating it to fit NAME_BUFFER_SIZE.
+ *
+ * @param dest Where to store the name.
+ * @param src Start of the name (does not need to be terminated).
+ * @param length Length of the name in bytes.
+ */
+static void copy_name(char *dest, const char *src, size_t length) {
+	if (length > NAME_BUFFER_SIZE - 1) {
+		length = NAME_BUFFER_SIZE - 1;
+	}
+	memcpy(dest, src, length);
+	dest[length] = 0;
+}
+
+/** Check whether a string starts with a given prefix.
+ *
+ * @param str String to check.
+ * @param prefix The prefix.
+ * @return Whether @p str starts with @p prefix.
+ */
+static int starts_with(const char *str, const char *prefix) {
+	return strncmp(str, prefix, strlen(prefix)) == 0;
+}
+
+/* Output of the merged report. */
+
+/** Print string as a value of an XML attribute.
+ *
+ * Special characters are escaped the same way as in the XML report
+ * of PCUT (names of suites, tests and measurements can be arbitrary).
+ *
+ * @param value The value to print.
+ */
+static void emit_escaped_attribute(const char *value) {
+	for (; *value != 0; value++) {
+		switch (*value) {
+		case '&':
+			fprintf(output, "&amp;");
+			break;
+		case '<':
+			fprintf(output, "&lt;");
+			break;
+		case '>':
+			fprintf(output, "&gt;");
+			break;
+		case '"':
+			fprintf(output, "&quot;");
+			break;
+		case '\'':
+			fprintf(output, "&apos;");
+			break;
+		default:
+			fputc(*value, output);
+			break;
+		}
+	}
+}
+
+/** Get status of a test in the XML report.
+ *
+ * Too slow tests are reported as failed like in the XML report of PCUT.
+ *
+ * @param status Outcome of the test.
+ * @return Value of the status attribute.
+ */
+static const char *xml_status_name(status_t status) {
+	switch (status) {
+	case STATUS_PASS:
+		return "pass";
+	case STATUS_FAIL:
+	case STATUS_TOO_SLOW:
+		return "fail";
+	case STATUS_MEMORY_LIMIT:
+		return "memory-limit";
+	default:
+		return "error";
+	}
+}
+
+/** Get suffix of a test line in the TAP report.
+ *
+ * @param status Outcome of the test.
+ * @return Text printed after the test name.
+ */
+static const char *tap_status_suffix(status_t status) {
+	switch (status) {
+	case STATUS_PASS:
+		return "";
+	case STATUS_FAIL:
+		return " failed";
+	case STATUS_MEMORY_LIMIT:
+		return " over memory limit";
+	case STATUS_TOO_SLOW:
+		return " too slow";
+	default:
+		return " aborted";
+	}
+}
+
+/** Get name of the XML element for captured text.
+ *
+ * @param kind Kind of the text.
+ * @return Element name.
+ */
+static const char *text_element_name(text_kind_t kind) {
+	return kind == TEXT_ERROR ? "error-message" : "standard-output";
+}
+
+/** Finish the captured text being printed (if any). */
+static void end_text(void) {
+	if (current_text == TEXT_NONE) {
+		return;
+	}
+	if (output_xml) {
+		if (!text_at_line_start) {
+			fprintf(output, "\n");
+		}
+		fprintf(output, "]]></%s>\n", text_element_name(current_text));
+	} else if (!text_at_line_start) {
+		fprintf(output, "\n");
+	}
+	current_text = TEXT_NONE;
+	text_at_line_start = 1;
+}
+
+/** Print one character of a captured output (error message or stdio).
+ *
+ * Text outside of a test is dropped.
+ *
+ * @param kind Kind of the text.
+ * @param c The character.
+ */
+static void emit_text_char(text_kind_t kind, int c) {
+	if (!test_open) {
+		return;
+	}
+	if (kind != current_text) {
+		end_text();
+		current_text = kind;
+		if (output_xml) {
+			fprintf(output, "\t\t\t<%s><![CDATA[", text_element_name(kind));
+		}
+	}
+	if (text_at_line_start && !output_xml) {
+		fprintf(output, "%s", kind == TEXT_ERROR ? "# error: " : "# stdio: ");
+	}
+	fputc(c, output);
+	text_at_line_start = c == '\n';
+}
+
+/** Print captured output.
+ *
+ * @param kind Kind of the text.
+ * @param text The text.
+ */
+static void emit_text(text_kind_t kind, const char *text) {
+	for (; *text != 0; text++) {
+		emit_text_char(kind, *text);
+	}
+}
+
+/** Finish the current test (if any). */
+static void end_test(void) {
+	if (!test_open) {
+		return;
+	}
+	end_text();
+	if (output_xml) {
+		fprintf(output, "\t\t</testcase><!-- %s -->\n", current_test);
+	}
+	test_open = 0;
+}
+
+/** Finish the current suite (if any) and print its totals. */
+static void end_suite(void) {
+	if (!suite_open) {
+		return;
+	}
+	end_test();
+	if (output_xml) {
+		fprintf(output, "\t</suite><!-- %s: %d / %d -->\n", current_suite,
+			failed_tests_in_suite, tests_in_suite);
+	} else if (failed_tests_in_suite == 0) {
+		fprintf(output, "#> Finished suite %s (passed).\n", current_suite);
+	} else {
+		fprintf(output, "#> Finished suite %s (failed %d of %d).\n",
+			current_suite, failed_tests_in_suite, tests_in_suite);
+	}
+	suite_open = 0;
+}
+
+/** Start a new suite.
+ *
+ * @param name Name of the suite.
+ */
+static void start_suite(const char *name) {
+	end_suite();
+	copy_name(current_suite, name, strlen(name));
+	suite_open = 1;
+	tests_in_suite = 0;
+	failed_tests_in_suite = 0;
+	if (output_xml) {
+		fprintf(output, "\t<suite name=\"");
+		emit_escaped_attribute(current_suite);
+		fprintf(output, "\">\n");
+	} else {
+		fprintf(output, "#> Starting suite %s.\n", current_suite);
+	}
+}
+
+/** Start a new test (in Default suite when no suite is open).
+ *
+ * @param name Name of the test.
+ * @param status Outcome of the test.
+ * @param detail Text printed after the outcome in TAP (e.g. the time budget).
+ */
+static void start_test(const char *name, status_t status, const char *detail) {
+	end_test();
+	if (!suite_open) {
+		start_suite("Default");
+	}
+	copy_name(current_test, name, strlen(name));
+	test_open = 1;
+	test_counter++;
+	tests_in_suite++;
+	if (status != STATUS_PASS) {
+		failed_test_counter++;
+		failed_tests_in_suite++;
+	}
+
+	if (output_xml) {
+		fprintf(output, "\t\t<testcase name=\"");
+		emit_escaped_attribute(current_test);
+		fprintf(output, "\" status=\"%s\">\n", xml_status_name(status));
+	} else {
+		fprintf(output, "%s %d %s%s%s\n", status == STATUS_PASS ? "ok" : "not ok",
+			test_counter, current_test, tap_status_suffix(status), detail);
+	}
+}
+
+/** Print a measurement.
+ *
+ * @param name Name of the measurement.
+ * @param value Already formatted value.
+ * @param unit Unit of the value (can be empty).
+ */
+static void emit_measurement(const char *name, const char *value, const char *unit) {
+	if (!test_open) {
+		return;
+	}
+	end_text();
+	if (output_xml) {
+		fprintf(output, "\t\t\t<measurement name=\"");
+		emit_escaped_attribute(name);
+		fprintf(output, "\" value=\"");
+		emit_escaped_attribute(value);
+		fprintf(output, "\" unit=\"");
+		emit_escaped_attribute(unit);
+		fprintf(output, "\" />\n");
+	} else {
+		fprintf(output, "# measure: %s %s%s%s\n", name, value,
+			unit[0] == 0 ? "" : " ", unit);
+	}
+}
+
+/* Reading of the inputs. */
+
+/** Read a line, only the first LINE_BUFFER_SIZE bytes are stored.
+ *
+ * @param input Input report.
+ * @param buffer Where to store the line (without the newline).
+ * @param complete Set to whether the whole line fitted into the buffer.
+ * @return Whether anything was read.
+ */
+static int read_line(FILE *input, char *buffer, int *complete) {
+	size_t length;
+	if (fgets(buffer, LINE_BUFFER_SIZE, input) == NULL) {
+		return 0;
+	}
+	length = strlen(buffer);
+	*complete = (length > 0) && (buffer[length - 1] == '\n');
+	if (*complete) {
+		buffer[length - 1] = 0;
+		if ((length > 1) && (buffer[length - 2] == '\r')) {
+			buffer[length - 2] = 0;
+		}
+	}
+	return 1;
+}
+
+/** Copy rest of a too long line as text.
+ *
+ * @param input Input report.
+ * @param kind Kind of the text (TEXT_NONE skips the rest of the line).
+ */
+static void copy_rest_of_line(FILE *input, text_kind_t kind) {
+	int c;
+	while (((c = fgetc(input)) != EOF) && (c != '\n')) {
+		if (kind != TEXT_NONE) {
+			emit_text_char(kind, c);
+		}
+	}
+}
+
+/** Print a line of captured output.
+ *
+ * @param input Input report (to copy rest of a too long line).
+ * @param kind Kind of the text.
+ * @param text Start of the line.
+ * @param complete Whether @p text is the whole line.
+ */
+static void emit_text_line(FILE *input, text_kind_t kind, const char *text,
+		int complete) {
+	emit_text(kind, text);
+	if (!complete) {
+		copy_rest_of_line(input, kind);
+	}
+	emit_text_char(kind, '\n');
+}
+
+/** Detect format of a report.
+ *
+ * Leading white-space is consumed and the first other character is
+ * pushed back, thus the input is never rewound.
+ *
+ * @param input Input report.
+ * @return Detected format.
+ */
+static format_t detect_format(FILE *input) {
+	int c;
+
+	do {
+		c = fgetc(input);
+	} while ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n'));
+
+	if (c == EOF) {
+		return FORMAT_TAP;
+	}
+	ungetc(c, input);
+
+	if (c == '<') {
+		return FORMAT_XML;
+	} else if (c == '{') {
+		return FORMAT_JOURNAL;
+	}
+	return FORMAT_TAP;
+}
+
+/** Parse TAP test line (ok 1 name, not ok 2 name failed).
+ *
+ * @param line The line.
+ * @param name Where to store name of the test.
+ * @param status Where to store outcome of the test.
+ * @param detail Where to store text following the outcome.
+ * @return Whether the line describes a test.
+ */
+static int parse_tap_test(const char *line, char *name, status_t *status,
+		char *detail) {
+	const char *name_start;
+	const char *name_end;
+
+	if (starts_with(line, "ok ")) {
+		*status = STATUS_PASS;
+		line += 3;
+	} else if (starts_with(line, "not ok ")) {
+		*status = STATUS_FAIL;
+		line += 7;
+	} else {
+		return 0;
+	}
+
+	name_start = strchr(line, ' ');
+	if (name_start == NULL) {
+		return 0;
+	}
+	name_start++;
+	name_end = strchr(name_start, ' ');
+	detail[0] = 0;
+	if (name_end == NULL) {
+		name_end = name_start + strlen(name_start);
+	} else if (strcmp(name_end, " aborted") == 0) {
+		*status = STATUS_ERROR;
+	} else if (strcmp(name_end, " over memory limit") == 0) {
+		*status = STATUS_MEMORY_LIMIT;
+	} else if (starts_with(name_end, " too slow")) {
+		*status = STATUS_TOO_SLOW;
+		copy_name(detail, name_end + 9, strlen(name_end + 9));
+	}
+	copy_name(name, name_start, name_end - name_start);
+
+	return 1;
+}
+
+/** Print tests from a TAP report.
+ *
+ * @param input Input report.
+ */
+static void merge_tap(FILE *input) {
+	char line[LINE_BUFFER_SIZE];
+	char name[NAME_BUFFER_SIZE];
+	char detail[NAME_BUFFER_SIZE];
+	int complete;
+
+	while (read_line(input, line, &complete)) {
+		status_t status;
+
+		if (starts_with(line, "# error: ")) {
+			emit_text_line(input, TEXT_ERROR, line + 9, complete);
+			continue;
+		}
+		if (starts_with(line, "# stdio: ")) {
+			emit_text_line(input, TEXT_STDIO, line + 9, complete);
+			continue;
+		}
+		if (!complete) {
+			copy_rest_of_line(input, TEXT_NONE);
+		}
+
+		if (starts_with(line, "#> Starting suite ")) {
+			size_t length = strlen(line + 18);
+			if ((length > 0) && (line[18 + length - 1] == '.')) {
+				length--;
+			}
+			copy_name(name, line + 18, length);
+			start_suite(name);
+		} else if (starts_with(line, "#> Finished suite ")) {
+			end_suite();
+		} else if (starts_with(line, "# measure: ")) {
+			char *value = strchr(line + 11, ' ');
+			if (value != NULL) {
+				char *unit;
+				*value = 0;
+				value++;
+				unit = strchr(value, ' ');
+				if (unit != NULL) {
+					*unit = 0;
+					unit++;
+				}
+				emit_measurement(line + 11, value, unit == NULL ? "" : unit);
+			}
+		} else if (parse_tap_test(line, name, &status, detail)) {
+			start_test(name, status, detail);
+		}
+	}
+}
+
+/** Replace XML entities in a string with the characters they stand for.
+ *
+ * @param value The string (modified in place).
+ */
+static void unescape_xml(char *value) {
+	static const char *entities[] = {
+		"&amp;", "&", "&lt;", "<", "&gt;", ">", "&quot;", "\"", "&apos;", "'", NULL
+	};
+	char *write = value;
+	const char *read = value;
+
+	while (*read != 0) {
+		int i;
+		for (i = 0; entities[i] != NULL; i += 2) {
+			if (starts_with(read, entities[i])) {
+				break;
+			}
+		}
+		if (entities[i] != NULL) {
+			*write++ = entities[i + 1][0];
+			read += strlen(entities[i]);
+		} else {
+			*write++ = *read++;
+		}
+	}
+	*write = 0;
+}
+
+/** Extract value of an XML attribute from a line.
+ *
+ * @param line The line.
+ * @param attribute Attribute name.
+ * @param value Where to store the value (with entities replaced).
+ * @return Whether the attribute was found.
+ */
+static int get_xml_attribute(const char *line, const char *attribute, char *value) {
+	char pattern[NAME_BUFFER_SIZE];
+	const char *start;
+	const char *end;
+
+	snprintf(pattern, NAME_BUFFER_SIZE, " %s=\"", attribute);
+	start = strstr(line, pattern);
+	if (start == NULL) {
+		return 0;
+	}
+	start += strlen(pattern);
+	end = strchr(start, '"');
+	if (end == NULL) {
+		return 0;
+	}
+	copy_name(value, start, end - start);
+	unescape_xml(value);
+	return 1;
+}
+
+/** Print tests from an XML report.
+ *
+ * @param input Input report.
+ */
+static void merge_xml(FILE *input) {
+	char line[LINE_BUFFER_SIZE];
+	char name[NAME_BUFFER_SIZE];
+	char value[NAME_BUFFER_SIZE];
+	char unit[NAME_BUFFER_SIZE];
+	text_kind_t inside_text = TEXT_NONE;
+	int inside_summary = 0;
+	int complete;
+
+	while (read_line(input, line, &complete)) {
+		const char *it = line;
+
+		if (inside_text != TEXT_NONE) {
+			if (starts_with(line, "]]></")) {
+				if (!complete) {
+					copy_rest_of_line(input, TEXT_NONE);
+				}
+				inside_text = TEXT_NONE;
+			} else {
+				emit_text_line(input, inside_text, line, complete);
+			}
+			continue;
+		}
+
+		while ((*it == ' ') || (*it == '\t')) {
+			it++;
+		}
+
+		if (starts_with(it, "<error-message><![CDATA[")) {
+			inside_text = TEXT_ERROR;
+			emit_text_line(input, inside_text, it + 24, complete);
+			continue;
+		}
+		if (starts_with(it, "<standard-output><![CDATA[")) {
+			inside_text = TEXT_STDIO;
+			emit_text_line(input, inside_text, it + 26, complete);
+			continue;
+		}
+		if (!complete) {
+			copy_rest_of_line(input, TEXT_NONE);
+		}
+
+		if (inside_summary) {
+			inside_summary = !starts_with(it, "</summary>");
+		} else if (starts_with(it, "<summary")) {
+			inside_summary = 1;
+		} else if (starts_with(it, "<suite ") && get_xml_attribute(it, "name", name)) {
+			start_suite(name);
+		} else if (starts_with(it, "</suite>")) {
+			end_suite();
+		} else if (starts_with(it, "<testcase ") && get_xml_attribute(it, "name", name)) {
+			status_t status = STATUS_ERROR;
+			if (get_xml_attribute(it, "status", value)) {
+				if (strcmp(value, "pass") == 0) {
+					status = STATUS_PASS;
+				} else if (strcmp(value, "fail") == 0) {
+					status = STATUS_FAIL;
+				} else if (strcmp(value, "memory-limit") == 0) {
+					status = STATUS_MEMORY_LIMIT;
+				}
+			}
+			start_test(name, status, "");
+		} else if (starts_with(it, "</testcase>")) {
+			end_test();
+		} else if (starts_with(it, "<measurement ")
+				&& get_xml_attribute(it, "name", name)
+				&& get_xml_attribute(it, "value", value)) {
+			if (!get_xml_attribute(it, "unit", unit)) {
+				unit[0] = 0;
+			}
+			emit_measurement(name, value, unit);
+		}
+	}
+}
+
+/** Read a journal record into journal_line.
+ *
+ * Records that do not fit into the buffer are skipped.
+ *
+ * @param input The journal.
+ * @return Whether anything was read.
+ */
+static int read_journal_line(FILE *input) {
+	size_t length;
+
+	while (fgets(journal_line, JOURNAL_LINE_SIZE, input) != NULL) {
+		length = strlen(journal_line);
+		if ((length > 0) && (journal_line[length - 1] == '\n')) {
+			return 1;
+		}
+		if (length + 1 < JOURNAL_LINE_SIZE) {
+			/* Last line without a newline. */
+			return 1;
+		}
+		copy_rest_of_line(input, TEXT_NONE);
+	}
+
+	return 0;
+}
+
+/** Check that journal_line is a complete record.
+ *
+ * A record interrupted by a crash lacks the closing brace or the newline.
+ *
+ * @return Whether the record is complete.
+ */
+static int is_complete_journal_record(void) {
+	size_t length = strlen(journal_line);
+	int last = EOF;
+	size_t i;
+
+	if ((journal_line[0] != '{') || (length == 0)
+			|| (journal_line[length - 1] != '\n')) {
+		return 0;
+	}
+	for (i = 0; i < length; i++) {
+		char c = journal_line[i];
+		if ((c != ' ') && (c != '\t') && (c != '\r') && (c != '\n')) {
+			last = c;
+		}
+	}
+
+	return last == '}';
+}
+
+/** Get next character of a journal record.
+ *
+ * @param input Position in the record (advanced).
+ * @return The character.
+ * @retval EOF End of the record.
+ */
+static int record_getc(const char **input) {
+	if (**input == 0) {
+		return EOF;
+	}
+	return (unsigned char) *((*input)++);
+}
+
+/** Read JSON string literal (after the opening quote) from the journal.
+ *
+ * When @p kind is not TEXT_NONE, the decoded string is printed as text,
+ * otherwise it is stored into @p buffer (truncated to NAME_BUFFER_SIZE).
+ *
+ * @param input Position in the record.
+ * @param kind Kind of the text.
+ * @param buffer Where to store the string (can be NULL).
+ */
+static void read_json_string(const char **input, text_kind_t kind, char *buffer) {
+	size_t used = 0;
+	int c;
+
+	while (((c = record_getc(input)) != EOF) && (c != '"') && (c != '\n')) {
+		if (c == '\\') {
+			c = record_getc(input);
+			if (c == 'n') {
+				c = '\n';
+			} else if (c == 't') {
+				c = '\t';
+			} else if (c == 'r') {
+				c = '\r';
+			} else if (c == 'u') {
+				char hex[5];
+				int i;
+				for (i = 0; i < 4; i++) {
+					hex[i] = (char) record_getc(input);
+				}
+				hex[4] = 0;
+				c = (int) strtol(hex, NULL, 16);
+			}
+		}
+		if (kind != TEXT_NONE) {
+			emit_text_char(kind, c);
+		} else if ((buffer != NULL) && (used + 1 < NAME_BUFFER_SIZE)) {
+			buffer[used++] = (char) c;
+		}
+	}
+	if (buffer != NULL) {
+		buffer[used] = 0;
+	}
+}
+
+/** Read a JSON number (or any other bare token) from the journal.
+ *
+ * @param input Position in the record.
+ * @param buffer Where to store the token.
+ * @return Character that ended the token.
+ */
+static int read_json_token(const char **input, char *buffer) {
+	size_t used = 0;
+	int c;
+
+	while (((c = record_getc(input)) != EOF) && (c != ',') && (c != '}') && (c != ']')
+			&& (c != '\n')) {
+		if ((c != ' ') && (used + 1 < NAME_BUFFER_SIZE)) {
+			buffer[used++] = (char) c;
+		}
+	}
+	buffer[used] = 0;
+	return c;
+}
+
+/** Skip characters of the journal up to (and including) @p what.
+ *
+ * @param input Position in the record.
+ * @param what Character to stop after.
+ */
+static void skip_until(const char **input, int what) {
+	int c;
+	while (((c = record_getc(input)) != EOF) && (c != what) && (c != '\n')) {
+		/* Skip. */
+	}
+}
+
+/** Read list of measurements ([["name",value,"unit"],...]) from the journal.
+ *
+ * @param input Position in the record.
+ */
+static void read_json_measurements(const char **input) {
+	char name[NAME_BUFFER_SIZE];
+	char value[NAME_BUFFER_SIZE];
+	char unit[NAME_BUFFER_SIZE];
+	int c;
+
+	while (((c = record_getc(input)) != EOF) && (c != ']') && (c != '\n')) {
+		if (c != '[') {
+			continue;
+		}
+		skip_until(input, '"');
+		read_json_string(input, TEXT_NONE, name);
+		skip_until(input, ',');
+		read_json_token(input, value);
+		skip_until(input, '"');
+		read_json_string(input, TEXT_NONE, unit);
+		skip_until(input, ']');
+		emit_measurement(name, value, unit);
+	}
+}
+
+/** Convert outcome stored in the journal (PCUT_OUTCOME_*) to test status.
+ *
+ * @param outcome The outcome.
+ * @return Test status.
+ */
+static status_t journal_outcome_status(int outcome) {
+	switch (outcome) {
+	case PCUT_OUTCOME_PASS:
+		return STATUS_PASS;
+	case PCUT_OUTCOME_FAIL:
+		return STATUS_FAIL;
+	case PCUT_OUTCOME_MEMORY_LIMIT:
+		return STATUS_MEMORY_LIMIT;
+	case PCUT_OUTCOME_TOO_SLOW:
+		return STATUS_TOO_SLOW;
+	default:
+		return STATUS_ERROR;
+	}
+}
+
+/** Print one journal record.
+ *
+ * The record is expected in the order written by PCUT: suite, test and
+ * outcome come before the captured output.
+ *
+ * @param record The record.
+ */
+static void merge_journal_record(const char *record) {
+	const char **input = &record;
+	char key[NAME_BUFFER_SIZE];
+	char name[NAME_BUFFER_SIZE];
+	char value[NAME_BUFFER_SIZE];
+	int test_started = 0;
+	int c;
+
+	name[0] = 0;
+
+	while (((c = record_getc(input)) != EOF) && (c != '\n')) {
+		if (c != '"') {
+			continue;
+		}
+		read_json_string(input, TEXT_NONE, key);
+		do {
+			c = record_getc(input);
+		} while ((c == ' ') || (c == ':'));
+
+		if (strcmp(key, "measurements") == 0) {
+			read_json_measurements(input);
+		} else if (c == '"') {
+			if (strcmp(key, "suite") == 0) {
+				read_json_string(input, TEXT_NONE, value);
+				if (!suite_open || (strcmp(value, current_suite) != 0)) {
+					start_suite(value);
+				}
+			} else if (strcmp(key, "test") == 0) {
+				read_json_string(input, TEXT_NONE, name);
+			} else if (test_started && (strcmp(key, "error") == 0 || strcmp(key, "teardown-error") == 0)) {
+				read_json_string(input, TEXT_ERROR, NULL);
+				end_text();
+			} else if (test_started && (strcmp(key, "output") == 0)) {
+				read_json_string(input, TEXT_STDIO, NULL);
+				end_text();
+			} else {
+				read_json_string(input, TEXT_NONE, NULL);
+			}
+		} else {
+			value[0] = (char) c;
+			value[1] = 0;
+			c = read_json_token(input, value + 1);
+			if (strcmp(key, "outcome") == 0) {
+				start_test(name, journal_outcome_status(atoi(value)), "");
+				test_started = 1;
+			}
+			if (c == '\n') {
+				break;
+			}
+		}
+	}
+	end_test();
+}
+
+/** Print tests from a journal.
+ *
+ * @param input The journal.
+ */
+static void merge_journal(FILE *input) {
+	while (read_journal_line(input)) {
+		if (is_complete_journal_record()) {
+			merge_journal_record(journal_line);
+		}
+	}
+}
+
+/** Copy the spooled tests to standard output.
+ *
+ * @return Whether all the tests were copied.
+ */
+static int copy_spooled_tests(void) {
+	char buffer[LINE_BUFFER_SIZE];
+	size_t size;
+
+	if (fflush(output) != 0) {
+		return 0;
+	}
+	rewind(output);
+	while ((size = fread(buffer, 1, LINE_BUFFER_SIZE, output)) > 0) {
+		if (fwrite(buffer, 1, size, stdout) != size) {
+			return 0;
+		}
+	}
+
+	return !ferror(output);
+}
+
+/** Print usage information.
+ *
+ * @param prog Name of the executable.
+ */
+static void print_usage(const char *prog) {
+	fprintf(stderr, "Usage: %s [-x] FILE...\n", prog);
+	fprintf(stderr, "Merge PCUT reports (TAP, XML or journals) into one.\n");
+	fprintf(stderr, "Use - to read a report from standard input.\n");
+	fprintf(stderr, "  -x  Print XML report instead of TAP.\n");
+}
+
+int main(int argc, char *argv[]) {
+	int first_file = 1;
+	int i;
+
+	if ((argc > 1) && (strcmp(argv[1], "-x") == 0)) {
+		output_xml = 1;
+		first_file = 2;
+	}
+	if (first_file >= argc) {
+		print_usage(argv[0]);
+		return 2;
+	}
+
+	output = tmpfile();
+	if (output == NULL) {
+		fprintf(stderr, "Failed to create temporary file!\n");
+		return 2;
+	}
+
+	for (i = first_file; i < argc; i++) {
+		format_t format;
+		int use_stdin = strcmp(argv[i], "-") == 0;
+		FILE *input = use_stdin ? stdin : fopen(argv[i], "rb");
+		if (input == NULL) {
+			fprintf(stderr, "Failed to open %s!\n", argv[i]);
+			return 2;
+		}
+
+		format = detect_format(input);
+		if (format == FORMAT_TAP) {
+			merge_tap(input);
+		} else if (format == FORMAT_XML) {
+			merge_xml(input);
+		} else {
+			merge_journal(input);
+		}
+		/* Suites of different files are never merged. */
+		end_suite();
+
+		if (!use_stdin) {
+			fclose(input);
+		}
+	}
+
+	if (output_xml) {
+		printf("<?xml version=\"1.0\"?>\n");
+		printf("<report tests-total=\"%d\">\n", test_counter);
+	} else {
+		printf("1..%d\n", test_counter);
+	}
+	if (!copy_spooled_tests()) {
+		fprintf(stderr, "Failed to copy the merged tests!\n");
+		return 2;
+	}
+	fclose(output);
+
+	if (output_xml) {
+		printf("</report>\n");
+	} else if (failed_test_counter == 0) {
+		printf("#> Done: all tests passed.\n");
+	} else {
+		printf("#> Done: %d of %d tests failed.\n", failed_test_counter, test_counter);
+	}
+
+	return failed_test_counter == 0 ? 0 : 1;
+}
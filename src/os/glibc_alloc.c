@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Interposer of the C allocator for tracking heap allocations (glibc).
+ *
+ * Link the test program with this library (pcutalloc) to enable
+ * per-test allocation statistics and PCUT_ASSERT_MAX_ALLOCATIONS().
+ * The functions forward to the glibc allocator and inform the PCUT
+ * runtime about every allocation and release.
+ */
+
+/** We need _GNU_SOURCE because of dladdr(). */
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <malloc.h>
+#include <errno.h>
+#include "../internal.h"
+
+#ifdef __GLIBC__
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void *__libc_valloc(size_t size);
+extern void *__libc_pvalloc(size_t size);
+
+/** Describe allocation call site with symbol name and offset.
+ *
+ * @param address Return address of the allocation function.
+ * @param buffer Where to store the description.
+ * @param size Size of @p buffer in bytes.
+ */
+static void describe_site(void *address, char *buffer, size_t size) {
+	Dl_info info;
+
+	if ((dladdr(address, &info) != 0) && (info.dli_sname != NULL)) {
+		snprintf(buffer, size, "%s+0x%lx", info.dli_sname,
+			(unsigned long) ((char *) address - (char *) info.dli_saddr));
+	} else if ((dladdr(address, &info) != 0) && (info.dli_fname != NULL)) {
+		/* Offset in the binary, usable with addr2line. */
+		const char *basename = strrchr(info.dli_fname, '/');
+		snprintf(buffer, size, "%s+0x%lx",
+			basename == NULL ? info.dli_fname : basename + 1,
+			(unsigned long) ((char *) address - (char *) info.dli_fbase));
+	} else {
+		snprintf(buffer, size, "%p", address);
+	}
+}
+
+/** Register with the PCUT runtime. */
+static void __attribute__((constructor)) register_interposer(void) {
+	pcut_alloc_register(describe_site);
+}
+
+void *malloc(size_t size) {
+	void *result = __libc_malloc(size);
+	if (result != NULL) {
+		pcut_alloc_hook_allocate(result, size, malloc_usable_size(result),
+			__builtin_return_address(0));
+	} else {
+		pcut_alloc_hook_refused(size);
+	}
+	return result;
+}
+
+void *calloc(size_t count, size_t size) {
+	void *result = __libc_calloc(count, size);
+	if (result != NULL) {
+		pcut_alloc_hook_allocate(result, count * size, malloc_usable_size(result),
+			__builtin_return_address(0));
+	} else {
+		pcut_alloc_hook_refused(count * size);
+	}
+	return result;
+}
+
+void *realloc(void *ptr, size_t size) {
+	size_t old_usable = ptr == NULL ? 0 : malloc_usable_size(ptr);
+	void *result = __libc_realloc(ptr, size);
+	if ((result != NULL) || (size == 0)) {
+		if (ptr != NULL) {
+			pcut_alloc_hook_release(ptr, old_usable);
+		}
+	}
+	if (result != NULL) {
+		pcut_alloc_hook_allocate(result, size, malloc_usable_size(result),
+			__builtin_return_address(0));
+	} else {
+		pcut_alloc_hook_refused(size);
+	}
+	return result;
+}
+
+/*
+ * The aligned variants have to be interposed as well, otherwise their
+ * blocks would be released through the interposed free() without
+ * being accounted for.
+ */
+
+void *memalign(size_t alignment, size_t size) {
+	void *result = __libc_memalign(alignment, size);
+	if (result != NULL) {
+		pcut_alloc_hook_allocate(result, size, malloc_usable_size(result),
+			__builtin_return_address(0));
+	} else {
+		pcut_alloc_hook_refused(size);
+	}
+	return result;
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+	void *result = __libc_memalign(alignment, size);
+	if (result != NULL) {
+		pcut_alloc_hook_allocate(result, size, malloc_usable_size(result),
+			__builtin_return_address(0));
+	} else {
+		pcut_alloc_hook_refused(size);
+	}
+	return result;
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) {
+	void *result;
+
+	if ((alignment % sizeof(void *) != 0)
+			|| ((alignment & (alignment - 1)) != 0) || (alignment == 0)) {
+		return EINVAL;
+	}
+
+	result = __libc_memalign(alignment, size);
+	if (result == NULL) {
+		pcut_alloc_hook_refused(size);
+		return ENOMEM;
+	}
+	pcut_alloc_hook_allocate(result, size, malloc_usable_size(result),
+		__builtin_return_address(0));
+	*ptr = result;
+	return 0;
+}
+
+void *valloc(size_t size) {
+	void *result = __libc_valloc(size);
+	if (result != NULL) {
+		pcut_alloc_hook_allocate(result, size, malloc_usable_size(result),
+			__builtin_return_address(0));
+	} else {
+		pcut_alloc_hook_refused(size);
+	}
+	return result;
+}
+
+void *pvalloc(size_t size) {
+	void *result = __libc_pvalloc(size);
+	if (result != NULL) {
+		pcut_alloc_hook_allocate(result, size, malloc_usable_size(result),
+			__builtin_return_address(0));
+	} else {
+		pcut_alloc_hook_refused(size);
+	}
+	return result;
+}
+
+void free(void *ptr) {
+	if (ptr != NULL) {
+		pcut_alloc_hook_release(ptr, malloc_usable_size(ptr));
+	}
+	__libc_free(ptr);
+}
+
+#else
+
+/** Without glibc there is nothing to interpose with. */
+typedef int pcut_alloc_interposer_not_supported_t;
+
+#endif
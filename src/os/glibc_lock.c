@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Interposer of pthread locks for measuring contention (glibc).
+ *
+ * Link the test program with this library (pcutlock) to enable
+ * per-test lock statistics and PCUT_ASSERT_MAX_CONTENDED_LOCKS().
+ * The functions forward to the glibc implementation.
+ * A lock is considered contended when it cannot be taken immediately,
+ * only then the waiting is timed.
+ */
+
+/** We need _GNU_SOURCE because of dladdr() and RTLD_NEXT. */
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include "../internal.h"
+
+#ifdef __GLIBC__
+
+/** Signature of pthread_mutex_lock(). */
+typedef int (*mutex_lock_func_t)(pthread_mutex_t *);
+
+/** Signature of pthread_rwlock_rdlock() and pthread_rwlock_wrlock(). */
+typedef int (*rwlock_lock_func_t)(pthread_rwlock_t *);
+
+/** Signature of pthread_cond_wait(). */
+typedef int (*cond_wait_func_t)(pthread_cond_t *, pthread_mutex_t *);
+
+/** Signature of pthread_cond_timedwait(). */
+typedef int (*cond_timedwait_func_t)(pthread_cond_t *, pthread_mutex_t *,
+	const struct timespec *);
+
+/** Original locking functions. */
+static mutex_lock_func_t real_mutex_lock;
+static rwlock_lock_func_t real_rwlock_rdlock;
+static rwlock_lock_func_t real_rwlock_wrlock;
+static cond_wait_func_t real_cond_wait;
+static cond_timedwait_func_t real_cond_timedwait;
+
+/** Describe lock call site with symbol name and offset.
+ *
+ * @param address Return address of the locking function.
+ * @param buffer Where to store the description.
+ * @param size Size of @p buffer in bytes.
+ */
+static void describe_site(void *address, char *buffer, size_t size) {
+	Dl_info info;
+
+	if ((dladdr(address, &info) != 0) && (info.dli_sname != NULL)) {
+		snprintf(buffer, size, "%s+0x%lx", info.dli_sname,
+			(unsigned long) ((char *) address - (char *) info.dli_saddr));
+	} else if ((dladdr(address, &info) != 0) && (info.dli_fname != NULL)) {
+		/* Offset in the binary, usable with addr2line. */
+		const char *basename = strrchr(info.dli_fname, '/');
+		snprintf(buffer, size, "%s+0x%lx",
+			basename == NULL ? info.dli_fname : basename + 1,
+			(unsigned long) ((char *) address - (char *) info.dli_fbase));
+	} else {
+		snprintf(buffer, size, "%p", address);
+	}
+}
+
+/** Find the original function.
+ *
+ * The result of dlsym() is stored through an object pointer as
+ * ISO C does not allow casting it to a function pointer.
+ *
+ * @param name Name of the function.
+ * @param func Where to store the function pointer.
+ */
+static void resolve_real_function(const char *name, void *func) {
+	*(void **) func = dlsym(RTLD_NEXT, name);
+}
+
+/** Find the original functions.
+ *
+ * Done at start-up before any other thread exists, the function
+ * pointers do not change afterwards.
+ */
+static void resolve_real_functions(void) {
+	resolve_real_function("pthread_mutex_lock", &real_mutex_lock);
+	resolve_real_function("pthread_rwlock_rdlock", &real_rwlock_rdlock);
+	resolve_real_function("pthread_rwlock_wrlock", &real_rwlock_wrlock);
+	resolve_real_function("pthread_cond_wait", &real_cond_wait);
+	resolve_real_function("pthread_cond_timedwait", &real_cond_timedwait);
+}
+
+/** Register with the PCUT runtime. */
+static void __attribute__((constructor)) register_interposer(void) {
+	resolve_real_functions();
+	pcut_lock_register(describe_site);
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex) {
+	unsigned long long start;
+	int rc;
+
+	if (real_mutex_lock == NULL) {
+		resolve_real_functions();
+	}
+
+	/*
+	 * Only a busy mutex is worth waiting for, other errors are final.
+	 * EOWNERDEAD (robust mutex) means the mutex was taken nonetheless.
+	 */
+	rc = pthread_mutex_trylock(mutex);
+	if (rc != EBUSY) {
+		if ((rc == 0) || (rc == EOWNERDEAD)) {
+			pcut_lock_hook_acquired(__builtin_return_address(0), 0, 0);
+		}
+		return rc;
+	}
+
+	start = pcut_timer_now();
+	rc = real_mutex_lock(mutex);
+	if ((rc == 0) || (rc == EOWNERDEAD)) {
+		pcut_lock_hook_acquired(__builtin_return_address(0), 1,
+			pcut_timer_now() - start);
+	}
+	return rc;
+}
+
+/** Take a read-write lock and record the acquisition.
+ *
+ * @param lock The lock.
+ * @param try_lock Non-blocking variant of @p lock_func.
+ * @param lock_func Original blocking function.
+ * @param caller Return address of the interposed function.
+ * @return Error code of @p try_lock or @p lock_func.
+ */
+static int rwlock_lock(pthread_rwlock_t *lock, rwlock_lock_func_t try_lock,
+		rwlock_lock_func_t lock_func, void *caller) {
+	unsigned long long start;
+	int rc;
+
+	/* Only a busy lock is worth waiting for, other errors are final. */
+	rc = try_lock(lock);
+	if (rc != EBUSY) {
+		if (rc == 0) {
+			pcut_lock_hook_acquired(caller, 0, 0);
+		}
+		return rc;
+	}
+
+	start = pcut_timer_now();
+	rc = lock_func(lock);
+	if (rc == 0) {
+		pcut_lock_hook_acquired(caller, 1, pcut_timer_now() - start);
+	}
+	return rc;
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t *lock) {
+	if (real_rwlock_rdlock == NULL) {
+		resolve_real_functions();
+	}
+	return rwlock_lock(lock, pthread_rwlock_tryrdlock, real_rwlock_rdlock,
+		__builtin_return_address(0));
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t *lock) {
+	if (real_rwlock_wrlock == NULL) {
+		resolve_real_functions();
+	}
+	return rwlock_lock(lock, pthread_rwlock_trywrlock, real_rwlock_wrlock,
+		__builtin_return_address(0));
+}
+
+int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex) {
+	unsigned long long start;
+	int rc;
+
+	if (real_cond_wait == NULL) {
+		resolve_real_functions();
+	}
+
+	start = pcut_timer_now();
+	rc = real_cond_wait(cond, mutex);
+	pcut_lock_hook_cond_wait(pcut_timer_now() - start);
+	return rc;
+}
+
+int pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex,
+		const struct timespec *abstime) {
+	unsigned long long start;
+	int rc;
+
+	if (real_cond_timedwait == NULL) {
+		resolve_real_functions();
+	}
+
+	start = pcut_timer_now();
+	rc = real_cond_timedwait(cond, mutex, abstime);
+	pcut_lock_hook_cond_wait(pcut_timer_now() - start);
+	return rc;
+}
+
+#else
+
+/** Without glibc there is nothing to interpose with. */
+typedef int pcut_lock_interposer_not_supported_t;
+
+#endif
@@ -40,6 +40,7 @@
 #include <task.h>
 #include <fibril_synch.h>
 #include <vfs/vfs.h>
+#include <time.h>
 #include "../internal.h"
 
 
@@ -87,6 +88,9 @@ void pcut_str_error(int error, char *buffer, int size) {
 /** Maximum command-line length. */
 #define MAX_COMMAND_LINE_LENGTH 1024
 
+/** Maximum number of arguments passed to the spawned test. */
+#define MAX_CHILD_ARGUMENT_COUNT 16
+
 /** Maximum size of stdout we are able to capture. */
 #define OUTPUT_BUFFER_SIZE 8192
 
@@ -96,6 +100,12 @@ static char error_message_buffer[OUTPUT_BUFFER_SIZE];
 /** Buffer for stdout from the test. */
 static char extra_output_buffer[OUTPUT_BUFFER_SIZE];
 
+/** Measurements of the test. */
+static pcut_measurements_t measurements;
+
+/** Copy of pcut_child_arguments split into individual arguments. */
+static char child_arguments_buffer[MAX_COMMAND_LINE_LENGTH];
+
 /** Prepare for a new test.
  *
  * @param test Test that is about to be run.
@@ -161,18 +171,37 @@ int pcut_run_test_forking(const char *self_path, pcut_item_t *test) {
 	int tempfile;
 	errno_t rc = vfs_lookup_open(tempfile_name, WALK_REGULAR | WALK_MAY_CREATE, MODE_READ | MODE_WRITE, &tempfile);
 	if (rc != EOK) {
-		pcut_report_test_done(test, PCUT_OUTCOME_INTERNAL_ERROR, "Failed to create temporary file.", NULL, NULL);
+		pcut_report_test_done(test, PCUT_OUTCOME_INTERNAL_ERROR, "Failed to create temporary file.", NULL, NULL, NULL);
 		return PCUT_OUTCOME_INTERNAL_ERROR;
 	}
 
 	char test_number_argument[MAX_TEST_NUMBER_WIDTH];
 	snprintf(test_number_argument, MAX_TEST_NUMBER_WIDTH, "-t%d", test->id);
 
-	const char *const arguments[3] = {
-		self_path,
-		test_number_argument,
-		NULL
-	};
+	const char *arguments[MAX_CHILD_ARGUMENT_COUNT + 3];
+	int argument_count = 0;
+	arguments[argument_count++] = self_path;
+
+	str_cpy(child_arguments_buffer, MAX_COMMAND_LINE_LENGTH, pcut_child_arguments);
+	char *child_argument = child_arguments_buffer;
+	while ((*child_argument != 0) && (argument_count <= MAX_CHILD_ARGUMENT_COUNT)) {
+		arguments[argument_count++] = child_argument;
+		char *separator = str_chr(child_argument, ' ');
+		if (separator == NULL) {
+			break;
+		}
+		*separator = 0;
+		child_argument = separator + 1;
+	}
+
+	arguments[argument_count++] = test_number_argument;
+	arguments[argument_count] = NULL;
+
+	pcut_measurements_clear(&measurements);
+	unsigned long long start_time = 0;
+	if (pcut_measure_durations) {
+		start_time = pcut_timer_now();
+	}
 
 	int status = PCUT_OUTCOME_PASS;
 
@@ -203,6 +232,10 @@ int pcut_run_test_forking(const char *self_path, pcut_item_t *test) {
 	}
 	if (task_exit == TASK_EXIT_UNEXPECTED) {
 		status = PCUT_OUTCOME_INTERNAL_ERROR;
+	} else if ((task_retval == PCUT_OUTCOME_MEMORY_LIMIT)
+			|| (task_retval == PCUT_OUTCOME_TOO_SLOW)) {
+		/* Outcomes decided by the test task itself. */
+		status = task_retval;
 	} else {
 		status = task_retval == 0 ? PCUT_OUTCOME_PASS : PCUT_OUTCOME_FAIL;
 	}
@@ -212,6 +245,11 @@ int pcut_run_test_forking(const char *self_path, pcut_item_t *test) {
 	fibril_condvar_signal(&forced_termination_cv);
 	fibril_mutex_unlock(&forced_termination_mutex);
 
+	if (pcut_measure_durations) {
+		pcut_measurements_add(&measurements, "duration",
+			(double) (pcut_timer_now() - start_time), "ns");
+	}
+
 	aoff64_t pos = 0;
 	size_t nread;
 	vfs_read(tempfile, &pos, extra_output_buffer, OUTPUT_BUFFER_SIZE, &nread);
@@ -220,13 +258,179 @@ leave_close_tempfile:
 	vfs_put(tempfile);
 	vfs_unlink_path(tempfile_name);
 
-	pcut_report_test_done_unparsed(test, status, extra_output_buffer, OUTPUT_BUFFER_SIZE);
+	pcut_report_test_done_unparsed(test, status, extra_output_buffer, OUTPUT_BUFFER_SIZE,
+		&measurements);
 
 	return status;
 }
 
+int pcut_run_tests_parallel(const char *self_path, pcut_item_t *first) {
+	PCUT_UNUSED(self_path);
+	PCUT_UNUSED(first);
+
+	/* Not supported, tests are run one by one. */
+	return -1;
+}
+
 void pcut_hook_before_test(pcut_item_t *test) {
 	PCUT_UNUSED(test);
 
 	/* Do nothing. */
 }
+
+void pcut_timer_init(void) {
+	/* Nothing to prepare. */
+}
+
+unsigned long long pcut_timer_now(void) {
+	struct timespec now;
+	getuptime(&now);
+	return (unsigned long long) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+const char *pcut_timer_source(void) {
+	return "getuptime";
+}
+
+void pcut_sync_file(FILE *file) {
+	fflush(file);
+	vfs_sync(fileno(file));
+}
+
+FILE *pcut_open_terminal(void) {
+	/* Progress line is not supported. */
+	return NULL;
+}
+
+int pcut_perf_counters_available(void) {
+	return 0;
+}
+
+void pcut_perf_counters_start(void) {
+	/* Not supported. */
+}
+
+void pcut_perf_counters_stop(void) {
+	/* Not supported. */
+}
+
+int pcut_instruction_counters_open(void) {
+	return 0;
+}
+
+void pcut_instruction_counters_begin(void) {
+	/* Not supported. */
+}
+
+void pcut_instruction_counters_end(unsigned long long *instructions,
+		unsigned long long *cycles) {
+	*instructions = 0;
+	*cycles = 0;
+}
+
+void pcut_instruction_counters_pause(void) {
+	/* Not supported. */
+}
+
+void pcut_instruction_counters_resume(void) {
+	/* Not supported. */
+}
+
+void pcut_instruction_counters_close(void) {
+	/* Not supported. */
+}
+
+int pcut_pin_to_cpu(void) {
+	return 0;
+}
+
+int pcut_pin_to_quiet_cpu(void) {
+	return -1;
+}
+
+void pcut_get_cpu_environment(pcut_cpu_environment_t *environment) {
+	environment->governor[0] = 0;
+	environment->turbo = -1;
+	environment->load = -1.0;
+	environment->cpu_count = 1;
+}
+
+int pcut_run_threads(int count, pcut_thread_func_t func, void *arg) {
+	PCUT_UNUSED(count);
+	PCUT_UNUSED(func);
+	PCUT_UNUSED(arg);
+	return 0;
+}
+
+size_t pcut_get_last_level_cache_size(void) {
+	return 0;
+}
+
+void *pcut_map_pages(size_t size) {
+	PCUT_UNUSED(size);
+	return NULL;
+}
+
+void pcut_discard_pages(void *pages, size_t size) {
+	PCUT_UNUSED(pages);
+	PCUT_UNUSED(size);
+}
+
+int pcut_syscall_counting_available(void) {
+	return 0;
+}
+
+int pcut_syscall_counting_start(unsigned long *counts, int size) {
+	PCUT_UNUSED(counts);
+	PCUT_UNUSED(size);
+	return 0;
+}
+
+void pcut_syscall_counting_stop(void) {
+	/* Not supported. */
+}
+
+int pcut_syscall_number(const char *name) {
+	PCUT_UNUSED(name);
+	return -1;
+}
+
+const char *pcut_syscall_name(int number) {
+	PCUT_UNUSED(number);
+	return NULL;
+}
+
+int pcut_profiler_available(void) {
+	return 0;
+}
+
+int pcut_profiler_start(pcut_profile_sample_t *samples, int capacity,
+		int interval_us) {
+	PCUT_UNUSED(samples);
+	PCUT_UNUSED(capacity);
+	PCUT_UNUSED(interval_us);
+	return 0;
+}
+
+int pcut_profiler_stop(void) {
+	return 0;
+}
+
+void pcut_describe_function(void *address, char *buffer, size_t size) {
+	pcut_snprintf(buffer, size, "%p", address);
+}
+
+int pcut_backtrace(void **frames, int max_depth) {
+	PCUT_UNUSED(frames);
+	PCUT_UNUSED(max_depth);
+	return 0;
+}
+
+unsigned long long pcut_get_peak_rss(void) {
+	return 0;
+}
+
+int pcut_set_memory_limit(unsigned long bytes) {
+	PCUT_UNUSED(bytes);
+	return 0;
+}
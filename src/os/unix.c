@@ -39,6 +39,11 @@
 /** Newer versions of features.h needs _DEFAULT_SOURCE. */
 #define _DEFAULT_SOURCE
 
+#ifdef __linux__
+/** We need _GNU_SOURCE because of sched_setaffinity(). */
+#define _GNU_SOURCE
+#endif
+
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/types.h>
@@ -46,8 +51,41 @@
 #include <errno.h>
 #include <assert.h>
 #include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
 #include <stdio.h>
 #include <string.h>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <linux/seccomp.h>
+#include <linux/filter.h>
+#include <sys/prctl.h>
+#ifdef SECCOMP_USER_NOTIF_FLAG_CONTINUE
+/** System calls are counted with seccomp user notifications. */
+#define SYSCALLS_USE_SECCOMP
+#endif
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+/** Timer can use the time-stamp counter. */
+#define TIMER_USE_TSC
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#if defined(__linux__) && defined(__GLIBC__) \
+	&& (defined(__x86_64__) || defined(__i386__) || defined(__aarch64__))
+/** Profiler walks frame pointers and symbolizes with dladdr(). */
+#define PROFILER_USE_FRAME_POINTERS
+#include <stdint.h>
+#include <ucontext.h>
+#include <dlfcn.h>
+#endif
 #include "../internal.h"
 
 /** Maximum size of stdout we are able to capture. */
@@ -59,6 +97,9 @@ static char error_message_buffer[OUTPUT_BUFFER_SIZE];
 /** Buffer for stdout from the test. */
 static char extra_output_buffer[OUTPUT_BUFFER_SIZE];
 
+/** Measurements of the test. */
+static pcut_measurements_t measurements;
+
 /** Prepare for a new test.
  *
  * @param test Test that is about to be run.
@@ -122,7 +163,10 @@ static size_t read_all(int fd, char *buffer, size_t buffer_size) {
  */
 static int convert_wait_status_to_outcome(int status) {
 	if (WIFEXITED(status)) {
-		if (WEXITSTATUS(status) != 0) {
+		if ((WEXITSTATUS(status) == PCUT_OUTCOME_MEMORY_LIMIT)
+				|| (WEXITSTATUS(status) == PCUT_OUTCOME_TOO_SLOW)) {
+			return WEXITSTATUS(status);
+		} else if (WEXITSTATUS(status) != 0) {
 			return PCUT_OUTCOME_FAIL;
 		} else {
 			return PCUT_OUTCOME_PASS;
@@ -145,24 +189,30 @@ int pcut_run_test_forking(const char *self_path, pcut_item_t *test) {
 	int link_stdout[2], link_stderr[2];
 	int rc, status, outcome;
 	size_t stderr_size;
+	unsigned long long start_time = 0;
 
 	PCUT_UNUSED(self_path);
 
 	before_test_start(test);
 
+	pcut_measurements_clear(&measurements);
+	if (pcut_measure_durations) {
+		start_time = pcut_timer_now();
+	}
+
 
 	rc = pipe(link_stdout);
 	if (rc == -1) {
 		pcut_snprintf(error_message_buffer, OUTPUT_BUFFER_SIZE - 1,
 				"pipe() failed: %s.", strerror(rc));
-		pcut_report_test_done(test, PCUT_OUTCOME_INTERNAL_ERROR, error_message_buffer, NULL, NULL);
+		pcut_report_test_done(test, PCUT_OUTCOME_INTERNAL_ERROR, error_message_buffer, NULL, NULL, NULL);
 		return PCUT_OUTCOME_INTERNAL_ERROR;
 	}
 	rc = pipe(link_stderr);
 	if (rc == -1) {
 		pcut_snprintf(error_message_buffer, OUTPUT_BUFFER_SIZE - 1,
 				"pipe() failed: %s.", strerror(rc));
-		pcut_report_test_done(test, PCUT_OUTCOME_INTERNAL_ERROR, error_message_buffer, NULL, NULL);
+		pcut_report_test_done(test, PCUT_OUTCOME_INTERNAL_ERROR, error_message_buffer, NULL, NULL, NULL);
 		return PCUT_OUTCOME_INTERNAL_ERROR;
 	}
 
@@ -193,11 +243,16 @@ int pcut_run_test_forking(const char *self_path, pcut_item_t *test) {
 	alarm(pcut_get_test_timeout(test));
 
 	stderr_size = read_all(link_stderr[0], extra_output_buffer, OUTPUT_BUFFER_SIZE - 1);
-	read_all(link_stdout[0], extra_output_buffer, OUTPUT_BUFFER_SIZE - 1 - stderr_size);
+	read_all(link_stdout[0], extra_output_buffer + stderr_size, OUTPUT_BUFFER_SIZE - 1 - stderr_size);
 
 	wait(&status);
 	alarm(0);
 
+	if (pcut_measure_durations) {
+		pcut_measurements_add(&measurements, "duration",
+			(double) (pcut_timer_now() - start_time), "ns");
+	}
+
 	outcome = convert_wait_status_to_outcome(status);
 
 	goto leave_close_parent_pipe;
@@ -209,14 +264,2087 @@ leave_close_parent_pipe:
 	close(link_stdout[0]);
 	close(link_stderr[0]);
 
-	pcut_report_test_done_unparsed(test, outcome, extra_output_buffer, OUTPUT_BUFFER_SIZE);
+	pcut_report_test_done_unparsed(test, outcome, extra_output_buffer, OUTPUT_BUFFER_SIZE,
+		&measurements);
+
+	return outcome;
+}
+
+/** Interval for waking up the launcher when running tests concurrently (ms). */
+#define PARALLEL_POLL_INTERVAL 200
+
+/** Test running concurrently with other tests. */
+typedef struct {
+	/** PID of the child (zero when the entry is not used). */
+	pid_t pid;
+	/** Reorder buffer slot for the result. */
+	pcut_reorder_slot_t *slot;
+	/** Read end of the stdout pipe (-1 when closed). */
+	int stdout_fd;
+	/** Read end of the stderr pipe (-1 when closed). */
+	int stderr_fd;
+	/** Captured stdout. */
+	char stdout_buffer[OUTPUT_BUFFER_SIZE];
+	/** Number of bytes in stdout_buffer. */
+	size_t stdout_size;
+	/** Captured stderr. */
+	char stderr_buffer[OUTPUT_BUFFER_SIZE];
+	/** Number of bytes in stderr_buffer. */
+	size_t stderr_size;
+	/** Time when the test was started. */
+	unsigned long long start_time;
+	/** Time when the test shall be killed. */
+	unsigned long long deadline;
+	/** Whether no other test may run at the same time. */
+	int exclusive;
+} running_test_t;
+
+/** Tests running concurrently. */
+static running_test_t running_tests[PCUT_MAX_JOBS];
+
+/** Read available data from a pipe of a running test.
+ *
+ * Data that do not fit into the buffer are dropped so that the
+ * child is never blocked on a full pipe.
+ *
+ * @param fd Pipe to read from, set to -1 when EOF was reached.
+ * @param buffer Buffer to store data into.
+ * @param used Number of bytes already in @p buffer.
+ */
+static void read_available(int *fd, char *buffer, size_t *used) {
+	char discard[512];
+	ssize_t actually_read;
+
+	if (*used < OUTPUT_BUFFER_SIZE - 1) {
+		actually_read = read(*fd, buffer + *used, OUTPUT_BUFFER_SIZE - 1 - *used);
+	} else {
+		actually_read = read(*fd, discard, sizeof(discard));
+	}
+
+	if (actually_read > 0) {
+		if (*used < OUTPUT_BUFFER_SIZE - 1) {
+			*used += actually_read;
+		}
+		return;
+	}
+	if ((actually_read < 0) && (errno == EINTR)) {
+		return;
+	}
+
+	close(*fd);
+	*fd = -1;
+}
+
+/** Copy captured output of a test into its slot.
+ *
+ * The output is combined the same way as by pcut_run_test_forking()
+ * so that the report is identical to the serial one.
+ *
+ * @param test The completed test.
+ */
+static void store_output(running_test_t *test) {
+	char *output = test->slot->output;
+	size_t stderr_size = test->stderr_size;
+	size_t stdout_size = test->stdout_size;
+
+	if (stderr_size > OUTPUT_BUFFER_SIZE - 1) {
+		stderr_size = OUTPUT_BUFFER_SIZE - 1;
+	}
+	if ((stderr_size > 0) && (test->stderr_buffer[stderr_size - 1] == 10)) {
+		stderr_size--;
+	}
+	if (stdout_size > OUTPUT_BUFFER_SIZE - 1 - stderr_size) {
+		stdout_size = OUTPUT_BUFFER_SIZE - 1 - stderr_size;
+	}
+	if ((stdout_size > 0) && (test->stdout_buffer[stdout_size - 1] == 10)) {
+		stdout_size--;
+	}
+
+	memcpy(output, test->stderr_buffer, stderr_size);
+	memcpy(output + stderr_size, test->stdout_buffer, stdout_size);
+}
+
+/** Start a test in a new process.
+ *
+ * @param test Where to store information about the running test.
+ * @param slot Slot for the test result.
+ * @return Whether the test was started.
+ */
+static int start_parallel_test(running_test_t *test, pcut_reorder_slot_t *slot) {
+	int link_stdout[2], link_stderr[2];
+	int timeout;
+
+	test->slot = slot;
+	test->stdout_size = 0;
+	test->stderr_size = 0;
+	test->start_time = pcut_timer_now();
+	timeout = pcut_get_test_timeout(slot->test);
+	test->deadline = test->start_time + (unsigned long long) timeout * 1000000000ULL;
+
+	if (pipe(link_stdout) == -1) {
+		pcut_snprintf(slot->error_message, PCUT_REORDER_ERROR_SIZE,
+			"pipe() failed: %s.", strerror(errno));
+		return 0;
+	}
+	if (pipe(link_stderr) == -1) {
+		pcut_snprintf(slot->error_message, PCUT_REORDER_ERROR_SIZE,
+			"pipe() failed: %s.", strerror(errno));
+		close(link_stdout[0]);
+		close(link_stdout[1]);
+		return 0;
+	}
+
+	test->pid = fork();
+	if (test->pid == (pid_t)-1) {
+		pcut_snprintf(slot->error_message, PCUT_REORDER_ERROR_SIZE,
+			"fork() failed: %s.", strerror(errno));
+		test->pid = 0;
+		close(link_stdout[0]);
+		close(link_stdout[1]);
+		close(link_stderr[0]);
+		close(link_stderr[1]);
+		return 0;
+	}
+
+	if (test->pid == 0) {
+		/* We are the child. */
+		dup2(link_stdout[1], STDOUT_FILENO);
+		close(link_stdout[0]);
+		dup2(link_stderr[1], STDERR_FILENO);
+		close(link_stderr[0]);
+
+		exit(pcut_run_test_forked(slot->test));
+	}
+
+	close(link_stdout[1]);
+	close(link_stderr[1]);
+	test->stdout_fd = link_stdout[0];
+	test->stderr_fd = link_stderr[0];
+
+	return 1;
+}
+
+/** Collect a test whose both pipes were closed.
+ *
+ * @param test The test.
+ * @return Outcome of the test.
+ */
+static int finish_parallel_test(running_test_t *test) {
+	int status;
+	int outcome;
+
+	while (waitpid(test->pid, &status, 0) == -1) {
+		if (errno != EINTR) {
+			status = -1;
+			break;
+		}
+	}
+	test->pid = 0;
+
+	outcome = status == -1 ? PCUT_OUTCOME_INTERNAL_ERROR : convert_wait_status_to_outcome(status);
+
+	if (pcut_measure_durations) {
+		pcut_measurements_add(&test->slot->measurements, "duration",
+			(double) (pcut_timer_now() - test->start_time), "ns");
+	}
+	store_output(test);
+	pcut_reorder_complete(test->slot, outcome);
 
 	return outcome;
 }
 
+/** Get next test that shall be run.
+ *
+ * Only tests inside a suite are run (as in the serial mode).
+ *
+ * @param it Item to start searching from (inclusive).
+ * @param suite Current suite, updated when a suite is passed.
+ * @return Next test.
+ * @retval NULL No more tests.
+ */
+static pcut_item_t *find_next_test(pcut_item_t *it, pcut_item_t **suite) {
+	for (; it != NULL; it = pcut_get_real_next(it)) {
+		if (it->kind == PCUT_KIND_TESTSUITE) {
+			*suite = it;
+		} else if ((it->kind == PCUT_KIND_TEST) && (*suite != NULL)) {
+			return it;
+		}
+	}
+	return NULL;
+}
+
+/** Run all tests concurrently, reporting them in the list order.
+ *
+ * @param self_path Ignored.
+ * @param first First item of the list.
+ * @return Error code.
+ */
+int pcut_run_tests_parallel(const char *self_path, pcut_item_t *first) {
+	struct pollfd fds[2 * PCUT_MAX_JOBS];
+	running_test_t *fd_owners[2 * PCUT_MAX_JOBS];
+	pcut_item_t *suite = NULL;
+	pcut_item_t *next_test;
+	int running_count = 0;
+	int exclusive_running = 0;
+	int ret_code = PCUT_OUTCOME_PASS;
+	int i;
+
+	PCUT_UNUSED(self_path);
+
+	pcut_reorder_init(2 * pcut_jobs);
+	for (i = 0; i < PCUT_MAX_JOBS; i++) {
+		running_tests[i].pid = 0;
+	}
+
+	next_test = find_next_test(pcut_get_real(first), &suite);
+
+	while ((next_test != NULL) || (running_count > 0)) {
+		unsigned long long now;
+		int fd_count = 0;
+		int timeout = PARALLEL_POLL_INTERVAL;
+
+		/* Start new tests while there is a free job and a free slot. */
+		i = 0;
+		while ((i < pcut_jobs) && (next_test != NULL)) {
+			pcut_reorder_slot_t *slot;
+			int outcome;
+			if (running_tests[i].pid != 0) {
+				i++;
+				continue;
+			}
+			/* Benchmarks run alone so that other tests do not disturb them. */
+			if (exclusive_running
+					|| ((running_count > 0) && pcut_is_benchmark(next_test))) {
+				break;
+			}
+			slot = pcut_reorder_acquire(suite, next_test);
+			if (slot == NULL) {
+				break;
+			}
+			next_test = find_next_test(pcut_get_real_next(next_test), &suite);
+
+			/* Tests recorded in the journal do not occupy a job. */
+			outcome = pcut_journal_replay(slot->suite, slot->test, slot->output,
+				PCUT_REORDER_OUTPUT_SIZE, &slot->measurements);
+			if (outcome == -1) {
+				if (start_parallel_test(&running_tests[i], slot)) {
+					running_tests[i].exclusive = pcut_is_benchmark(slot->test);
+					exclusive_running = running_tests[i].exclusive;
+					running_count++;
+					i++;
+					continue;
+				}
+				outcome = PCUT_OUTCOME_INTERNAL_ERROR;
+			}
+
+			pcut_reorder_complete(slot, outcome);
+			if (outcome != PCUT_OUTCOME_PASS) {
+				ret_code = PCUT_OUTCOME_FAIL;
+			}
+		}
+
+		if (running_count == 0) {
+			continue;
+		}
+
+		/* Kill tests that timed-out, wait for output of the others. */
+		now = pcut_timer_now();
+		for (i = 0; i < pcut_jobs; i++) {
+			running_test_t *test = &running_tests[i];
+			if (test->pid == 0) {
+				continue;
+			}
+			if (now >= test->deadline) {
+				kill(test->pid, SIGKILL);
+			} else if ((test->deadline - now) / 1000000 < (unsigned long long) timeout) {
+				timeout = (int) ((test->deadline - now) / 1000000) + 1;
+			}
+			if (test->stderr_fd != -1) {
+				fds[fd_count].fd = test->stderr_fd;
+				fds[fd_count].events = POLLIN;
+				fd_owners[fd_count] = test;
+				fd_count++;
+			}
+			if (test->stdout_fd != -1) {
+				fds[fd_count].fd = test->stdout_fd;
+				fds[fd_count].events = POLLIN;
+				fd_owners[fd_count] = test;
+				fd_count++;
+			}
+		}
+
+		if (poll(fds, fd_count, timeout) > 0) {
+			for (i = 0; i < fd_count; i++) {
+				running_test_t *test = fd_owners[i];
+				if (fds[i].revents == 0) {
+					continue;
+				}
+				if (fds[i].fd == test->stderr_fd) {
+					read_available(&test->stderr_fd, test->stderr_buffer, &test->stderr_size);
+				} else {
+					read_available(&test->stdout_fd, test->stdout_buffer, &test->stdout_size);
+				}
+			}
+		}
+
+		/* Collect tests that closed their output. */
+		for (i = 0; i < pcut_jobs; i++) {
+			running_test_t *test = &running_tests[i];
+			if ((test->pid == 0) || (test->stdout_fd != -1) || (test->stderr_fd != -1)) {
+				continue;
+			}
+			if (finish_parallel_test(test) != PCUT_OUTCOME_PASS) {
+				ret_code = PCUT_OUTCOME_FAIL;
+			}
+			if (test->exclusive) {
+				exclusive_running = 0;
+			}
+			running_count--;
+		}
+	}
+
+	pcut_reorder_done();
+
+	return ret_code;
+}
+
 void pcut_hook_before_test(pcut_item_t *test) {
 	PCUT_UNUSED(test);
 
 	/* Do nothing. */
 }
 
+#ifdef CLOCK_MONOTONIC_RAW
+/** Clock not affected by NTP adjustments. */
+#define TIMER_CLOCK CLOCK_MONOTONIC_RAW
+/** Name of TIMER_CLOCK. */
+#define TIMER_CLOCK_NAME "CLOCK_MONOTONIC_RAW"
+#else
+#define TIMER_CLOCK CLOCK_MONOTONIC
+#define TIMER_CLOCK_NAME "CLOCK_MONOTONIC"
+#endif
+
+/** Read the monotonic clock.
+ *
+ * @return Time in nanoseconds.
+ */
+static unsigned long long read_clock_ns(void) {
+	struct timespec now;
+	clock_gettime(TIMER_CLOCK, &now);
+	return (unsigned long long) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+#ifdef TIMER_USE_TSC
+
+/** How long to compare the time-stamp counter with the clock (in ns). */
+#define TSC_CALIBRATION_TIME 10000000ULL
+
+/** Time-stamp counter not calibrated yet. */
+#define TSC_UNKNOWN 0
+
+/** Time-stamp counter is used. */
+#define TSC_USED 1
+
+/** Time-stamp counter is not usable. */
+#define TSC_UNUSABLE 2
+
+/** State of the time-stamp counter (TSC_*). */
+static int tsc_state = TSC_UNKNOWN;
+
+/** Duration of one tick of the time-stamp counter (in ns). */
+static double tsc_ns_per_tick;
+
+/** Counter value at the end of the calibration. */
+static unsigned long long tsc_base_ticks;
+
+/** Clock value at the end of the calibration. */
+static unsigned long long tsc_base_ns;
+
+/** Tell whether the time-stamp counter runs at constant rate.
+ *
+ * @return Whether the counter is invariant (CPUID 0x80000007, EDX bit 8).
+ */
+static int is_tsc_invariant(void) {
+	unsigned int eax, ebx, ecx, edx;
+
+	if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || (eax < 0x80000007)) {
+		return 0;
+	}
+	if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+		return 0;
+	}
+	return (edx & (1U << 8)) != 0;
+}
+
+/** Decide whether to use the time-stamp counter and calibrate it.
+ *
+ * The calibration busy-waits for TSC_CALIBRATION_TIME, it is thus
+ * done only once in the launcher (see pcut_timer_init()) and never
+ * lazily from pcut_timer_now() that can run in forked tests or in
+ * the interposed locking functions.
+ */
+void pcut_timer_init(void) {
+	unsigned long long start_ns, end_ns, start_ticks, end_ticks;
+
+	if (tsc_state != TSC_UNKNOWN) {
+		return;
+	}
+
+	tsc_state = TSC_UNUSABLE;
+	if (!is_tsc_invariant()) {
+		return;
+	}
+
+	start_ns = read_clock_ns();
+	start_ticks = __rdtsc();
+	do {
+		end_ns = read_clock_ns();
+	} while (end_ns - start_ns < TSC_CALIBRATION_TIME);
+	end_ticks = __rdtsc();
+
+	if (end_ticks <= start_ticks) {
+		return;
+	}
+
+	tsc_ns_per_tick = (double) (end_ns - start_ns) / (double) (end_ticks - start_ticks);
+	tsc_base_ticks = end_ticks;
+	tsc_base_ns = end_ns;
+	tsc_state = TSC_USED;
+}
+
+unsigned long long pcut_timer_now(void) {
+	if (tsc_state == TSC_USED) {
+		/* Signed difference as counters of other processors may lag slightly. */
+		long long ticks = (long long) (__rdtsc() - tsc_base_ticks);
+		return tsc_base_ns + (unsigned long long) (long long) ((double) ticks * tsc_ns_per_tick);
+	}
+	return read_clock_ns();
+}
+
+const char *pcut_timer_source(void) {
+	return tsc_state == TSC_USED ? "tsc" : TIMER_CLOCK_NAME;
+}
+
+#else
+
+void pcut_timer_init(void) {
+	/* Nothing to prepare. */
+}
+
+unsigned long long pcut_timer_now(void) {
+	return read_clock_ns();
+}
+
+const char *pcut_timer_source(void) {
+	return TIMER_CLOCK_NAME;
+}
+
+#endif
+
+void pcut_sync_file(FILE *file) {
+	fflush(file);
+	fsync(fileno(file));
+}
+
+FILE *pcut_open_terminal(void) {
+	int fd;
+	FILE *terminal;
+
+	if (!isatty(STDOUT_FILENO)) {
+		return NULL;
+	}
+
+	fd = dup(STDOUT_FILENO);
+	if (fd < 0) {
+		return NULL;
+	}
+
+	terminal = fdopen(fd, "w");
+	if (terminal == NULL) {
+		close(fd);
+	}
+
+	return terminal;
+}
+
+/** Thread started by pcut_run_threads(). */
+typedef struct {
+	/** The thread. */
+	pthread_t thread;
+	/** Thread index. */
+	int index;
+} benchmark_thread_t;
+
+/** Threads started by pcut_run_threads(). */
+static benchmark_thread_t benchmark_threads[PCUT_BENCHMARK_MAX_THREADS];
+
+/** Function executed by the threads. */
+static pcut_thread_func_t benchmark_threads_func;
+
+/** Argument for benchmark_threads_func. */
+static void *benchmark_threads_arg;
+
+/** Guard for the barrier. */
+static pthread_mutex_t benchmark_threads_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** Signalled when a thread arrives at the barrier or when it is released. */
+static pthread_cond_t benchmark_threads_cv = PTHREAD_COND_INITIALIZER;
+
+/** Number of threads waiting at the barrier. */
+static int benchmark_threads_waiting;
+
+/** Whether the barrier was released. */
+static int benchmark_threads_released;
+
+/** Wait on the barrier and execute the benchmark function.
+ *
+ * @param arg The benchmark_thread_t structure.
+ * @return Always NULL.
+ */
+static void *benchmark_thread_main(void *arg) {
+	benchmark_thread_t *thread = arg;
+
+	pthread_mutex_lock(&benchmark_threads_mutex);
+	benchmark_threads_waiting++;
+	pthread_cond_broadcast(&benchmark_threads_cv);
+	while (!benchmark_threads_released) {
+		pthread_cond_wait(&benchmark_threads_cv, &benchmark_threads_mutex);
+	}
+	pthread_mutex_unlock(&benchmark_threads_mutex);
+
+	benchmark_threads_func(thread->index, benchmark_threads_arg);
+
+	return NULL;
+}
+
+int pcut_run_threads(int count, pcut_thread_func_t func, void *arg) {
+	int started, i;
+
+	benchmark_threads_func = func;
+	benchmark_threads_arg = arg;
+	benchmark_threads_waiting = 0;
+	benchmark_threads_released = 0;
+
+	for (started = 0; started < count; started++) {
+		benchmark_threads[started].index = started;
+		if (pthread_create(&benchmark_threads[started].thread, NULL,
+				benchmark_thread_main, &benchmark_threads[started]) != 0) {
+			break;
+		}
+	}
+
+	/* Release the threads once all of them are waiting. */
+	pthread_mutex_lock(&benchmark_threads_mutex);
+	while (benchmark_threads_waiting < started) {
+		pthread_cond_wait(&benchmark_threads_cv, &benchmark_threads_mutex);
+	}
+	benchmark_threads_released = 1;
+	pthread_cond_broadcast(&benchmark_threads_cv);
+	pthread_mutex_unlock(&benchmark_threads_mutex);
+
+	for (i = 0; i < started; i++) {
+		pthread_join(benchmark_threads[i].thread, NULL);
+	}
+
+	return started == count;
+}
+
+unsigned long long pcut_get_peak_rss(void) {
+	struct rusage usage;
+
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+
+#ifdef __APPLE__
+	return (unsigned long long) usage.ru_maxrss;
+#else
+	return (unsigned long long) usage.ru_maxrss * 1024ULL;
+#endif
+}
+
+/** Read size of one processor cache from sysfs.
+ *
+ * @param index Cache index (directory cpu0/cache/indexN).
+ * @param level Where to store the cache level.
+ * @return Cache size in bytes.
+ * @retval 0 The cache does not exist or it is an instruction cache.
+ */
+static size_t read_cache_size(int index, int *level) {
+	char path[PCUT_MEASUREMENT_NAME_SIZE];
+	char type[PCUT_MEASUREMENT_NAME_SIZE];
+	unsigned long size = 0;
+	char suffix = 0;
+	FILE *file;
+
+	pcut_snprintf(path, PCUT_MEASUREMENT_NAME_SIZE,
+		"/sys/devices/system/cpu/cpu0/cache/index%d/type", index);
+	file = fopen(path, "r");
+	if (file == NULL) {
+		return 0;
+	}
+	if ((fscanf(file, "%63s", type) != 1) || pcut_str_equals(type, "Instruction")) {
+		fclose(file);
+		return 0;
+	}
+	fclose(file);
+
+	pcut_snprintf(path, PCUT_MEASUREMENT_NAME_SIZE,
+		"/sys/devices/system/cpu/cpu0/cache/index%d/level", index);
+	file = fopen(path, "r");
+	if (file == NULL) {
+		return 0;
+	}
+	if (fscanf(file, "%d", level) != 1) {
+		fclose(file);
+		return 0;
+	}
+	fclose(file);
+
+	pcut_snprintf(path, PCUT_MEASUREMENT_NAME_SIZE,
+		"/sys/devices/system/cpu/cpu0/cache/index%d/size", index);
+	file = fopen(path, "r");
+	if (file == NULL) {
+		return 0;
+	}
+	if (fscanf(file, "%lu%c", &size, &suffix) < 1) {
+		size = 0;
+	}
+	fclose(file);
+
+	if (suffix == 'K') {
+		size *= 1024;
+	} else if (suffix == 'M') {
+		size *= 1024 * 1024;
+	}
+	return (size_t) size;
+}
+
+size_t pcut_get_last_level_cache_size(void) {
+	size_t best_size = 0;
+	int best_level = 0;
+	int index;
+
+	for (index = 0; index < 8; index++) {
+		int level = 0;
+		size_t size = read_cache_size(index, &level);
+		if ((size > 0) && (level >= best_level)) {
+			best_level = level;
+			best_size = size;
+		}
+	}
+
+	return best_size;
+}
+
+void *pcut_map_pages(size_t size) {
+	void *pages = mmap(NULL, size, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return pages == MAP_FAILED ? NULL : pages;
+}
+
+void pcut_discard_pages(void *pages, size_t size) {
+	/* Anonymous private pages are zero-filled on the next touch. */
+	madvise(pages, size, MADV_DONTNEED);
+}
+
+/** Size of the message printed when a limited test crashes. */
+#define MEMORY_LIMIT_MESSAGE_SIZE 128
+
+/** Message printed when a limited test crashes (in fail message format). */
+static char memory_limit_message[MEMORY_LIMIT_MESSAGE_SIZE];
+
+/** Length of memory_limit_message. */
+static size_t memory_limit_message_length;
+
+/** Get current size of the address space.
+ *
+ * @return Size in bytes (zero when not known).
+ */
+static unsigned long long get_address_space_size(void) {
+#ifdef __linux__
+	unsigned long long pages = 0;
+	FILE *statm = fopen("/proc/self/statm", "r");
+
+	if (statm == NULL) {
+		return 0;
+	}
+	if (fscanf(statm, "%llu", &pages) != 1) {
+		pages = 0;
+	}
+	fclose(statm);
+
+	return pages * (unsigned long long) sysconf(_SC_PAGESIZE);
+#else
+	return 0;
+#endif
+}
+
+/** Report a crash caused by a refused allocation.
+ *
+ * The crash is attributed to the limit only when the allocator
+ * interposer saw an allocation fail (errno could be stale).
+ * Other crashes are left to the default handler.
+ *
+ * @param sig Signal number.
+ */
+static void report_memory_limit_crash(int sig) {
+	if (pcut_alloc_refused()) {
+		ssize_t written = write(STDOUT_FILENO, memory_limit_message,
+			memory_limit_message_length);
+		PCUT_UNUSED(written);
+		_exit(PCUT_OUTCOME_MEMORY_LIMIT);
+	}
+
+	signal(sig, SIG_DFL);
+	raise(sig);
+}
+
+int pcut_set_memory_limit(unsigned long bytes) {
+	struct rlimit limit;
+	unsigned long long size = get_address_space_size();
+	int length;
+
+	if ((size == 0) || (getrlimit(RLIMIT_AS, &limit) != 0)) {
+		return 0;
+	}
+
+	size += bytes;
+	if ((limit.rlim_max != RLIM_INFINITY) && (size > limit.rlim_max)) {
+		size = limit.rlim_max;
+	}
+	limit.rlim_cur = (rlim_t) size;
+	if (setrlimit(RLIMIT_AS, &limit) != 0) {
+		return 0;
+	}
+
+	/* Prepare the message, handler shall only write it. */
+	length = pcut_snprintf(memory_limit_message + 4, MEMORY_LIMIT_MESSAGE_SIZE - 6,
+		"Memory limit exceeded: allocation refused (limit %lu bytes)", bytes);
+	if (length > MEMORY_LIMIT_MESSAGE_SIZE - 7) {
+		length = MEMORY_LIMIT_MESSAGE_SIZE - 7;
+	}
+	memory_limit_message[0] = 0;
+	memory_limit_message[1] = 0;
+	memory_limit_message[2] = 0;
+	memory_limit_message[3] = PCUT_RECORD_ERROR;
+	memory_limit_message[4 + length] = '\n';
+	memory_limit_message[5 + length] = 0;
+	memory_limit_message_length = length + 6;
+
+	fflush(stdout);
+	signal(SIGSEGV, report_memory_limit_crash);
+	signal(SIGBUS, report_memory_limit_crash);
+	signal(SIGABRT, report_memory_limit_crash);
+
+	return 1;
+}
+
+#ifdef __linux__
+
+/** Hardware event counted during test bodies. */
+typedef struct {
+	/** Measurement name. */
+	const char *name;
+	/** Event type (PERF_TYPE_*). */
+	unsigned int type;
+	/** Event configuration. */
+	unsigned long long config;
+} perf_counter_def_t;
+
+/** Encode cache event for PERF_TYPE_HW_CACHE. */
+#define PERF_CACHE_READ_MISS(cache) \
+	((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) \
+		| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+/** Counted events. */
+static const perf_counter_def_t perf_counter_defs[] = {
+	{ "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+	{ "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+	{ "branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+	{ "l1d-misses", PERF_TYPE_HW_CACHE, PERF_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D) },
+	{ "llc-misses", PERF_TYPE_HW_CACHE, PERF_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL) }
+};
+
+/** Number of counted events. */
+#define PERF_COUNTER_COUNT \
+	((int) (sizeof(perf_counter_defs) / sizeof(perf_counter_defs[0])))
+
+/** File descriptors of opened counters (-1 when not available). */
+static int perf_counter_fds[PERF_COUNTER_COUNT];
+
+/** Whether the counters are running. */
+static int perf_counters_running = 0;
+
+/** Open counter for the current process (user-space only).
+ *
+ * The counter follows the calling thread and any threads (or processes)
+ * it creates afterwards, their counts are added when the counter is read.
+ *
+ * @param def Counter to open.
+ * @return File descriptor of the counter or -1 on failure.
+ */
+static int perf_counter_open(const perf_counter_def_t *def) {
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = def->type;
+	attr.config = def->config;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	/* Count also threads the test body starts. */
+	attr.inherit = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+		| PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+int pcut_perf_counters_available(void) {
+	int i;
+
+	for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+		int fd = perf_counter_open(&perf_counter_defs[i]);
+		if (fd >= 0) {
+			close(fd);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+void pcut_perf_counters_start(void) {
+	int i;
+
+	/* Open all first so that opening is not counted. */
+	for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+		perf_counter_fds[i] = perf_counter_open(&perf_counter_defs[i]);
+	}
+	for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+		if (perf_counter_fds[i] >= 0) {
+			ioctl(perf_counter_fds[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(perf_counter_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+
+	perf_counters_running = 1;
+}
+
+void pcut_perf_counters_stop(void) {
+	unsigned long long values[PERF_COUNTER_COUNT][3];
+	int i;
+
+	if (!perf_counters_running) {
+		return;
+	}
+	perf_counters_running = 0;
+
+	for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+		if (perf_counter_fds[i] >= 0) {
+			ioctl(perf_counter_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+
+	for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+		double value;
+
+		if (perf_counter_fds[i] < 0) {
+			continue;
+		}
+		if (read(perf_counter_fds[i], values[i], sizeof(values[i])) != sizeof(values[i])) {
+			values[i][2] = 0;
+		}
+		close(perf_counter_fds[i]);
+		perf_counter_fds[i] = -1;
+
+		/* The counter never ran (e.g. no such event on this CPU). */
+		if (values[i][2] == 0) {
+			continue;
+		}
+
+		/* Scale when counters were multiplexed. */
+		value = (double) values[i][0];
+		if (values[i][2] < values[i][1]) {
+			value = value * (double) values[i][1] / (double) values[i][2];
+		}
+		pcut_record_measurement(perf_counter_defs[i].name, (double) (unsigned long long) value, "x");
+	}
+}
+
+/** Index of the cycles counter in perf_counter_defs. */
+#define PERF_COUNTER_CYCLES 0
+
+/** Index of the instructions counter in perf_counter_defs. */
+#define PERF_COUNTER_INSTRUCTIONS 1
+
+/** Counters used by instruction-count benchmarks. */
+static int instruction_counter_fds[2] = { -1, -1 };
+
+int pcut_instruction_counters_open(void) {
+	instruction_counter_fds[0] = perf_counter_open(&perf_counter_defs[PERF_COUNTER_INSTRUCTIONS]);
+	instruction_counter_fds[1] = perf_counter_open(&perf_counter_defs[PERF_COUNTER_CYCLES]);
+	return instruction_counter_fds[0] >= 0;
+}
+
+void pcut_instruction_counters_begin(void) {
+	int i;
+	for (i = 0; i < 2; i++) {
+		if (instruction_counter_fds[i] >= 0) {
+			ioctl(instruction_counter_fds[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(instruction_counter_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+void pcut_instruction_counters_end(unsigned long long *instructions,
+		unsigned long long *cycles) {
+	unsigned long long *results[2];
+	int i;
+
+	results[0] = instructions;
+	results[1] = cycles;
+
+	for (i = 0; i < 2; i++) {
+		if (instruction_counter_fds[i] >= 0) {
+			ioctl(instruction_counter_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+	for (i = 0; i < 2; i++) {
+		unsigned long long values[3];
+		*results[i] = 0;
+		if (instruction_counter_fds[i] < 0) {
+			continue;
+		}
+		if (read(instruction_counter_fds[i], values, sizeof(values)) != sizeof(values)) {
+			continue;
+		}
+		*results[i] = values[0];
+	}
+}
+
+/** Enable or disable the instruction counters without resetting them.
+ *
+ * @param request PERF_EVENT_IOC_ENABLE or PERF_EVENT_IOC_DISABLE.
+ */
+static void instruction_counters_control(unsigned long request) {
+	int i;
+	for (i = 0; i < 2; i++) {
+		if (instruction_counter_fds[i] >= 0) {
+			ioctl(instruction_counter_fds[i], request, 0);
+		}
+	}
+}
+
+void pcut_instruction_counters_pause(void) {
+	instruction_counters_control(PERF_EVENT_IOC_DISABLE);
+}
+
+void pcut_instruction_counters_resume(void) {
+	instruction_counters_control(PERF_EVENT_IOC_ENABLE);
+}
+
+void pcut_instruction_counters_close(void) {
+	int i;
+	for (i = 0; i < 2; i++) {
+		if (instruction_counter_fds[i] >= 0) {
+			close(instruction_counter_fds[i]);
+			instruction_counter_fds[i] = -1;
+		}
+	}
+}
+
+int pcut_pin_to_cpu(void) {
+	cpu_set_t set;
+	int cpu = sched_getcpu();
+
+	if (cpu < 0) {
+		return 0;
+	}
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+/** Maximum number of processors considered for pinning. */
+#define PIN_MAX_CPUS 256
+
+/** How long to observe processor load before pinning (in ns). */
+#define PIN_LOAD_SAMPLE_TIME 20000000
+
+/** Size of buffer for lines of /proc/stat and CPU lists. */
+#define PIN_LINE_SIZE 1024
+
+/** Parse a CPU list such as "0-3,8" from a sysfs file.
+ *
+ * @param path File with the list.
+ * @param set Where to add the listed processors.
+ * @return Number of listed processors.
+ */
+static int read_cpu_list(const char *path, cpu_set_t *set) {
+	char line[PIN_LINE_SIZE];
+	char *it = line;
+	int count = 0;
+	FILE *file = fopen(path, "r");
+
+	if (file == NULL) {
+		return 0;
+	}
+	if (fgets(line, PIN_LINE_SIZE, file) == NULL) {
+		fclose(file);
+		return 0;
+	}
+	fclose(file);
+
+	while ((*it >= '0') && (*it <= '9')) {
+		long first = strtol(it, &it, 10);
+		long last = first;
+		long cpu;
+		if (*it == '-') {
+			last = strtol(it + 1, &it, 10);
+		}
+		for (cpu = first; (cpu <= last) && (cpu < PIN_MAX_CPUS); cpu++) {
+			CPU_SET(cpu, set);
+			count++;
+		}
+		if (*it == ',') {
+			it++;
+		}
+	}
+
+	return count;
+}
+
+/** Read busy and total time of each processor from /proc/stat.
+ *
+ * @param busy Where to store busy time of each processor.
+ * @param total Where to store total time of each processor.
+ * @return Whether the times were read.
+ */
+static int read_cpu_times(unsigned long long *busy, unsigned long long *total) {
+	char line[PIN_LINE_SIZE];
+	FILE *file = fopen("/proc/stat", "r");
+
+	if (file == NULL) {
+		return 0;
+	}
+
+	while (fgets(line, PIN_LINE_SIZE, file) != NULL) {
+		unsigned long long values[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		int cpu;
+		int i;
+
+		if ((line[0] != 'c') || (line[1] != 'p') || (line[2] != 'u')
+				|| (line[3] < '0') || (line[3] > '9')) {
+			continue;
+		}
+		if (sscanf(line + 3, "%d %llu %llu %llu %llu %llu %llu %llu %llu", &cpu,
+				&values[0], &values[1], &values[2], &values[3],
+				&values[4], &values[5], &values[6], &values[7]) < 5) {
+			continue;
+		}
+		if ((cpu < 0) || (cpu >= PIN_MAX_CPUS)) {
+			continue;
+		}
+
+		/* Idle and iowait are the fourth and fifth values. */
+		total[cpu] = 0;
+		for (i = 0; i < 8; i++) {
+			total[cpu] += values[i];
+		}
+		busy[cpu] = total[cpu] - values[3] - values[4];
+	}
+
+	fclose(file);
+	return 1;
+}
+
+int pcut_pin_to_quiet_cpu(void) {
+	static unsigned long long busy_before[PIN_MAX_CPUS];
+	static unsigned long long total_before[PIN_MAX_CPUS];
+	static unsigned long long busy_after[PIN_MAX_CPUS];
+	static unsigned long long total_after[PIN_MAX_CPUS];
+	static double load[PIN_MAX_CPUS];
+	cpu_set_t allowed, isolated, set;
+	struct timespec pause;
+	double best_score = 0.0;
+	int best_cpu = -1;
+	int cpu;
+
+	/* Isolated processors are not disturbed by the scheduler. */
+	CPU_ZERO(&isolated);
+	if (read_cpu_list("/sys/devices/system/cpu/isolated", &isolated) > 0) {
+		for (cpu = 0; cpu < PIN_MAX_CPUS; cpu++) {
+			if (!CPU_ISSET(cpu, &isolated)) {
+				continue;
+			}
+			CPU_ZERO(&set);
+			CPU_SET(cpu, &set);
+			if (sched_setaffinity(0, sizeof(set), &set) == 0) {
+				return cpu;
+			}
+		}
+	}
+
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+		return -1;
+	}
+
+	for (cpu = 0; cpu < PIN_MAX_CPUS; cpu++) {
+		total_before[cpu] = total_after[cpu] = 0;
+		busy_before[cpu] = busy_after[cpu] = 0;
+	}
+	if (!read_cpu_times(busy_before, total_before)) {
+		return pcut_pin_to_cpu() ? sched_getcpu() : -1;
+	}
+	pause.tv_sec = 0;
+	pause.tv_nsec = PIN_LOAD_SAMPLE_TIME;
+	nanosleep(&pause, NULL);
+	read_cpu_times(busy_after, total_after);
+
+	for (cpu = 0; cpu < PIN_MAX_CPUS; cpu++) {
+		unsigned long long total = total_after[cpu] - total_before[cpu];
+		load[cpu] = total > 0
+			? (double) (busy_after[cpu] - busy_before[cpu]) / (double) total
+			: 0.0;
+	}
+
+	/* A busy SMT sibling shares the core, count its load as well. */
+	for (cpu = 0; cpu < PIN_MAX_CPUS; cpu++) {
+		char path[PIN_LINE_SIZE];
+		double score = load[cpu];
+		int sibling;
+
+		if (!CPU_ISSET(cpu, &allowed)) {
+			continue;
+		}
+
+		CPU_ZERO(&set);
+		pcut_snprintf(path, sizeof(path),
+			"/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+		read_cpu_list(path, &set);
+		for (sibling = 0; sibling < PIN_MAX_CPUS; sibling++) {
+			if ((sibling != cpu) && CPU_ISSET(sibling, &set)) {
+				score += load[sibling];
+			}
+		}
+
+		if ((best_cpu < 0) || (score < best_score)) {
+			best_cpu = cpu;
+			best_score = score;
+		}
+	}
+
+	if (best_cpu < 0) {
+		return -1;
+	}
+	CPU_ZERO(&set);
+	CPU_SET(best_cpu, &set);
+	if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+		return -1;
+	}
+	return best_cpu;
+}
+
+/** Read the first word of a sysfs file.
+ *
+ * @param path File to read.
+ * @param buffer Where to store the word.
+ * @param size Size of @p buffer.
+ * @return Whether the word was read.
+ */
+static int read_sysfs_word(const char *path, char *buffer, size_t size) {
+	FILE *file = fopen(path, "r");
+	size_t length;
+
+	if (file == NULL) {
+		return 0;
+	}
+	if (fgets(buffer, (int) size, file) == NULL) {
+		fclose(file);
+		return 0;
+	}
+	fclose(file);
+
+	length = strcspn(buffer, " \n");
+	buffer[length] = 0;
+	return length > 0;
+}
+
+void pcut_get_cpu_environment(pcut_cpu_environment_t *environment) {
+	char value[PCUT_GOVERNOR_NAME_SIZE];
+	double load;
+
+	environment->governor[0] = 0;
+	read_sysfs_word("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor",
+		environment->governor, PCUT_GOVERNOR_NAME_SIZE);
+
+	environment->turbo = -1;
+	if (read_sysfs_word("/sys/devices/system/cpu/intel_pstate/no_turbo",
+			value, PCUT_GOVERNOR_NAME_SIZE)) {
+		environment->turbo = pcut_str_equals(value, "0");
+	} else if (read_sysfs_word("/sys/devices/system/cpu/cpufreq/boost",
+			value, PCUT_GOVERNOR_NAME_SIZE)) {
+		environment->turbo = pcut_str_equals(value, "1");
+	}
+
+	environment->load = getloadavg(&load, 1) == 1 ? load : -1.0;
+	environment->cpu_count = (int) sysconf(_SC_NPROCESSORS_ONLN);
+}
+
+#else
+
+int pcut_perf_counters_available(void) {
+	return 0;
+}
+
+void pcut_perf_counters_start(void) {
+	/* Not supported. */
+}
+
+void pcut_perf_counters_stop(void) {
+	/* Not supported. */
+}
+
+int pcut_instruction_counters_open(void) {
+	return 0;
+}
+
+void pcut_instruction_counters_begin(void) {
+	/* Not supported. */
+}
+
+void pcut_instruction_counters_end(unsigned long long *instructions,
+		unsigned long long *cycles) {
+	*instructions = 0;
+	*cycles = 0;
+}
+
+void pcut_instruction_counters_pause(void) {
+	/* Not supported. */
+}
+
+void pcut_instruction_counters_resume(void) {
+	/* Not supported. */
+}
+
+void pcut_instruction_counters_close(void) {
+	/* Not supported. */
+}
+
+int pcut_pin_to_cpu(void) {
+	return 0;
+}
+
+int pcut_pin_to_quiet_cpu(void) {
+	return -1;
+}
+
+void pcut_get_cpu_environment(pcut_cpu_environment_t *environment) {
+	double load;
+
+	environment->governor[0] = 0;
+	environment->turbo = -1;
+	environment->load = getloadavg(&load, 1) == 1 ? load : -1.0;
+	environment->cpu_count = (int) sysconf(_SC_NPROCESSORS_ONLN);
+}
+
+#endif
+
+#ifdef PROFILER_USE_FRAME_POINTERS
+
+/** Storage for samples (given to pcut_profiler_start()). */
+static pcut_profile_sample_t *profiler_samples;
+
+/** Capacity of profiler_samples. */
+static int profiler_capacity;
+
+/** Number of taken samples (also the index of the next free one). */
+static volatile int profiler_taken;
+
+/** Action of SIGPROF before the profiler was started. */
+static struct sigaction profiler_previous_action;
+
+/** Lowest address of the stack of the profiled thread. */
+static uintptr_t profiler_stack_low;
+
+/** Address just above the stack of the profiled thread. */
+static uintptr_t profiler_stack_high;
+
+/** Get interrupted program counter and frame pointer.
+ *
+ * @param context Context of the interrupted thread.
+ * @param pc Where to store the program counter.
+ * @param fp Where to store the frame pointer.
+ */
+static void get_interrupted_registers(ucontext_t *context,
+		uintptr_t *pc, uintptr_t *fp) {
+#if defined(__x86_64__)
+	*pc = (uintptr_t) context->uc_mcontext.gregs[REG_RIP];
+	*fp = (uintptr_t) context->uc_mcontext.gregs[REG_RBP];
+#elif defined(__i386__)
+	*pc = (uintptr_t) context->uc_mcontext.gregs[REG_EIP];
+	*fp = (uintptr_t) context->uc_mcontext.gregs[REG_EBP];
+#else
+	*pc = (uintptr_t) context->uc_mcontext.pc;
+	*fp = (uintptr_t) context->uc_mcontext.regs[29];
+#endif
+}
+
+/** Follow the chain of frame pointers.
+ *
+ * Each frame starts with the previous frame pointer followed by
+ * the return address.
+ * Every frame pointer is checked to lie on the stack and to go
+ * upwards, a frame without a frame pointer (code compiled with
+ * -fomit-frame-pointer) only ends the stack prematurely.
+ *
+ * @param fp The innermost frame pointer.
+ * @param stack_low Lowest address of the stack.
+ * @param stack_high Address just above the stack.
+ * @param frames Where to store the return addresses.
+ * @param max_depth Number of items in @p frames.
+ * @return Number of stored return addresses.
+ */
+static int walk_frame_pointers(uintptr_t fp, uintptr_t stack_low,
+		uintptr_t stack_high, void **frames, int max_depth) {
+	int depth = 0;
+
+	while (depth < max_depth) {
+		uintptr_t *frame = (uintptr_t *) fp;
+		if ((fp < stack_low)
+				|| (fp > stack_high - 2 * sizeof(uintptr_t))
+				|| ((fp % sizeof(uintptr_t)) != 0)) {
+			break;
+		}
+		if (frame[1] == 0) {
+			break;
+		}
+		frames[depth++] = (void *) frame[1];
+		if (frame[0] <= fp) {
+			break;
+		}
+		fp = frame[0];
+	}
+
+	return depth;
+}
+
+/** Store the interrupted stack (SIGPROF handler).
+ *
+ * Unlike backtrace(), walking the frame pointers does not take any
+ * locks nor allocate, thus it is safe in a signal handler.
+ *
+ * @param sig Signal number.
+ * @param info Signal information.
+ * @param context Context of the interrupted thread.
+ */
+static void take_profiler_sample(int sig, siginfo_t *info, void *context) {
+	int saved_errno = errno;
+	int index = __sync_fetch_and_add(&profiler_taken, 1);
+
+	PCUT_UNUSED(sig);
+	PCUT_UNUSED(info);
+
+	if (index < profiler_capacity) {
+		pcut_profile_sample_t *sample = &profiler_samples[index];
+		uintptr_t pc, fp;
+
+		get_interrupted_registers((ucontext_t *) context, &pc, &fp);
+		sample->frames[0] = (void *) pc;
+		sample->depth = 1 + walk_frame_pointers(fp,
+			profiler_stack_low, profiler_stack_high,
+			sample->frames + 1, PCUT_PROFILE_MAX_DEPTH - 1);
+	}
+
+	errno = saved_errno;
+}
+
+/** Find boundaries of the stack of the current thread.
+ *
+ * @param low Where to store the lowest address of the stack.
+ * @param high Where to store the address just above the stack.
+ * @return Whether the boundaries were found.
+ */
+static int find_stack_bounds(uintptr_t *low, uintptr_t *high) {
+	pthread_attr_t attr;
+	void *stack_address;
+	size_t stack_size;
+	int ok;
+
+	if (pthread_getattr_np(pthread_self(), &attr) != 0) {
+		return 0;
+	}
+	ok = pthread_attr_getstack(&attr, &stack_address, &stack_size) == 0;
+	pthread_attr_destroy(&attr);
+	if (!ok) {
+		return 0;
+	}
+
+	*low = (uintptr_t) stack_address;
+	*high = *low + stack_size;
+	return 1;
+}
+
+/** Address just above the stack of the current thread (zero when unknown). */
+static __thread uintptr_t backtrace_stack_high;
+
+/** Whether the stack bounds of the current thread are being looked up. */
+static __thread int backtrace_finding_bounds;
+
+int pcut_backtrace(void **frames, int max_depth) {
+	uintptr_t fp = (uintptr_t) __builtin_frame_address(0);
+
+	if (backtrace_stack_high == 0) {
+		uintptr_t low, high;
+		/* pthread_getattr_np() may allocate and get here again. */
+		if (backtrace_finding_bounds) {
+			return 0;
+		}
+		backtrace_finding_bounds = 1;
+		if (!find_stack_bounds(&low, &high)) {
+			high = UINTPTR_MAX;
+		}
+		backtrace_stack_high = high;
+		backtrace_finding_bounds = 0;
+	}
+	if (backtrace_stack_high == UINTPTR_MAX) {
+		return 0;
+	}
+
+	/* Callers are above the current frame. */
+	return walk_frame_pointers(fp, fp, backtrace_stack_high, frames, max_depth);
+}
+
+int pcut_profiler_available(void) {
+	return 1;
+}
+
+int pcut_profiler_start(pcut_profile_sample_t *samples, int capacity,
+		int interval_us) {
+	struct sigaction action;
+	struct itimerval timer;
+
+	if (!find_stack_bounds(&profiler_stack_low, &profiler_stack_high)) {
+		return 0;
+	}
+
+	profiler_samples = samples;
+	profiler_capacity = capacity;
+	profiler_taken = 0;
+
+	memset(&action, 0, sizeof(action));
+	action.sa_sigaction = take_profiler_sample;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = SA_RESTART | SA_SIGINFO;
+	if (sigaction(SIGPROF, &action, &profiler_previous_action) != 0) {
+		return 0;
+	}
+
+	timer.it_interval.tv_sec = interval_us / 1000000;
+	timer.it_interval.tv_usec = interval_us % 1000000;
+	timer.it_value = timer.it_interval;
+	if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+		sigaction(SIGPROF, &profiler_previous_action, NULL);
+		return 0;
+	}
+
+	return 1;
+}
+
+int pcut_profiler_stop(void) {
+	struct itimerval timer;
+
+	memset(&timer, 0, sizeof(timer));
+	setitimer(ITIMER_PROF, &timer, NULL);
+
+	/* Ignoring the signal discards a sample that might still be pending. */
+	signal(SIGPROF, SIG_IGN);
+	sigaction(SIGPROF, &profiler_previous_action, NULL);
+
+	return profiler_taken;
+}
+
+void pcut_describe_function(void *address, char *buffer, size_t size) {
+	Dl_info info;
+
+	if ((dladdr(address, &info) != 0) && (info.dli_sname != NULL)) {
+		snprintf(buffer, size, "%s", info.dli_sname);
+	} else if ((dladdr(address, &info) != 0) && (info.dli_fname != NULL)) {
+		/* Offset in the binary, usable with addr2line. */
+		const char *basename = strrchr(info.dli_fname, '/');
+		snprintf(buffer, size, "%s+0x%lx",
+			basename == NULL ? info.dli_fname : basename + 1,
+			(unsigned long) ((char *) address - (char *) info.dli_fbase));
+	} else {
+		snprintf(buffer, size, "%p", address);
+	}
+}
+
+#else
+
+int pcut_profiler_available(void) {
+	return 0;
+}
+
+int pcut_profiler_start(pcut_profile_sample_t *samples, int capacity,
+		int interval_us) {
+	PCUT_UNUSED(samples);
+	PCUT_UNUSED(capacity);
+	PCUT_UNUSED(interval_us);
+	return 0;
+}
+
+int pcut_profiler_stop(void) {
+	return 0;
+}
+
+void pcut_describe_function(void *address, char *buffer, size_t size) {
+	snprintf(buffer, size, "%p", address);
+}
+
+int pcut_backtrace(void **frames, int max_depth) {
+	PCUT_UNUSED(frames);
+	PCUT_UNUSED(max_depth);
+	return 0;
+}
+
+#endif
+
+#ifdef SYSCALLS_USE_SECCOMP
+
+/** Known system call. */
+typedef struct {
+	/** Name of the system call. */
+	const char *name;
+	/** System call number. */
+	int number;
+} syscall_def_t;
+
+/** System calls that can be referred to by name. */
+static const syscall_def_t syscall_defs[] = {
+#ifdef SYS_read
+	{ "read", SYS_read },
+#endif
+#ifdef SYS_write
+	{ "write", SYS_write },
+#endif
+#ifdef SYS_open
+	{ "open", SYS_open },
+#endif
+#ifdef SYS_close
+	{ "close", SYS_close },
+#endif
+#ifdef SYS_stat
+	{ "stat", SYS_stat },
+#endif
+#ifdef SYS_fstat
+	{ "fstat", SYS_fstat },
+#endif
+#ifdef SYS_lstat
+	{ "lstat", SYS_lstat },
+#endif
+#ifdef SYS_newfstatat
+	{ "newfstatat", SYS_newfstatat },
+#endif
+#ifdef SYS_statx
+	{ "statx", SYS_statx },
+#endif
+#ifdef SYS_poll
+	{ "poll", SYS_poll },
+#endif
+#ifdef SYS_ppoll
+	{ "ppoll", SYS_ppoll },
+#endif
+#ifdef SYS_lseek
+	{ "lseek", SYS_lseek },
+#endif
+#ifdef SYS_mmap
+	{ "mmap", SYS_mmap },
+#endif
+#ifdef SYS_mprotect
+	{ "mprotect", SYS_mprotect },
+#endif
+#ifdef SYS_munmap
+	{ "munmap", SYS_munmap },
+#endif
+#ifdef SYS_brk
+	{ "brk", SYS_brk },
+#endif
+#ifdef SYS_rt_sigaction
+	{ "rt_sigaction", SYS_rt_sigaction },
+#endif
+#ifdef SYS_rt_sigprocmask
+	{ "rt_sigprocmask", SYS_rt_sigprocmask },
+#endif
+#ifdef SYS_rt_sigreturn
+	{ "rt_sigreturn", SYS_rt_sigreturn },
+#endif
+#ifdef SYS_ioctl
+	{ "ioctl", SYS_ioctl },
+#endif
+#ifdef SYS_pread64
+	{ "pread64", SYS_pread64 },
+#endif
+#ifdef SYS_pwrite64
+	{ "pwrite64", SYS_pwrite64 },
+#endif
+#ifdef SYS_readv
+	{ "readv", SYS_readv },
+#endif
+#ifdef SYS_writev
+	{ "writev", SYS_writev },
+#endif
+#ifdef SYS_access
+	{ "access", SYS_access },
+#endif
+#ifdef SYS_faccessat
+	{ "faccessat", SYS_faccessat },
+#endif
+#ifdef SYS_pipe
+	{ "pipe", SYS_pipe },
+#endif
+#ifdef SYS_pipe2
+	{ "pipe2", SYS_pipe2 },
+#endif
+#ifdef SYS_select
+	{ "select", SYS_select },
+#endif
+#ifdef SYS_pselect6
+	{ "pselect6", SYS_pselect6 },
+#endif
+#ifdef SYS_sched_yield
+	{ "sched_yield", SYS_sched_yield },
+#endif
+#ifdef SYS_mremap
+	{ "mremap", SYS_mremap },
+#endif
+#ifdef SYS_msync
+	{ "msync", SYS_msync },
+#endif
+#ifdef SYS_madvise
+	{ "madvise", SYS_madvise },
+#endif
+#ifdef SYS_dup
+	{ "dup", SYS_dup },
+#endif
+#ifdef SYS_dup2
+	{ "dup2", SYS_dup2 },
+#endif
+#ifdef SYS_dup3
+	{ "dup3", SYS_dup3 },
+#endif
+#ifdef SYS_nanosleep
+	{ "nanosleep", SYS_nanosleep },
+#endif
+#ifdef SYS_clock_nanosleep
+	{ "clock_nanosleep", SYS_clock_nanosleep },
+#endif
+#ifdef SYS_getpid
+	{ "getpid", SYS_getpid },
+#endif
+#ifdef SYS_socket
+	{ "socket", SYS_socket },
+#endif
+#ifdef SYS_connect
+	{ "connect", SYS_connect },
+#endif
+#ifdef SYS_accept
+	{ "accept", SYS_accept },
+#endif
+#ifdef SYS_accept4
+	{ "accept4", SYS_accept4 },
+#endif
+#ifdef SYS_sendto
+	{ "sendto", SYS_sendto },
+#endif
+#ifdef SYS_recvfrom
+	{ "recvfrom", SYS_recvfrom },
+#endif
+#ifdef SYS_sendmsg
+	{ "sendmsg", SYS_sendmsg },
+#endif
+#ifdef SYS_recvmsg
+	{ "recvmsg", SYS_recvmsg },
+#endif
+#ifdef SYS_shutdown
+	{ "shutdown", SYS_shutdown },
+#endif
+#ifdef SYS_bind
+	{ "bind", SYS_bind },
+#endif
+#ifdef SYS_listen
+	{ "listen", SYS_listen },
+#endif
+#ifdef SYS_clone
+	{ "clone", SYS_clone },
+#endif
+#ifdef SYS_clone3
+	{ "clone3", SYS_clone3 },
+#endif
+#ifdef SYS_fork
+	{ "fork", SYS_fork },
+#endif
+#ifdef SYS_vfork
+	{ "vfork", SYS_vfork },
+#endif
+#ifdef SYS_execve
+	{ "execve", SYS_execve },
+#endif
+#ifdef SYS_exit
+	{ "exit", SYS_exit },
+#endif
+#ifdef SYS_exit_group
+	{ "exit_group", SYS_exit_group },
+#endif
+#ifdef SYS_wait4
+	{ "wait4", SYS_wait4 },
+#endif
+#ifdef SYS_kill
+	{ "kill", SYS_kill },
+#endif
+#ifdef SYS_uname
+	{ "uname", SYS_uname },
+#endif
+#ifdef SYS_fcntl
+	{ "fcntl", SYS_fcntl },
+#endif
+#ifdef SYS_flock
+	{ "flock", SYS_flock },
+#endif
+#ifdef SYS_fsync
+	{ "fsync", SYS_fsync },
+#endif
+#ifdef SYS_fdatasync
+	{ "fdatasync", SYS_fdatasync },
+#endif
+#ifdef SYS_truncate
+	{ "truncate", SYS_truncate },
+#endif
+#ifdef SYS_ftruncate
+	{ "ftruncate", SYS_ftruncate },
+#endif
+#ifdef SYS_getdents64
+	{ "getdents64", SYS_getdents64 },
+#endif
+#ifdef SYS_getcwd
+	{ "getcwd", SYS_getcwd },
+#endif
+#ifdef SYS_chdir
+	{ "chdir", SYS_chdir },
+#endif
+#ifdef SYS_rename
+	{ "rename", SYS_rename },
+#endif
+#ifdef SYS_renameat
+	{ "renameat", SYS_renameat },
+#endif
+#ifdef SYS_renameat2
+	{ "renameat2", SYS_renameat2 },
+#endif
+#ifdef SYS_mkdir
+	{ "mkdir", SYS_mkdir },
+#endif
+#ifdef SYS_mkdirat
+	{ "mkdirat", SYS_mkdirat },
+#endif
+#ifdef SYS_rmdir
+	{ "rmdir", SYS_rmdir },
+#endif
+#ifdef SYS_unlink
+	{ "unlink", SYS_unlink },
+#endif
+#ifdef SYS_unlinkat
+	{ "unlinkat", SYS_unlinkat },
+#endif
+#ifdef SYS_readlink
+	{ "readlink", SYS_readlink },
+#endif
+#ifdef SYS_readlinkat
+	{ "readlinkat", SYS_readlinkat },
+#endif
+#ifdef SYS_chmod
+	{ "chmod", SYS_chmod },
+#endif
+#ifdef SYS_fchmod
+	{ "fchmod", SYS_fchmod },
+#endif
+#ifdef SYS_openat
+	{ "openat", SYS_openat },
+#endif
+#ifdef SYS_close_range
+	{ "close_range", SYS_close_range },
+#endif
+#ifdef SYS_gettimeofday
+	{ "gettimeofday", SYS_gettimeofday },
+#endif
+#ifdef SYS_clock_gettime
+	{ "clock_gettime", SYS_clock_gettime },
+#endif
+#ifdef SYS_getrusage
+	{ "getrusage", SYS_getrusage },
+#endif
+#ifdef SYS_sysinfo
+	{ "sysinfo", SYS_sysinfo },
+#endif
+#ifdef SYS_times
+	{ "times", SYS_times },
+#endif
+#ifdef SYS_getppid
+	{ "getppid", SYS_getppid },
+#endif
+#ifdef SYS_getuid
+	{ "getuid", SYS_getuid },
+#endif
+#ifdef SYS_geteuid
+	{ "geteuid", SYS_geteuid },
+#endif
+#ifdef SYS_gettid
+	{ "gettid", SYS_gettid },
+#endif
+#ifdef SYS_futex
+	{ "futex", SYS_futex },
+#endif
+#ifdef SYS_set_robust_list
+	{ "set_robust_list", SYS_set_robust_list },
+#endif
+#ifdef SYS_epoll_create1
+	{ "epoll_create1", SYS_epoll_create1 },
+#endif
+#ifdef SYS_epoll_ctl
+	{ "epoll_ctl", SYS_epoll_ctl },
+#endif
+#ifdef SYS_epoll_wait
+	{ "epoll_wait", SYS_epoll_wait },
+#endif
+#ifdef SYS_epoll_pwait
+	{ "epoll_pwait", SYS_epoll_pwait },
+#endif
+#ifdef SYS_eventfd2
+	{ "eventfd2", SYS_eventfd2 },
+#endif
+#ifdef SYS_timerfd_create
+	{ "timerfd_create", SYS_timerfd_create },
+#endif
+#ifdef SYS_prlimit64
+	{ "prlimit64", SYS_prlimit64 },
+#endif
+#ifdef SYS_getrandom
+	{ "getrandom", SYS_getrandom },
+#endif
+#ifdef SYS_memfd_create
+	{ "memfd_create", SYS_memfd_create },
+#endif
+#ifdef SYS_copy_file_range
+	{ "copy_file_range", SYS_copy_file_range },
+#endif
+#ifdef SYS_sendfile
+	{ "sendfile", SYS_sendfile },
+#endif
+#ifdef SYS_splice
+	{ "splice", SYS_splice },
+#endif
+#ifdef SYS_io_uring_setup
+	{ "io_uring_setup", SYS_io_uring_setup },
+#endif
+#ifdef SYS_io_uring_enter
+	{ "io_uring_enter", SYS_io_uring_enter },
+#endif
+#ifdef SYS_sched_getaffinity
+	{ "sched_getaffinity", SYS_sched_getaffinity },
+#endif
+#ifdef SYS_sched_setaffinity
+	{ "sched_setaffinity", SYS_sched_setaffinity },
+#endif
+#ifdef SYS_setitimer
+	{ "setitimer", SYS_setitimer },
+#endif
+#ifdef SYS_getitimer
+	{ "getitimer", SYS_getitimer },
+#endif
+#ifdef SYS_seccomp
+	{ "seccomp", SYS_seccomp },
+#endif
+#ifdef SYS_prctl
+	{ "prctl", SYS_prctl },
+#endif
+	{ NULL, -1 }
+};
+
+/** Where the supervisor thread counts system calls (NULL when not counting). */
+static unsigned long *volatile syscall_counts;
+
+/** Number of items in syscall_counts. */
+static int syscall_counts_size;
+
+/** Listener was not created yet. */
+#define SYSCALL_LISTENER_PENDING -1
+
+/** Filter could not be installed. */
+#define SYSCALL_LISTENER_FAILED -2
+
+/** File descriptor of the seccomp listener (or SYSCALL_LISTENER_*). */
+static volatile int syscall_listener = SYSCALL_LISTENER_PENDING;
+
+/** Continue notified system calls and count them.
+ *
+ * The thread is started before the filter is installed, thus its own
+ * system calls are not notified.
+ *
+ * @param arg Not used.
+ * @return Nothing.
+ */
+static void *syscall_supervisor_main(void *arg) {
+	struct seccomp_notif request;
+	struct seccomp_notif_resp response;
+
+	PCUT_UNUSED(arg);
+
+	/* The filtered thread cannot wake us without a system call. */
+	while (syscall_listener == SYSCALL_LISTENER_PENDING) {
+		sched_yield();
+	}
+	if (syscall_listener == SYSCALL_LISTENER_FAILED) {
+		return NULL;
+	}
+
+	while (1) {
+		unsigned long *counts;
+
+		memset(&request, 0, sizeof(request));
+		if (ioctl(syscall_listener, SECCOMP_IOCTL_NOTIF_RECV, &request) != 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+
+		counts = syscall_counts;
+		if ((counts != NULL) && (request.data.nr >= 0)
+				&& (request.data.nr < syscall_counts_size)) {
+			counts[request.data.nr]++;
+		}
+
+		memset(&response, 0, sizeof(response));
+		response.id = request.id;
+		response.flags = SECCOMP_USER_NOTIF_FLAG_CONTINUE;
+		ioctl(syscall_listener, SECCOMP_IOCTL_NOTIF_SEND, &response);
+	}
+
+	return NULL;
+}
+
+/** Install filter notifying all system calls of the current thread.
+ *
+ * Threads and processes created by this thread later inherit the filter.
+ *
+ * @return Whether the filter was installed.
+ */
+static int install_syscall_filter(void) {
+	struct sock_filter filter[] = {
+		BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_USER_NOTIF)
+	};
+	struct sock_fprog program;
+	pthread_t supervisor;
+	int listener;
+
+	program.len = (unsigned short) (sizeof(filter) / sizeof(filter[0]));
+	program.filter = filter;
+
+	if ((prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) != 0)
+			|| (pthread_create(&supervisor, NULL, syscall_supervisor_main, NULL) != 0)) {
+		syscall_listener = SYSCALL_LISTENER_FAILED;
+		return 0;
+	}
+	pthread_detach(supervisor);
+
+	listener = (int) syscall(SYS_seccomp, SECCOMP_SET_MODE_FILTER,
+		SECCOMP_FILTER_FLAG_NEW_LISTENER, &program);
+	if (listener < 0) {
+		syscall_listener = SYSCALL_LISTENER_FAILED;
+		return 0;
+	}
+	syscall_listener = listener;
+
+	return 1;
+}
+
+int pcut_syscall_counting_available(void) {
+	return 1;
+}
+
+int pcut_syscall_counting_start(unsigned long *counts, int size) {
+	/* The filter cannot be removed, it stays installed for later tests. */
+	if (syscall_listener == SYSCALL_LISTENER_FAILED) {
+		return 0;
+	}
+	if ((syscall_listener == SYSCALL_LISTENER_PENDING) && !install_syscall_filter()) {
+		return 0;
+	}
+
+	syscall_counts_size = size;
+	__sync_synchronize();
+	syscall_counts = counts;
+
+	return 1;
+}
+
+void pcut_syscall_counting_stop(void) {
+	syscall_counts = NULL;
+	__sync_synchronize();
+}
+
+int pcut_syscall_number(const char *name) {
+	int i;
+
+	for (i = 0; syscall_defs[i].name != NULL; i++) {
+		if (pcut_str_equals(syscall_defs[i].name, name)) {
+			return syscall_defs[i].number;
+		}
+	}
+
+	return -1;
+}
+
+const char *pcut_syscall_name(int number) {
+	int i;
+
+	for (i = 0; syscall_defs[i].name != NULL; i++) {
+		if (syscall_defs[i].number == number) {
+			return syscall_defs[i].name;
+		}
+	}
+
+	return NULL;
+}
+
+#else
+
+int pcut_syscall_counting_available(void) {
+	return 0;
+}
+
+int pcut_syscall_counting_start(unsigned long *counts, int size) {
+	PCUT_UNUSED(counts);
+	PCUT_UNUSED(size);
+	return 0;
+}
+
+void pcut_syscall_counting_stop(void) {
+	/* Not supported. */
+}
+
+int pcut_syscall_number(const char *name) {
+	PCUT_UNUSED(name);
+	return -1;
+}
+
+const char *pcut_syscall_name(int number) {
+	PCUT_UNUSED(number);
+	return NULL;
+}
+
+#endif
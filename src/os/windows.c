@@ -43,6 +43,7 @@
 #include <tchar.h>
 #include <stdio.h>
 #include <strsafe.h>
+#include <io.h>
 #pragma warning(pop)
 
 
@@ -51,7 +52,7 @@
 #define OUTPUT_BUFFER_SIZE 8192
 
 /** Maximum command-line length. */
-#define PCUT_COMMAND_LINE_BUFFER_SIZE 256
+#define PCUT_COMMAND_LINE_BUFFER_SIZE 1024
 
 /** Buffer for assertion and other error messages. */
 static char error_message_buffer[OUTPUT_BUFFER_SIZE];
@@ -59,6 +60,9 @@ static char error_message_buffer[OUTPUT_BUFFER_SIZE];
 /** Buffer for stdout from the test. */
 static char extra_output_buffer[OUTPUT_BUFFER_SIZE];
 
+/** Measurements of the test. */
+static pcut_measurements_t measurements;
+
 /** Prepare for a new test.
  *
  * @param test Test that is about to be run.
@@ -79,7 +83,7 @@ static void report_func_fail(pcut_item_t *test, const char *failed_function_name
 	/* TODO: get error description. */
 	pcut_snprintf(error_message_buffer, OUTPUT_BUFFER_SIZE - 1,
 		"%s failed: %s.", failed_function_name, "unknown reason");
-	pcut_report_test_done(test, PCUT_OUTCOME_INTERNAL_ERROR, error_message_buffer, NULL, NULL);
+	pcut_report_test_done(test, PCUT_OUTCOME_INTERNAL_ERROR, error_message_buffer, NULL, NULL, NULL);
 }
 
 /** Read full buffer from given file descriptor.
@@ -162,10 +166,16 @@ int pcut_run_test_forking(const char *self_path, pcut_item_t *test) {
 	char command[PCUT_COMMAND_LINE_BUFFER_SIZE];
 	struct test_output_data test_output_data;
 	HANDLE test_output_thread_reader;
+	unsigned long long start_time = 0;
 
 
 	before_test_start(test);
 
+	pcut_measurements_clear(&measurements);
+	if (pcut_measure_durations) {
+		start_time = pcut_timer_now();
+	}
+
 	/* Pipe handles are inherited. */
 	security_attributes.nLength = sizeof(SECURITY_ATTRIBUTES);
 	security_attributes.bInheritHandle = TRUE;
@@ -218,7 +228,7 @@ int pcut_run_test_forking(const char *self_path, pcut_item_t *test) {
 
 	/* Format the command line. */
 	pcut_snprintf(command, PCUT_COMMAND_LINE_BUFFER_SIZE - 1,
-		"\"%s\" -t%d", self_path, test->id);
+		"\"%s\" %s -t%d", self_path, pcut_child_arguments, test->id);
 
 	/* Run the process. */
 	okay = CreateProcess(NULL, command, NULL, NULL, TRUE, 0, NULL, NULL,
@@ -301,6 +311,10 @@ int pcut_run_test_forking(const char *self_path, pcut_item_t *test) {
 
 	if (rc == 0) {
 		outcome = PCUT_OUTCOME_PASS;
+	} else if (!timed_out && ((rc == PCUT_OUTCOME_MEMORY_LIMIT)
+			|| (rc == PCUT_OUTCOME_TOO_SLOW))) {
+		/* Outcomes decided by the test process itself. */
+		outcome = (int) rc;
 	} else if ((rc > 0) && (rc < 10) && !timed_out) {
 		outcome = PCUT_OUTCOME_FAIL;
 	} else {
@@ -314,11 +328,25 @@ int pcut_run_test_forking(const char *self_path, pcut_item_t *test) {
 		return PCUT_OUTCOME_INTERNAL_ERROR;
 	}
 
-	pcut_report_test_done_unparsed(test, outcome, extra_output_buffer, OUTPUT_BUFFER_SIZE);
+	if (pcut_measure_durations) {
+		pcut_measurements_add(&measurements, "duration",
+			(double) (pcut_timer_now() - start_time), "ns");
+	}
+
+	pcut_report_test_done_unparsed(test, outcome, extra_output_buffer, OUTPUT_BUFFER_SIZE,
+		&measurements);
 
 	return outcome;
 }
 
+int pcut_run_tests_parallel(const char *self_path, pcut_item_t *first) {
+	PCUT_UNUSED(self_path);
+	PCUT_UNUSED(first);
+
+	/* Not supported, tests are run one by one. */
+	return -1;
+}
+
 void pcut_hook_before_test(pcut_item_t *test) {
 	PCUT_UNUSED(test);
 
@@ -328,3 +356,265 @@ void pcut_hook_before_test(pcut_item_t *test) {
 	 */
 	SetErrorMode(SEM_FAILCRITICALERRORS | SEM_NOGPFAULTERRORBOX);
 }
+
+/** Frequency of the performance counter (zero until queried). */
+static LONGLONG timer_frequency = 0;
+
+void pcut_timer_init(void) {
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	timer_frequency = frequency.QuadPart;
+}
+
+/*
+ * The performance counter already uses the invariant time-stamp counter
+ * when it is available and it is calibrated by the system.
+ */
+unsigned long long pcut_timer_now(void) {
+	LARGE_INTEGER now;
+
+	if (timer_frequency == 0) {
+		pcut_timer_init();
+	}
+
+	QueryPerformanceCounter(&now);
+	return (unsigned long long) (now.QuadPart / timer_frequency) * 1000000000ULL
+		+ (unsigned long long) (now.QuadPart % timer_frequency) * 1000000000ULL / timer_frequency;
+}
+
+const char *pcut_timer_source(void) {
+	return "QueryPerformanceCounter";
+}
+
+void pcut_sync_file(FILE *file) {
+	fflush(file);
+	_commit(_fileno(file));
+}
+
+FILE *pcut_open_terminal(void) {
+	int fd;
+	FILE *terminal;
+
+	if (!_isatty(_fileno(stdout))) {
+		return NULL;
+	}
+
+	fd = _dup(_fileno(stdout));
+	if (fd < 0) {
+		return NULL;
+	}
+
+	terminal = _fdopen(fd, "w");
+	if (terminal == NULL) {
+		_close(fd);
+	}
+
+	return terminal;
+}
+
+int pcut_perf_counters_available(void) {
+	return 0;
+}
+
+void pcut_perf_counters_start(void) {
+	/* Not supported. */
+}
+
+void pcut_perf_counters_stop(void) {
+	/* Not supported. */
+}
+
+int pcut_instruction_counters_open(void) {
+	return 0;
+}
+
+void pcut_instruction_counters_begin(void) {
+	/* Not supported. */
+}
+
+void pcut_instruction_counters_end(unsigned long long *instructions,
+		unsigned long long *cycles) {
+	*instructions = 0;
+	*cycles = 0;
+}
+
+void pcut_instruction_counters_pause(void) {
+	/* Not supported. */
+}
+
+void pcut_instruction_counters_resume(void) {
+	/* Not supported. */
+}
+
+void pcut_instruction_counters_close(void) {
+	/* Not supported. */
+}
+
+int pcut_pin_to_cpu(void) {
+	return 0;
+}
+
+int pcut_pin_to_quiet_cpu(void) {
+	return -1;
+}
+
+void pcut_get_cpu_environment(pcut_cpu_environment_t *environment) {
+	SYSTEM_INFO info;
+
+	GetSystemInfo(&info);
+	environment->governor[0] = 0;
+	environment->turbo = -1;
+	environment->load = -1.0;
+	environment->cpu_count = (int) info.dwNumberOfProcessors;
+}
+
+/** Function executed by threads started by pcut_run_threads(). */
+static pcut_thread_func_t benchmark_threads_func;
+
+/** Argument for benchmark_threads_func. */
+static void *benchmark_threads_arg;
+
+/** Manual-reset event releasing the threads together. */
+static HANDLE benchmark_threads_start;
+
+/** Indices of the threads. */
+static int benchmark_thread_indices[PCUT_BENCHMARK_MAX_THREADS];
+
+/** Wait for the start event and execute the benchmark function.
+ *
+ * @param arg Pointer to the thread index.
+ * @return Always zero.
+ */
+static DWORD WINAPI benchmark_thread_main(LPVOID arg) {
+	WaitForSingleObject(benchmark_threads_start, INFINITE);
+	benchmark_threads_func(*((int *) arg), benchmark_threads_arg);
+	return 0;
+}
+
+int pcut_run_threads(int count, pcut_thread_func_t func, void *arg) {
+	HANDLE threads[PCUT_BENCHMARK_MAX_THREADS];
+	int started, i;
+
+	benchmark_threads_func = func;
+	benchmark_threads_arg = arg;
+	benchmark_threads_start = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (benchmark_threads_start == NULL) {
+		return 0;
+	}
+
+	for (started = 0; started < count; started++) {
+		benchmark_thread_indices[started] = started;
+		threads[started] = CreateThread(NULL, 0, benchmark_thread_main,
+			&benchmark_thread_indices[started], 0, NULL);
+		if (threads[started] == NULL) {
+			break;
+		}
+	}
+
+	SetEvent(benchmark_threads_start);
+	for (i = 0; i < started; i++) {
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+	}
+	CloseHandle(benchmark_threads_start);
+
+	return started == count;
+}
+
+/** Maximum number of processor information records queried. */
+#define PROCESSOR_INFORMATION_COUNT 256
+
+size_t pcut_get_last_level_cache_size(void) {
+	static SYSTEM_LOGICAL_PROCESSOR_INFORMATION info[PROCESSOR_INFORMATION_COUNT];
+	DWORD length = sizeof(info);
+	DWORD count, i;
+	size_t best_size = 0;
+	BYTE best_level = 0;
+
+	if (!GetLogicalProcessorInformation(info, &length)) {
+		return 0;
+	}
+
+	count = length / sizeof(info[0]);
+	for (i = 0; i < count; i++) {
+		if ((info[i].Relationship != RelationCache)
+				|| (info[i].Cache.Type == CacheInstruction)) {
+			continue;
+		}
+		if (info[i].Cache.Level >= best_level) {
+			best_level = info[i].Cache.Level;
+			best_size = info[i].Cache.Size;
+		}
+	}
+
+	return best_size;
+}
+
+void *pcut_map_pages(size_t size) {
+	return VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+void pcut_discard_pages(void *pages, size_t size) {
+	/* Re-committed pages are zero-filled and faulted in on first touch. */
+	VirtualFree(pages, size, MEM_DECOMMIT);
+	VirtualAlloc(pages, size, MEM_COMMIT, PAGE_READWRITE);
+}
+
+int pcut_syscall_counting_available(void) {
+	return 0;
+}
+
+int pcut_syscall_counting_start(unsigned long *counts, int size) {
+	PCUT_UNUSED(counts);
+	PCUT_UNUSED(size);
+	return 0;
+}
+
+void pcut_syscall_counting_stop(void) {
+	/* Not supported. */
+}
+
+int pcut_syscall_number(const char *name) {
+	PCUT_UNUSED(name);
+	return -1;
+}
+
+const char *pcut_syscall_name(int number) {
+	PCUT_UNUSED(number);
+	return NULL;
+}
+
+int pcut_profiler_available(void) {
+	return 0;
+}
+
+int pcut_profiler_start(pcut_profile_sample_t *samples, int capacity,
+		int interval_us) {
+	PCUT_UNUSED(samples);
+	PCUT_UNUSED(capacity);
+	PCUT_UNUSED(interval_us);
+	return 0;
+}
+
+int pcut_profiler_stop(void) {
+	return 0;
+}
+
+void pcut_describe_function(void *address, char *buffer, size_t size) {
+	pcut_snprintf(buffer, size, "%p", address);
+}
+
+int pcut_backtrace(void **frames, int max_depth) {
+	PCUT_UNUSED(frames);
+	PCUT_UNUSED(max_depth);
+	return 0;
+}
+
+unsigned long long pcut_get_peak_rss(void) {
+	return 0;
+}
+
+int pcut_set_memory_limit(unsigned long bytes) {
+	PCUT_UNUSED(bytes);
+	return 0;
+}
@@ -53,6 +53,9 @@ void pcut_print_items(pcut_item_t *first) {
 		case PCUT_KIND_TEST:
 			printf("TEST %s\n", it->name);
 			break;
+		case PCUT_KIND_BENCHMARK:
+			printf("BENCHMARK %s\n", it->name);
+			break;
 		case PCUT_KIND_TESTSUITE:
 			printf("SUITE %s\n", it->name);
 			break;
@@ -84,6 +87,9 @@ void pcut_print_tests(pcut_item_t *first) {
 		case PCUT_KIND_TEST:
 			printf("    Test `%s' [%d]\n", it->name, it->id);
 			break;
+		case PCUT_KIND_BENCHMARK:
+			printf("    Benchmark `%s' [%d]\n", it->name, it->id);
+			break;
 		case PCUT_KIND_SETUP:
 		case PCUT_KIND_TEARDOWN:
 			/* Fall-through, do nothing. */
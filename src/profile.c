@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Sampling profiler of test bodies.
+ *
+ * The OS layer interrupts the test periodically (based on consumed
+ * processor time) and stores the interrupted stack into a preallocated
+ * array of samples.
+ * Only after the test body finishes, identical stacks are merged and
+ * their frames are translated to function names.
+ *
+ * Functions with most samples on top of the stack are recorded as
+ * measurements of the test.
+ * When requested, all stacks are also appended in the folded format
+ * (one line per stack, frames separated by semicolons and followed by
+ * the number of samples) that flame graph tools accept directly.
+ * The root frame is the name of the test so that profiles of several
+ * tests can be kept in the same file.
+ *
+ * Profiling is done only in the process running a single test, thus
+ * the launcher is never sampled.
+ */
+
+#include "internal.h"
+
+#pragma warning(push, 0)
+#include <stdio.h>
+#ifdef __helenos__
+#include <mem.h>
+#else
+#include <string.h>
+#endif
+#pragma warning(pop)
+
+
+/** Number of slots in the table of distinct stacks. */
+#define STACK_TABLE_SIZE (2 * PCUT_PROFILE_MAX_SAMPLES)
+
+/** Number of slots in the table of sampled functions. */
+#define FUNCTION_TABLE_SIZE 512
+
+/** Size of the buffer for one folded stack. */
+#define FOLDED_LINE_SIZE \
+	((PCUT_PROFILE_MAX_DEPTH + 1) * PCUT_PROFILE_FUNCTION_NAME_SIZE)
+
+/** Distinct sampled stack. */
+typedef struct {
+	/** Index of the first sample with this stack (-1 for empty slot). */
+	int sample;
+	/** Number of samples with this stack. */
+	int count;
+} profile_stack_t;
+
+/** Distinct folded stack (after symbolization). */
+typedef struct {
+	/** Offset of the name in folded_names (-1 for empty slot). */
+	int offset;
+	/** Number of samples with this stack. */
+	int count;
+} folded_stack_t;
+
+/** Function on top of sampled stacks. */
+typedef struct {
+	/** Function name (empty for empty slot). */
+	char name[PCUT_PROFILE_FUNCTION_NAME_SIZE];
+	/** Number of samples. */
+	int count;
+} profile_function_t;
+
+/** Whether to profile test bodies. */
+int pcut_profile = 0;
+
+/** File where folded stacks are appended (NULL when not exporting). */
+static const char *folded_filename = NULL;
+
+/** Whether the profiler is running. */
+static int profiling_active = 0;
+
+/** Stored samples. */
+static pcut_profile_sample_t samples[PCUT_PROFILE_MAX_SAMPLES];
+
+/** Distinct stacks. */
+static profile_stack_t stacks[STACK_TABLE_SIZE];
+
+/** Functions on top of the stacks. */
+static profile_function_t functions[FUNCTION_TABLE_SIZE];
+
+/** Folded stacks of the current test. */
+static folded_stack_t folded_stacks[STACK_TABLE_SIZE];
+
+/** Storage for names of folded stacks (zero-terminated). */
+static char folded_names[PCUT_PROFILE_FOLDED_SIZE];
+
+/** Number of used bytes in folded_names. */
+static int folded_names_used;
+
+/** Buffer for composing the output of the current test. */
+static char folded_buffer[PCUT_PROFILE_FOLDED_SIZE];
+
+/** Set where the folded stacks are appended.
+ *
+ * @param filename Output file (NULL to disable export).
+ */
+void pcut_profile_set_folded_file(const char *filename) {
+	folded_filename = filename;
+}
+
+/** Prepare the folded stacks file before the whole run.
+ *
+ * @return Whether the file could be created.
+ */
+int pcut_profile_folded_start(void) {
+	FILE *output;
+
+	if (folded_filename == NULL) {
+		return 1;
+	}
+
+	output = fopen(folded_filename, "w");
+	if (output == NULL) {
+		return 0;
+	}
+	fclose(output);
+
+	return 1;
+}
+
+/** Start profiling the test body.
+ *
+ * Does nothing unless profiling was requested.
+ */
+void pcut_profile_begin(void) {
+	if (!pcut_profile) {
+		return;
+	}
+
+	profiling_active = pcut_profiler_start(samples, PCUT_PROFILE_MAX_SAMPLES,
+		PCUT_PROFILE_INTERVAL_US);
+}
+
+/** Compute hash of a sampled stack.
+ *
+ * @param sample The sample.
+ * @return Hash value.
+ */
+static unsigned long hash_stack(const pcut_profile_sample_t *sample) {
+	unsigned long hash = (unsigned long) sample->depth;
+	int i;
+
+	for (i = 0; i < sample->depth; i++) {
+		hash = hash * 31 + (unsigned long) ((size_t) sample->frames[i] >> 2);
+	}
+
+	return hash;
+}
+
+/** Tell whether two samples have the same stack.
+ *
+ * @param a First sample.
+ * @param b Second sample.
+ * @return Whether the stacks are identical.
+ */
+static int same_stack(const pcut_profile_sample_t *a,
+		const pcut_profile_sample_t *b) {
+	int i;
+
+	if (a->depth != b->depth) {
+		return 0;
+	}
+	for (i = 0; i < a->depth; i++) {
+		if (a->frames[i] != b->frames[i]) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/** Merge samples with identical stacks.
+ *
+ * @param count Number of stored samples.
+ */
+static void merge_stacks(int count) {
+	int i;
+
+	for (i = 0; i < STACK_TABLE_SIZE; i++) {
+		stacks[i].sample = -1;
+		stacks[i].count = 0;
+	}
+
+	/* The table is twice as big as the number of samples, it never fills. */
+	for (i = 0; i < count; i++) {
+		unsigned long index = hash_stack(&samples[i]) % STACK_TABLE_SIZE;
+
+		while ((stacks[index].sample >= 0)
+				&& !same_stack(&samples[stacks[index].sample], &samples[i])) {
+			index = (index + 1) % STACK_TABLE_SIZE;
+		}
+		if (stacks[index].sample < 0) {
+			stacks[index].sample = i;
+		}
+		stacks[index].count++;
+	}
+}
+
+/** Get name of a function in a sampled stack.
+ *
+ * Return addresses point after the call instruction that might
+ * already belong to the next function, thus we look one byte back
+ * for all but the innermost (interrupted) frame.
+ *
+ * Characters with special meaning in the folded format are replaced.
+ *
+ * @param sample The sample.
+ * @param frame Index of the frame.
+ * @param buffer Where to store the name.
+ */
+static void describe_frame(const pcut_profile_sample_t *sample, int frame,
+		char *buffer) {
+	char *address = (char *) sample->frames[frame];
+	char *it;
+
+	if (frame > 0) {
+		address--;
+	}
+	pcut_describe_function(address, buffer, PCUT_PROFILE_FUNCTION_NAME_SIZE);
+
+	for (it = buffer; *it != 0; it++) {
+		if ((*it == ' ') || (*it == ';')) {
+			*it = '_';
+		}
+	}
+}
+
+/** Add samples of a function on top of the stack.
+ *
+ * New functions are dropped when the table is full.
+ *
+ * @param name Function name.
+ * @param count Number of samples.
+ */
+static void function_add(const char *name, int count) {
+	unsigned long index = 0;
+	const char *it;
+	int probes;
+
+	for (it = name; *it != 0; it++) {
+		index = index * 31 + (unsigned char) *it;
+	}
+	index = index % FUNCTION_TABLE_SIZE;
+
+	for (probes = 0; probes < FUNCTION_TABLE_SIZE; probes++) {
+		profile_function_t *function = &functions[index];
+		if (function->name[0] == 0) {
+			pcut_snprintf(function->name, PCUT_PROFILE_FUNCTION_NAME_SIZE,
+				"%s", name);
+		}
+		if (pcut_str_equals(function->name, name)) {
+			function->count += count;
+			return;
+		}
+		index = (index + 1) % FUNCTION_TABLE_SIZE;
+	}
+}
+
+/** Add samples of a folded stack.
+ *
+ * Stacks with different addresses can still have the same names
+ * (e.g. different instructions of the same function).
+ * New stacks are dropped when the storage for their names is full.
+ *
+ * @param stack Folded stack (without the count).
+ * @param count Number of samples.
+ */
+static void folded_stack_add(const char *stack, int count) {
+	unsigned long index = 0;
+	const char *it;
+	int length;
+
+	for (it = stack; *it != 0; it++) {
+		index = index * 31 + (unsigned char) *it;
+	}
+	index = index % STACK_TABLE_SIZE;
+
+	/* There are never more folded stacks than distinct stacks. */
+	while (folded_stacks[index].offset >= 0) {
+		if (pcut_str_equals(folded_names + folded_stacks[index].offset, stack)) {
+			folded_stacks[index].count += count;
+			return;
+		}
+		index = (index + 1) % STACK_TABLE_SIZE;
+	}
+
+	length = pcut_str_size(stack);
+	if (length + 1 > PCUT_PROFILE_FOLDED_SIZE - folded_names_used) {
+		return;
+	}
+	memcpy(folded_names + folded_names_used, stack, length + 1);
+	folded_stacks[index].offset = folded_names_used;
+	folded_stacks[index].count = count;
+	folded_names_used += length + 1;
+}
+
+/** Symbolize the merged stacks.
+ *
+ * Fills the table of functions and the table of folded stacks.
+ */
+static void symbolize_stacks(void) {
+	static char line[FOLDED_LINE_SIZE];
+	char name[PCUT_PROFILE_FUNCTION_NAME_SIZE];
+	int i;
+
+	for (i = 0; i < FUNCTION_TABLE_SIZE; i++) {
+		functions[i].name[0] = 0;
+		functions[i].count = 0;
+	}
+	for (i = 0; i < STACK_TABLE_SIZE; i++) {
+		folded_stacks[i].offset = -1;
+		folded_stacks[i].count = 0;
+	}
+	folded_names_used = 0;
+
+	for (i = 0; i < STACK_TABLE_SIZE; i++) {
+		const pcut_profile_sample_t *sample;
+		int line_used;
+		int frame;
+
+		if (stacks[i].sample < 0) {
+			continue;
+		}
+		sample = &samples[stacks[i].sample];
+
+		if (sample->depth > 0) {
+			describe_frame(sample, 0, name);
+			function_add(name, stacks[i].count);
+		}
+
+		if (folded_filename == NULL) {
+			continue;
+		}
+
+		line_used = pcut_snprintf(line, FOLDED_LINE_SIZE, "%s.%s",
+			pcut_get_current_suite()->name, pcut_get_current_test()->name);
+		if ((line_used < 0) || (line_used >= FOLDED_LINE_SIZE)) {
+			continue;
+		}
+		for (frame = sample->depth - 1; frame >= 0; frame--) {
+			if (line_used >= FOLDED_LINE_SIZE - PCUT_PROFILE_FUNCTION_NAME_SIZE) {
+				break;
+			}
+			describe_frame(sample, frame, name);
+			line_used += pcut_snprintf(line + line_used,
+				FOLDED_LINE_SIZE - line_used, ";%s", name);
+		}
+
+		folded_stack_add(line, stacks[i].count);
+	}
+}
+
+/** Record functions with most samples as measurements.
+ *
+ * @param total Number of stored samples.
+ */
+static void record_top_functions(int total) {
+	int reported;
+
+	for (reported = 0; reported < PCUT_PROFILE_REPORT_COUNT; reported++) {
+		char measurement[PCUT_MEASUREMENT_NAME_SIZE];
+		profile_function_t *best = NULL;
+		int i;
+
+		for (i = 0; i < FUNCTION_TABLE_SIZE; i++) {
+			if ((functions[i].count > 0)
+					&& ((best == NULL) || (functions[i].count > best->count))) {
+				best = &functions[i];
+			}
+		}
+		if (best == NULL) {
+			break;
+		}
+
+		pcut_snprintf(measurement, PCUT_MEASUREMENT_NAME_SIZE, "profile:%s",
+			best->name);
+		pcut_record_measurement(measurement,
+			100.0 * (double) best->count / (double) total, "%");
+		best->count = 0;
+	}
+}
+
+/** Append the folded stacks of the current test to the output file. */
+static void write_folded_stacks(void) {
+	char count[32];
+	FILE *output;
+	int used = 0;
+	int i;
+
+	if ((folded_filename == NULL) || (folded_names_used == 0)) {
+		return;
+	}
+
+	folded_buffer[0] = 0;
+	for (i = 0; i < STACK_TABLE_SIZE; i++) {
+		int length;
+
+		if (folded_stacks[i].offset < 0) {
+			continue;
+		}
+		length = pcut_str_size(folded_names + folded_stacks[i].offset);
+		pcut_snprintf(count, sizeof(count), " %d\n", folded_stacks[i].count);
+
+		/* Lines that do not fit are dropped. */
+		if (length + pcut_str_size(count) + 1 > PCUT_PROFILE_FOLDED_SIZE - used) {
+			continue;
+		}
+		memcpy(folded_buffer + used, folded_names + folded_stacks[i].offset,
+			length);
+		used += length;
+		used += pcut_snprintf(folded_buffer + used,
+			PCUT_PROFILE_FOLDED_SIZE - used, "%s", count);
+	}
+
+	output = fopen(folded_filename, "a");
+	if (output == NULL) {
+		return;
+	}
+	/* Single write as other tests might append concurrently. */
+	setvbuf(output, NULL, _IONBF, 0);
+	fputs(folded_buffer, output);
+	fclose(output);
+}
+
+/** Stop profiling and record the profile of the test body.
+ *
+ * Does nothing when the profiler is not running.
+ */
+void pcut_profile_end(void) {
+	int taken, stored;
+
+	if (!profiling_active) {
+		return;
+	}
+	profiling_active = 0;
+
+	taken = pcut_profiler_stop();
+	stored = taken < PCUT_PROFILE_MAX_SAMPLES ? taken : PCUT_PROFILE_MAX_SAMPLES;
+
+	pcut_record_measurement("profile-samples", (double) taken, "x");
+	if (stored == 0) {
+		return;
+	}
+
+	merge_stacks(stored);
+	symbolize_stacks();
+	write_folded_stacks();
+	record_top_functions(stored);
+}
@@ -0,0 +1,578 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Append-only journal of completed tests for resuming interrupted runs.
+ *
+ * Each completed test is appended as a single line with a JSON object:
+ * @code
+ * {"suite":"S","test":"T","outcome":0,"error":"","teardown-error":"",
+ *  "output":"","measurements":[["duration",1234,"ns"]]}
+ * @endcode
+ *
+ * Tests are reported in the list order (even when run in parallel),
+ * thus the journal is always in the list order too.
+ * That allows resuming by reading the journal sequentially alongside
+ * the test list: a test whose record is next in the journal is not run
+ * but its recorded result is reported instead.
+ * An incomplete last line (the run was killed while writing it) is
+ * ignored.
+ */
+
+#include "../internal.h"
+#include "report.h"
+
+#ifdef __helenos__
+#include <mem.h>
+#else
+#pragma warning(push, 0)
+#include <string.h>
+#pragma warning(pop)
+#endif
+
+#pragma warning(push, 0)
+#include <stdio.h>
+#pragma warning(pop)
+
+
+/** Maximum length of a journal line (longer records are ignored). */
+#define JOURNAL_LINE_SIZE 65536
+
+/** Size of buffers for suite and test names. */
+#define JOURNAL_NAME_SIZE 256
+
+/** Size of buffers for error messages and test output. */
+#define JOURNAL_TEXT_SIZE 8192
+
+/** Number of records to write between two synchronizations to disk. */
+int pcut_journal_sync_interval = 1;
+
+/** Parsed journal record. */
+typedef struct {
+	/** Name of the suite. */
+	char suite[JOURNAL_NAME_SIZE];
+	/** Name of the test. */
+	char test[JOURNAL_NAME_SIZE];
+	/** Test outcome. */
+	int outcome;
+	/** Error message. */
+	char error[JOURNAL_TEXT_SIZE];
+	/** Error message from the tear-down function. */
+	char teardown_error[JOURNAL_TEXT_SIZE];
+	/** Standard output of the test. */
+	char output[JOURNAL_TEXT_SIZE];
+	/** Measurements. */
+	pcut_measurements_t measurements;
+} journal_record_t;
+
+/** Where new records are appended. */
+static FILE *journal_output = NULL;
+
+/** Journal from the interrupted run (NULL when not resuming). */
+static FILE *journal_input = NULL;
+
+/** Size of the journal before this run started appending to it. */
+static long journal_input_end;
+
+/** Line buffer for reading. */
+static char journal_line[JOURNAL_LINE_SIZE];
+
+/** Next record from the journal that was not replayed yet. */
+static journal_record_t next_record;
+
+/** Whether next_record is valid. */
+static int next_record_valid = 0;
+
+/** Records written since last synchronization. */
+static int records_since_sync;
+
+/** Currently running suite. */
+static pcut_item_t *current_suite;
+
+/** Replayed tests that were not reported yet (ring buffer).
+ *
+ * Results of these tests are already in the journal and must not be
+ * appended again.
+ */
+static pcut_item_t *replayed_tests[PCUT_REORDER_MAX_WINDOW];
+
+/** Index of the oldest replayed test. */
+static int replayed_head;
+
+/** Number of replayed tests that were not reported yet. */
+static int replayed_count;
+
+/** Write a string as a JSON string literal.
+ *
+ * @param output Where to write.
+ * @param str String to write (NULL is written as an empty string).
+ */
+static void write_json_string(FILE *output, const char *str) {
+	fputc('"', output);
+	for (; (str != NULL) && (*str != 0); str++) {
+		unsigned char c = (unsigned char) *str;
+		if ((c == '"') || (c == '\\')) {
+			fputc('\\', output);
+			fputc(c, output);
+		} else if (c == '\n') {
+			fputs("\\n", output);
+		} else if (c == '\t') {
+			fputs("\\t", output);
+		} else if (c < 0x20) {
+			fprintf(output, "\\u%04x", c);
+		} else {
+			fputc(c, output);
+		}
+	}
+	fputc('"', output);
+}
+
+/** Skip whitespace.
+ *
+ * @param it Current position in the line.
+ * @return First non-whitespace character.
+ */
+static const char *skip_spaces(const char *it) {
+	while ((*it == ' ') || (*it == '\t') || (*it == '\r') || (*it == '\n')) {
+		it++;
+	}
+	return it;
+}
+
+/** Parse JSON string literal.
+ *
+ * @param it Position of the opening quote.
+ * @param buffer Where to store the decoded string (truncated if needed).
+ * @param size Size of @p buffer in bytes.
+ * @return Position after the closing quote.
+ * @retval NULL Malformed string.
+ */
+static const char *parse_json_string(const char *it, char *buffer, size_t size) {
+	size_t used = 0;
+
+	if (*it != '"') {
+		return NULL;
+	}
+	it++;
+
+	while (*it != '"') {
+		char c = *it;
+		if (c == 0) {
+			return NULL;
+		}
+		if (c == '\\') {
+			it++;
+			switch (*it) {
+			case 'n':
+				c = '\n';
+				break;
+			case 't':
+				c = '\t';
+				break;
+			case 'r':
+				c = '\r';
+				break;
+			case 'u':
+				if (pcut_str_size(it) < 5) {
+					return NULL;
+				}
+				{
+					char hex[5];
+					memcpy(hex, it + 1, 4);
+					hex[4] = 0;
+					c = (char) strtol(hex, NULL, 16);
+				}
+				it += 4;
+				break;
+			case 0:
+				return NULL;
+			default:
+				c = *it;
+				break;
+			}
+		}
+		if (used + 1 < size) {
+			buffer[used++] = c;
+		}
+		it++;
+	}
+	buffer[used] = 0;
+
+	return it + 1;
+}
+
+/** Parse list of measurements.
+ *
+ * @param it Position of the opening bracket.
+ * @param measurements Where to store the measurements.
+ * @return Position after the closing bracket.
+ * @retval NULL Malformed list.
+ */
+static const char *parse_json_measurements(const char *it,
+		pcut_measurements_t *measurements) {
+	if (*it != '[') {
+		return NULL;
+	}
+	it = skip_spaces(it + 1);
+
+	while (*it == '[') {
+		char name[PCUT_MEASUREMENT_NAME_SIZE];
+		char unit[PCUT_MEASUREMENT_UNIT_SIZE];
+		char *value_end;
+		double value;
+
+		it = parse_json_string(skip_spaces(it + 1), name, PCUT_MEASUREMENT_NAME_SIZE);
+		if ((it == NULL) || (*(it = skip_spaces(it)) != ',')) {
+			return NULL;
+		}
+		value = strtod(skip_spaces(it + 1), &value_end);
+		it = skip_spaces(value_end);
+		if (*it != ',') {
+			return NULL;
+		}
+		it = parse_json_string(skip_spaces(it + 1), unit, PCUT_MEASUREMENT_UNIT_SIZE);
+		if ((it == NULL) || (*(it = skip_spaces(it)) != ']')) {
+			return NULL;
+		}
+		pcut_measurements_add(measurements, name, value, unit);
+
+		it = skip_spaces(it + 1);
+		if (*it == ',') {
+			it = skip_spaces(it + 1);
+		}
+	}
+
+	if (*it != ']') {
+		return NULL;
+	}
+	return it + 1;
+}
+
+/** Parse one journal line.
+ *
+ * Unknown keys are skipped when they have a string or number value.
+ *
+ * @param line The line.
+ * @param record Where to store the parsed record.
+ * @return Whether the line is a valid record.
+ */
+static int parse_record(const char *line, journal_record_t *record) {
+	const char *it = skip_spaces(line);
+	int has_test = 0;
+	int has_outcome = 0;
+
+	record->suite[0] = 0;
+	record->error[0] = 0;
+	record->teardown_error[0] = 0;
+	record->output[0] = 0;
+	pcut_measurements_clear(&record->measurements);
+
+	if (*it != '{') {
+		return 0;
+	}
+	it = skip_spaces(it + 1);
+
+	while (*it == '"') {
+		char key[JOURNAL_NAME_SIZE];
+		it = parse_json_string(it, key, JOURNAL_NAME_SIZE);
+		if ((it == NULL) || (*(it = skip_spaces(it)) != ':')) {
+			return 0;
+		}
+		it = skip_spaces(it + 1);
+
+		if (pcut_str_equals(key, "suite")) {
+			it = parse_json_string(it, record->suite, JOURNAL_NAME_SIZE);
+		} else if (pcut_str_equals(key, "test")) {
+			it = parse_json_string(it, record->test, JOURNAL_NAME_SIZE);
+			has_test = 1;
+		} else if (pcut_str_equals(key, "error")) {
+			it = parse_json_string(it, record->error, JOURNAL_TEXT_SIZE);
+		} else if (pcut_str_equals(key, "teardown-error")) {
+			it = parse_json_string(it, record->teardown_error, JOURNAL_TEXT_SIZE);
+		} else if (pcut_str_equals(key, "output")) {
+			it = parse_json_string(it, record->output, JOURNAL_TEXT_SIZE);
+		} else if (pcut_str_equals(key, "measurements")) {
+			it = parse_json_measurements(it, &record->measurements);
+		} else if (*it == '"') {
+			char ignored[JOURNAL_NAME_SIZE];
+			it = parse_json_string(it, ignored, JOURNAL_NAME_SIZE);
+		} else {
+			char *value_end;
+			double value = strtod(it, &value_end);
+			if (value_end == it) {
+				return 0;
+			}
+			if (pcut_str_equals(key, "outcome")) {
+				record->outcome = (int) value;
+				has_outcome = 1;
+			}
+			it = value_end;
+		}
+
+		if (it == NULL) {
+			return 0;
+		}
+		it = skip_spaces(it);
+		if (*it == ',') {
+			it = skip_spaces(it + 1);
+		}
+	}
+
+	return (*it == '}') && has_test && has_outcome;
+}
+
+/** Read next valid record from the journal being resumed.
+ *
+ * Only the part of the journal written before this run is read.
+ */
+static void read_next_record(void) {
+	next_record_valid = 0;
+
+	while (journal_input != NULL) {
+		size_t length;
+
+		if ((ftell(journal_input) >= journal_input_end)
+				|| (fgets(journal_line, JOURNAL_LINE_SIZE, journal_input) == NULL)) {
+			fclose(journal_input);
+			journal_input = NULL;
+			return;
+		}
+
+		length = pcut_str_size(journal_line);
+		if ((length == 0) || (journal_line[length - 1] != '\n')) {
+			/* Too long line (skip the rest) or truncated last one. */
+			while ((length > 0) && (journal_line[length - 1] != '\n')) {
+				if (fgets(journal_line, JOURNAL_LINE_SIZE, journal_input) == NULL) {
+					break;
+				}
+				length = pcut_str_size(journal_line);
+			}
+			continue;
+		}
+
+		if (parse_record(journal_line, &next_record)) {
+			next_record_valid = 1;
+			return;
+		}
+	}
+}
+
+/** Open the journal.
+ *
+ * @param filename Path to the journal.
+ * @param resume Whether to resume from an existing journal.
+ * @return Whether the journal was opened.
+ */
+int pcut_journal_open(const char *filename, int resume) {
+	int needs_new_line = 0;
+
+	replayed_head = 0;
+	replayed_count = 0;
+	records_since_sync = 0;
+
+	if (resume) {
+		journal_input = fopen(filename, "rb");
+	}
+	if (journal_input != NULL) {
+		fseek(journal_input, 0, SEEK_END);
+		journal_input_end = ftell(journal_input);
+		if (journal_input_end > 0) {
+			fseek(journal_input, -1, SEEK_END);
+			needs_new_line = fgetc(journal_input) != '\n';
+		}
+		fseek(journal_input, 0, SEEK_SET);
+		read_next_record();
+	}
+
+	journal_output = fopen(filename, resume ? "ab" : "wb");
+	if (journal_output == NULL) {
+		return 0;
+	}
+
+	/* Terminate the truncated record so that it stays on its own line. */
+	if (needs_new_line) {
+		fputc('\n', journal_output);
+		fflush(journal_output);
+	}
+
+	return 1;
+}
+
+/** Append text to the unparsed test output.
+ *
+ * @param output The unparsed output (zero-filled).
+ * @param output_size Size of @p output in bytes.
+ * @param used Number of bytes already used in @p output.
+ * @param record_type Record type (PCUT_RECORD_*) or zero for standard output.
+ * @param text Text to append (nothing is appended when empty).
+ * @return Number of used bytes after appending.
+ */
+static size_t append_output(char *output, size_t output_size, size_t used,
+		char record_type, const char *text) {
+	size_t length = pcut_str_size(text);
+	size_t prefix = record_type == 0 ? 0 : 4;
+
+	if (length == 0) {
+		return used;
+	}
+	/* Keep the terminating zero. */
+	if (used + prefix + length + 2 > output_size) {
+		return used;
+	}
+
+	/* Record prefix is three zeros and the record type. */
+	if (record_type != 0) {
+		output[used + 3] = record_type;
+	}
+	used += prefix;
+	memcpy(output + used, text, length);
+	used += length;
+
+	/* Zero separating this text from the next one. */
+	return used + 1;
+}
+
+/** Report recorded result of a test instead of running it.
+ *
+ * The result is stored in the same form as the output of a forked
+ * test so that it can be reported with pcut_report_test_done_unparsed().
+ *
+ * @param suite Suite the test belongs to.
+ * @param test The test.
+ * @param output Where to store the unparsed output (zero-padded).
+ * @param output_size Size of @p output in bytes.
+ * @param measurements Where to store the recorded measurements.
+ * @return Outcome of the recorded test.
+ * @retval -1 The test is not in the journal and needs to be run.
+ */
+int pcut_journal_replay(pcut_item_t *suite, pcut_item_t *test,
+		char *output, size_t output_size, pcut_measurements_t *measurements) {
+	size_t used;
+	int outcome;
+
+	if (!next_record_valid || (replayed_count >= PCUT_REORDER_MAX_WINDOW)) {
+		return -1;
+	}
+	if (!pcut_str_equals(next_record.test, test->name)
+			|| !pcut_str_equals(next_record.suite, suite == NULL ? "" : suite->name)) {
+		return -1;
+	}
+
+	memset(output, 0, output_size);
+	used = append_output(output, output_size, 0, 0, next_record.output);
+	used = append_output(output, output_size, used, PCUT_RECORD_ERROR,
+		next_record.error);
+	append_output(output, output_size, used, PCUT_RECORD_ERROR,
+		next_record.teardown_error);
+	*measurements = next_record.measurements;
+	outcome = next_record.outcome;
+
+	replayed_tests[(replayed_head + replayed_count) % PCUT_REORDER_MAX_WINDOW] = test;
+	replayed_count++;
+
+	read_next_record();
+
+	return outcome;
+}
+
+/** Note that a new suite has started.
+ *
+ * @param suite The suite.
+ */
+void pcut_journal_suite_start(pcut_item_t *suite) {
+	current_suite = suite;
+}
+
+/** Append completed test to the journal.
+ *
+ * @param test Test that just finished.
+ * @param outcome Outcome of the test.
+ * @param error_message Buffer with error message.
+ * @param teardown_error_message Buffer with error message from a tear-down function.
+ * @param extra_output Extra output from the test (stdout).
+ * @param measurements Values measured during the test (can be NULL).
+ */
+void pcut_journal_test_done(pcut_item_t *test, int outcome,
+		const char *error_message, const char *teardown_error_message,
+		const char *extra_output, const pcut_measurements_t *measurements) {
+	int i;
+
+	if ((replayed_count > 0) && (replayed_tests[replayed_head] == test)) {
+		replayed_head = (replayed_head + 1) % PCUT_REORDER_MAX_WINDOW;
+		replayed_count--;
+		return;
+	}
+
+	if (journal_output == NULL) {
+		return;
+	}
+
+	fprintf(journal_output, "{\"suite\":");
+	write_json_string(journal_output, current_suite == NULL ? "" : current_suite->name);
+	fprintf(journal_output, ",\"test\":");
+	write_json_string(journal_output, test->name);
+	fprintf(journal_output, ",\"outcome\":%d,\"error\":", outcome);
+	write_json_string(journal_output, error_message);
+	fprintf(journal_output, ",\"teardown-error\":");
+	write_json_string(journal_output, teardown_error_message);
+	fprintf(journal_output, ",\"output\":");
+	write_json_string(journal_output, extra_output);
+	fprintf(journal_output, ",\"measurements\":[");
+	for (i = 0; (measurements != NULL) && (i < measurements->count); i++) {
+		fprintf(journal_output, "%s[", i > 0 ? "," : "");
+		write_json_string(journal_output, measurements->items[i].name);
+		fprintf(journal_output, ",%.17g,", measurements->items[i].value);
+		write_json_string(journal_output, measurements->items[i].unit);
+		fprintf(journal_output, "]");
+	}
+	fprintf(journal_output, "]}\n");
+
+	/* Always flush, forked tests would inherit the buffer otherwise. */
+	fflush(journal_output);
+
+	records_since_sync++;
+	if ((pcut_journal_sync_interval > 0)
+			&& (records_since_sync >= pcut_journal_sync_interval)) {
+		pcut_sync_file(journal_output);
+		records_since_sync = 0;
+	}
+}
+
+/** Close the journal. */
+void pcut_journal_done(void) {
+	if (journal_input != NULL) {
+		fclose(journal_input);
+		journal_input = NULL;
+	}
+	if (journal_output != NULL) {
+		pcut_sync_file(journal_output);
+		fclose(journal_output);
+		journal_output = NULL;
+	}
+}
@@ -0,0 +1,580 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Live progress line and history of test durations.
+ *
+ * The progress line is drawn on the terminal while the report itself
+ * goes to a file.
+ * The line is redrawn at most once per PROGRESS_REFRESH_INTERVAL
+ * regardless of how fast the tests finish.
+ *
+ * Durations from previous runs (the history) are kept in a fixed-size
+ * hash table keyed by the hash of the full test name and are used
+ * to estimate the remaining time.
+ * The new history is written to a temporary file that replaces the
+ * old one once the run is over, entries of tests that were not run
+ * this time are carried over from the old file.
+ */
+
+#include "../internal.h"
+#include "report.h"
+
+#pragma warning(push, 0)
+#include <stdio.h>
+#pragma warning(pop)
+
+
+/** Minimal delay between two redraws of the progress line (in ns). */
+#define PROGRESS_REFRESH_INTERVAL 200000000ULL
+
+/** Maximum width of the progress line. */
+#define PROGRESS_LINE_SIZE 80
+
+/** Number of slots in the history table (must be a power of two). */
+#define HISTORY_TABLE_SIZE 8192
+
+/** Maximum length of a line in the history file. */
+#define HISTORY_LINE_SIZE 512
+
+/** Suffix of the temporary history file. */
+#define HISTORY_TEMP_SUFFIX ".tmp"
+
+/** Single record in the history table. */
+typedef struct {
+	/** Hash of the full test name (zero marks an empty slot). */
+	unsigned long long hash;
+	/** Duration of the test in nanoseconds. */
+	double duration;
+	/** Whether the test was already written to the new history. */
+	int updated;
+} history_entry_t;
+
+/** Durations from previous runs. */
+static history_entry_t history[HISTORY_TABLE_SIZE];
+
+/** File with durations from previous runs (NULL when not used). */
+static const char *history_filename = NULL;
+
+/** Temporary file where durations of this run are written. */
+static char history_temp_filename[HISTORY_LINE_SIZE];
+
+/** Opened history_temp_filename. */
+static FILE *history_output = NULL;
+
+/** Where to draw the progress line (NULL disables it). */
+static FILE *terminal = NULL;
+
+/** Total number of tests to be run. */
+static int total_count;
+
+/** Number of completed tests. */
+static int completed_count;
+
+/** Number of failed tests. */
+static int failed_count;
+
+/** Number of tests currently in progress. */
+static int running_count;
+
+/** Number of tests running concurrently but not reported yet. */
+static int in_flight_count;
+
+/** Time when the run started. */
+static unsigned long long start_time;
+
+/** Time of the last redraw of the progress line. */
+static unsigned long long last_redraw_time;
+
+/** Length of the last drawn progress line. */
+static int last_line_length;
+
+/** Currently running suite. */
+static pcut_item_t *current_suite;
+
+/** Sum of historical durations of tests not completed yet. */
+static double expected_remaining_time;
+
+/** Number of tests not completed yet that have no history. */
+static int unknown_remaining_count;
+
+/** Sum of durations of completed tests. */
+static double completed_time;
+
+/** Number of completed tests with known duration. */
+static int completed_measured_count;
+
+/** Offset basis of the FNV-1a hash. */
+#define HASH_OFFSET_BASIS 14695981039346656037ULL
+
+/** Append string to a FNV-1a hash.
+ *
+ * @param hash Hash computed so far.
+ * @param str String to append.
+ * @return Updated hash.
+ */
+static unsigned long long hash_append(unsigned long long hash, const char *str) {
+	for (; *str != 0; str++) {
+		hash = (hash ^ (unsigned char) *str) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+/** Compute hash of full test name.
+ *
+ * @param suite Suite the test belongs to (can be NULL).
+ * @param name Name of the test.
+ * @return Non-zero hash of suite.name.
+ */
+static unsigned long long hash_test_name(pcut_item_t *suite, const char *name) {
+	unsigned long long hash = HASH_OFFSET_BASIS;
+	if (suite != NULL) {
+		hash = hash_append(hash, suite->name);
+	}
+	hash = hash_append(hash_append(hash, "."), name);
+
+	return hash == 0 ? 1 : hash;
+}
+
+/** Find slot in the history table.
+ *
+ * @param hash Hash of the test name.
+ * @return Slot with the given hash or the empty slot where it belongs.
+ * @retval NULL The table is full.
+ */
+static history_entry_t *history_find_slot(unsigned long long hash) {
+	unsigned long long index = hash & (HISTORY_TABLE_SIZE - 1);
+	int probes;
+
+	for (probes = 0; probes < HISTORY_TABLE_SIZE; probes++) {
+		if ((history[index].hash == hash) || (history[index].hash == 0)) {
+			return &history[index];
+		}
+		index = (index + 1) & (HISTORY_TABLE_SIZE - 1);
+	}
+
+	return NULL;
+}
+
+/** Get historical duration of a test.
+ *
+ * @param suite Suite the test belongs to.
+ * @param test The test.
+ * @return Duration in nanoseconds.
+ * @retval -1 The test has no history.
+ */
+static double history_get(pcut_item_t *suite, pcut_item_t *test) {
+	history_entry_t *entry = history_find_slot(hash_test_name(suite, test->name));
+	if ((entry == NULL) || (entry->hash == 0)) {
+		return -1;
+	}
+	return entry->duration;
+}
+
+/** Parse one line of the history file.
+ *
+ * Each line contains full test name (suite.test) and its duration
+ * in nanoseconds.
+ *
+ * @param line The line (it is modified).
+ * @param hash Where to store hash of the test name.
+ * @param duration Where to store the duration.
+ * @return Whether the line is valid.
+ */
+static int history_parse_line(char *line, unsigned long long *hash,
+		double *duration) {
+	char *separator = pcut_str_find_char(line, ' ');
+	if (separator == NULL) {
+		return 0;
+	}
+	*separator = 0;
+	*duration = strtod(separator + 1, NULL);
+	if (*duration < 0) {
+		return 0;
+	}
+
+	*hash = hash_append(HASH_OFFSET_BASIS, line);
+	if (*hash == 0) {
+		*hash = 1;
+	}
+	return 1;
+}
+
+/** Load history from a file.
+ *
+ * Missing file is not an error (the history is simply empty).
+ *
+ * @param filename File to read.
+ */
+static void history_load(const char *filename) {
+	char line[HISTORY_LINE_SIZE];
+	FILE *input = fopen(filename, "r");
+	if (input == NULL) {
+		return;
+	}
+
+	while (fgets(line, HISTORY_LINE_SIZE, input) != NULL) {
+		history_entry_t *entry;
+		unsigned long long hash;
+		double duration;
+		if (!history_parse_line(line, &hash, &duration)) {
+			continue;
+		}
+
+		entry = history_find_slot(hash);
+		if (entry == NULL) {
+			break;
+		}
+		entry->hash = hash;
+		entry->duration = duration;
+		entry->updated = 0;
+	}
+
+	fclose(input);
+}
+
+/** Copy entries of tests that were not run from the old history.
+ *
+ * @param filename The old history file.
+ * @param output Where to copy the entries.
+ */
+static void history_carry_over(const char *filename, FILE *output) {
+	char line[HISTORY_LINE_SIZE];
+	char parsed_line[HISTORY_LINE_SIZE];
+	FILE *input = fopen(filename, "r");
+	if (input == NULL) {
+		return;
+	}
+
+	while (fgets(line, HISTORY_LINE_SIZE, input) != NULL) {
+		history_entry_t *entry;
+		unsigned long long hash;
+		double duration;
+
+		pcut_snprintf(parsed_line, HISTORY_LINE_SIZE, "%s", line);
+		if (!history_parse_line(parsed_line, &hash, &duration)) {
+			continue;
+		}
+		entry = history_find_slot(hash);
+		if ((entry != NULL) && (entry->hash == hash) && entry->updated) {
+			continue;
+		}
+		fputs(line, output);
+	}
+
+	fclose(input);
+}
+
+/** Format elapsed time as [h:]mm:ss.
+ *
+ * @param buffer Where to store the formatted time.
+ * @param size Size of @p buffer in bytes.
+ * @param time Time in nanoseconds.
+ */
+static void format_clock(char *buffer, size_t size, double time) {
+	unsigned long seconds = (unsigned long) (time / 1000000000.0 + 0.5);
+	if (seconds >= 3600) {
+		pcut_snprintf(buffer, size, "%lu:%02lu:%02lu", seconds / 3600,
+			(seconds / 60) % 60, seconds % 60);
+	} else {
+		pcut_snprintf(buffer, size, "%lu:%02lu", seconds / 60, seconds % 60);
+	}
+}
+
+/** Estimate time needed to complete the remaining tests.
+ *
+ * Tests without history are expected to take the average time of
+ * the tests completed so far.
+ * When tests run concurrently, the remaining work is split among
+ * the jobs (but there cannot be more jobs than remaining tests).
+ *
+ * @return Estimated time in nanoseconds.
+ * @retval -1 Nothing is known to base the estimate on.
+ */
+static double estimate_remaining_time(void) {
+	double per_test_time;
+	int remaining_count = total_count - completed_count;
+	int jobs = 1;
+
+	if (pcut_run_mode == PCUT_RUN_MODE_FORKING) {
+		jobs = pcut_jobs;
+	}
+	if (jobs > remaining_count) {
+		jobs = remaining_count;
+	}
+	if (jobs < 1) {
+		jobs = 1;
+	}
+
+	if (unknown_remaining_count == 0) {
+		return expected_remaining_time / jobs;
+	}
+	if (completed_measured_count > 0) {
+		per_test_time = completed_time / completed_measured_count;
+	} else {
+		return -1;
+	}
+
+	return (expected_remaining_time + unknown_remaining_count * per_test_time) / jobs;
+}
+
+/** Draw the progress line.
+ *
+ * @param force Whether to ignore the refresh interval.
+ */
+static void progress_redraw(int force) {
+	char line[PROGRESS_LINE_SIZE];
+	char elapsed[PROGRESS_LINE_SIZE];
+	char eta[PROGRESS_LINE_SIZE];
+	unsigned long long now;
+	double remaining;
+	int length;
+
+	if (terminal == NULL) {
+		return;
+	}
+
+	now = pcut_timer_now();
+	if (!force && (now - last_redraw_time < PROGRESS_REFRESH_INTERVAL)) {
+		return;
+	}
+	last_redraw_time = now;
+
+	format_clock(elapsed, PROGRESS_LINE_SIZE, (double) (now - start_time));
+	remaining = estimate_remaining_time();
+	if (remaining < 0) {
+		pcut_snprintf(eta, PROGRESS_LINE_SIZE, "--:--");
+	} else {
+		format_clock(eta, PROGRESS_LINE_SIZE, remaining);
+	}
+
+	length = pcut_snprintf(line, PROGRESS_LINE_SIZE,
+		"[%d/%d] %d failed, %d running, elapsed %s, ETA %s",
+		completed_count, total_count, failed_count,
+		running_count + in_flight_count,
+		elapsed, eta);
+	if (length > PROGRESS_LINE_SIZE - 1) {
+		length = PROGRESS_LINE_SIZE - 1;
+	}
+
+	fprintf(terminal, "\r%s%*s", line,
+		last_line_length > length ? last_line_length - length : 0, "");
+	fflush(terminal);
+	last_line_length = length;
+}
+
+/** Set where to draw the progress line.
+ *
+ * @param output Terminal stream (NULL disables the progress line).
+ */
+void pcut_progress_set_terminal(FILE *output) {
+	terminal = output;
+}
+
+/** Set file with durations from previous runs.
+ *
+ * The file is read when the run starts and replaced with
+ * durations from the current run when the run is over.
+ *
+ * @param filename Path to the history file.
+ */
+void pcut_progress_set_history_file(const char *filename) {
+	history_filename = filename;
+}
+
+/** Start tracking progress of the run.
+ *
+ * @param all_items List of all tests that would be run.
+ */
+void pcut_progress_init(pcut_item_t *all_items) {
+	pcut_item_t *suite = NULL;
+	pcut_item_t *it;
+
+	if ((terminal == NULL) && (history_filename == NULL)) {
+		return;
+	}
+
+	if (history_filename != NULL) {
+		history_load(history_filename);
+		if (pcut_snprintf(history_temp_filename, HISTORY_LINE_SIZE, "%s%s",
+				history_filename, HISTORY_TEMP_SUFFIX) < HISTORY_LINE_SIZE) {
+			history_output = fopen(history_temp_filename, "w");
+		}
+	}
+
+	total_count = 0;
+	completed_count = 0;
+	failed_count = 0;
+	running_count = 0;
+	in_flight_count = 0;
+	expected_remaining_time = 0;
+	unknown_remaining_count = 0;
+	completed_time = 0;
+	completed_measured_count = 0;
+	last_line_length = 0;
+	current_suite = NULL;
+
+	for (it = pcut_get_real(all_items); it != NULL; it = pcut_get_real_next(it)) {
+		double duration;
+		if (it->kind == PCUT_KIND_TESTSUITE) {
+			suite = it;
+		}
+		if (it->kind != PCUT_KIND_TEST) {
+			continue;
+		}
+		total_count++;
+		duration = history_get(suite, it);
+		if (duration < 0) {
+			unknown_remaining_count++;
+		} else {
+			expected_remaining_time += duration;
+		}
+	}
+
+	start_time = pcut_timer_now();
+	progress_redraw(1);
+}
+
+/** Note that a new suite has started.
+ *
+ * @param suite The suite.
+ */
+void pcut_progress_suite_start(pcut_item_t *suite) {
+	current_suite = suite;
+}
+
+/** Note that a test has started.
+ *
+ * @param test The test.
+ */
+void pcut_progress_test_start(pcut_item_t *test) {
+	PCUT_UNUSED(test);
+
+	running_count++;
+	progress_redraw(0);
+}
+
+/** Set number of tests that run concurrently.
+ *
+ * Results of such tests are reported later (see reorder.c) so they
+ * are not visible through pcut_progress_test_start().
+ *
+ * @param count Number of started tests that were not reported yet.
+ */
+void pcut_progress_set_in_flight(int count) {
+	in_flight_count = count;
+	progress_redraw(0);
+}
+
+/** Note that a test was completed.
+ *
+ * @param test The test.
+ * @param outcome Outcome of the test.
+ * @param measurements Measurements of the test (can be NULL).
+ */
+void pcut_progress_test_done(pcut_item_t *test, int outcome,
+		const pcut_measurements_t *measurements) {
+	const pcut_measurement_t *duration;
+	double previous_duration;
+
+	if ((terminal == NULL) && (history_filename == NULL)) {
+		return;
+	}
+
+	if (running_count > 0) {
+		running_count--;
+	}
+	completed_count++;
+	if (outcome != PCUT_OUTCOME_PASS) {
+		failed_count++;
+	}
+
+	previous_duration = history_get(current_suite, test);
+	if (previous_duration < 0) {
+		if (unknown_remaining_count > 0) {
+			unknown_remaining_count--;
+		}
+	} else {
+		expected_remaining_time -= previous_duration;
+		if (expected_remaining_time < 0) {
+			expected_remaining_time = 0;
+		}
+	}
+
+	duration = pcut_measurements_find(measurements, "duration");
+	if (duration != NULL) {
+		completed_time += duration->value;
+		completed_measured_count++;
+
+		if (history_output != NULL) {
+			/* Smooth out the noise by averaging with the previous run. */
+			double new_duration = duration->value;
+			unsigned long long hash = hash_test_name(current_suite, test->name);
+			history_entry_t *entry = history_find_slot(hash);
+			if (previous_duration >= 0) {
+				new_duration = (new_duration + previous_duration) / 2;
+			}
+			if (entry != NULL) {
+				if (entry->hash == 0) {
+					entry->hash = hash;
+					entry->duration = new_duration;
+				}
+				entry->updated = 1;
+			}
+			fprintf(history_output, "%s.%s %.0f\n",
+				current_suite == NULL ? "" : current_suite->name,
+				test->name, new_duration);
+			/* Flush now, forked tests would inherit the buffer otherwise. */
+			fflush(history_output);
+		}
+	}
+
+	progress_redraw(0);
+}
+
+/** Finish the progress line and store the history. */
+void pcut_progress_done(void) {
+	if (history_output != NULL) {
+		history_carry_over(history_filename, history_output);
+		fclose(history_output);
+		history_output = NULL;
+
+		/* Some platforms refuse to rename over an existing file. */
+		if (rename(history_temp_filename, history_filename) != 0) {
+			remove(history_filename);
+			rename(history_temp_filename, history_filename);
+		}
+	}
+
+	if (terminal != NULL) {
+		progress_redraw(1);
+		fprintf(terminal, "\n");
+		fflush(terminal);
+	}
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Reorder buffer for reporting results of concurrently running tests.
+ *
+ * Tests acquire slots in the list order and may complete in any order.
+ * Completed results are held back until all preceding tests complete
+ * and then they are reported exactly as in a serial run (including
+ * the suite start and done brackets).
+ *
+ * The buffer has a fixed number of slots: when the oldest unreported
+ * test is still running and all slots are taken, no new test can be
+ * started until it completes.
+ */
+
+#include "../internal.h"
+#include "report.h"
+
+#ifdef __helenos__
+#include <mem.h>
+#else
+#pragma warning(push, 0)
+#include <string.h>
+#pragma warning(pop)
+#endif
+
+
+/** The slots. */
+static pcut_reorder_slot_t slots[PCUT_REORDER_MAX_WINDOW];
+
+/** Number of slots in use. */
+static int window_size;
+
+/** Sequence number of the next acquired slot. */
+static int next_acquire;
+
+/** Sequence number of the next slot to report. */
+static int next_release;
+
+/** Number of acquired but not yet completed slots. */
+static int in_flight_count;
+
+/** Suite whose start was reported last (NULL before the first test). */
+static pcut_item_t *reported_suite;
+
+/** Prepare the reorder buffer for a new run.
+ *
+ * @param window Number of slots (clamped to PCUT_REORDER_MAX_WINDOW).
+ */
+void pcut_reorder_init(int window) {
+	if (window > PCUT_REORDER_MAX_WINDOW) {
+		window = PCUT_REORDER_MAX_WINDOW;
+	}
+	if (window < 1) {
+		window = 1;
+	}
+
+	window_size = window;
+	next_acquire = 0;
+	next_release = 0;
+	in_flight_count = 0;
+	reported_suite = NULL;
+}
+
+/** Acquire slot for a test that is about to be started.
+ *
+ * Tests have to acquire the slots in the order they would be run
+ * serially.
+ *
+ * @param suite Suite the test belongs to.
+ * @param test The test.
+ * @return Slot where the test result shall be stored.
+ * @retval NULL All slots are taken, complete some tests first.
+ */
+pcut_reorder_slot_t *pcut_reorder_acquire(pcut_item_t *suite, pcut_item_t *test) {
+	pcut_reorder_slot_t *slot;
+
+	if (next_acquire - next_release >= window_size) {
+		return NULL;
+	}
+
+	slot = &slots[next_acquire % window_size];
+	next_acquire++;
+
+	slot->suite = suite;
+	slot->test = test;
+	slot->done = 0;
+	slot->outcome = PCUT_OUTCOME_INTERNAL_ERROR;
+	slot->error_message[0] = 0;
+	memset(slot->output, 0, PCUT_REORDER_OUTPUT_SIZE);
+	pcut_measurements_clear(&slot->measurements);
+
+	in_flight_count++;
+	pcut_progress_set_in_flight(in_flight_count);
+
+	return slot;
+}
+
+/** Report result stored in a slot.
+ *
+ * @param slot Completed slot.
+ */
+static void report_slot(pcut_reorder_slot_t *slot) {
+	if (slot->suite != reported_suite) {
+		if (reported_suite != NULL) {
+			pcut_report_suite_done(reported_suite);
+		}
+		pcut_report_suite_start(slot->suite);
+		reported_suite = slot->suite;
+	}
+
+	pcut_report_test_start(slot->test);
+	if (slot->error_message[0] != 0) {
+		pcut_report_test_done(slot->test, slot->outcome,
+			slot->error_message, NULL, NULL, NULL);
+	} else {
+		pcut_report_test_done_unparsed(slot->test, slot->outcome,
+			slot->output, PCUT_REORDER_OUTPUT_SIZE,
+			&slot->measurements);
+	}
+}
+
+/** Mark slot as completed and report all results that are ready.
+ *
+ * @param slot Slot with the test result (output and measurements
+ * are expected to be already filled in).
+ * @param outcome Outcome of the test.
+ */
+void pcut_reorder_complete(pcut_reorder_slot_t *slot, int outcome) {
+	slot->outcome = outcome;
+	slot->done = 1;
+
+	in_flight_count--;
+	pcut_progress_set_in_flight(in_flight_count);
+
+	while (next_release < next_acquire) {
+		pcut_reorder_slot_t *next = &slots[next_release % window_size];
+		if (!next->done) {
+			break;
+		}
+		report_slot(next);
+		next_release++;
+	}
+}
+
+/** Finish the report after all tests completed. */
+void pcut_reorder_done(void) {
+	if (reported_suite != NULL) {
+		pcut_report_suite_done(reported_suite);
+		reported_suite = NULL;
+	}
+}
@@ -32,6 +32,7 @@
  */
 
 #include "../internal.h"
+#include "report.h"
 
 #ifdef __helenos__
 #include <mem.h>
@@ -68,8 +69,9 @@ static pcut_report_ops_t *report_ops = NULL;
  *
  * NULL or empty message is silently ignored.
  *
- * The message is printed with a special 3-zero-byte prefix to be later
- * parsed when reporting the results from a different process.
+ * The message is printed with a special 3-zero-byte prefix followed
+ * by the record type (PCUT_RECORD_ERROR) to be later parsed when
+ * reporting the results from a different process.
  *
  * @param msg The message to be printed.
  */
@@ -81,7 +83,192 @@ void pcut_print_fail_message(const char *msg) {
 		return;
 	}
 
-	printf("%c%c%c%s\n%c", 0, 0, 0, msg, 0);
+	printf("%c%c%c%c%s\n%c", 0, 0, 0, PCUT_RECORD_ERROR, msg, 0);
+}
+
+/** Print a measurement so that the launcher process can parse it.
+ *
+ * Measurements use the same prefix as error messages
+ * (see pcut_print_fail_message()) with the PCUT_RECORD_MEASUREMENT type.
+ *
+ * @param name Name of the measured quantity.
+ * @param value Measured value.
+ * @param unit Unit of @p value.
+ */
+void pcut_print_measurement(const char *name, double value, const char *unit) {
+	printf("%c%c%c%c%s %.17g %s\n%c", 0, 0, 0, PCUT_RECORD_MEASUREMENT,
+		name, value, unit, 0);
+}
+
+/** Copy string into a fixed-size buffer, always terminating it.
+ *
+ * @param dest Destination buffer.
+ * @param src Source string.
+ * @param size Size of @p dest in bytes.
+ */
+static void copy_string(char *dest, const char *src, size_t size) {
+	size_t len = pcut_str_size(src);
+	if (len > size - 1) {
+		len = size - 1;
+	}
+	memcpy(dest, src, len);
+	dest[len] = 0;
+}
+
+/** Remove all measurements.
+ *
+ * @param measurements Measurements to clear.
+ */
+void pcut_measurements_clear(pcut_measurements_t *measurements) {
+	measurements->count = 0;
+}
+
+/** Append new measurement.
+ *
+ * Measurements that do not fit are silently dropped.
+ *
+ * @param measurements Where to add the new measurement.
+ * @param name Name of the measured quantity.
+ * @param value Measured value.
+ * @param unit Unit of @p value.
+ */
+void pcut_measurements_add(pcut_measurements_t *measurements,
+		const char *name, double value, const char *unit) {
+	pcut_measurement_t *it;
+
+	if (measurements->count >= PCUT_MEASUREMENT_MAX_COUNT) {
+		return;
+	}
+
+	it = &measurements->items[measurements->count];
+	copy_string(it->name, name, PCUT_MEASUREMENT_NAME_SIZE);
+	copy_string(it->unit, unit, PCUT_MEASUREMENT_UNIT_SIZE);
+	it->value = value;
+	measurements->count++;
+}
+
+/** Find measurement by its name.
+ *
+ * @param measurements Measurements to search (can be NULL).
+ * @param name Name of the measured quantity.
+ * @return First measurement with given name.
+ * @retval NULL No such measurement exists.
+ */
+const pcut_measurement_t *pcut_measurements_find(
+		const pcut_measurements_t *measurements, const char *name) {
+	int i;
+
+	if (measurements == NULL) {
+		return NULL;
+	}
+
+	for (i = 0; i < measurements->count; i++) {
+		if (pcut_str_equals(measurements->items[i].name, name)) {
+			return &measurements->items[i];
+		}
+	}
+
+	return NULL;
+}
+
+/** Parse measurement printed by pcut_print_measurement().
+ *
+ * Malformed lines are silently ignored.
+ *
+ * @param line Line with the measurement (without the zero-byte prefix).
+ * @param measurements Where to store the parsed measurement.
+ */
+static void parse_measurement(const char *line, pcut_measurements_t *measurements) {
+	char name[PCUT_MEASUREMENT_NAME_SIZE];
+	char unit[PCUT_MEASUREMENT_UNIT_SIZE];
+	const char *value_start;
+	char *value_end;
+	double value;
+	size_t len;
+
+	value_start = pcut_str_find_char(line, ' ');
+	if (value_start == NULL) {
+		return;
+	}
+	len = value_start - line;
+	if (len > PCUT_MEASUREMENT_NAME_SIZE - 1) {
+		len = PCUT_MEASUREMENT_NAME_SIZE - 1;
+	}
+	memcpy(name, line, len);
+	name[len] = 0;
+
+	value = strtod(value_start + 1, &value_end);
+	if ((value_end == value_start + 1) || (*value_end != ' ')) {
+		return;
+	}
+
+	copy_string(unit, value_end + 1, PCUT_MEASUREMENT_UNIT_SIZE);
+	len = pcut_str_size(unit);
+	if ((len > 0) && (unit[len - 1] == '\n')) {
+		unit[len - 1] = 0;
+	}
+
+	pcut_measurements_add(measurements, name, value, unit);
+}
+
+/** Format time duration in a human-readable form.
+ *
+ * @param buffer Where to store the formatted duration (including the unit).
+ * @param size Size of @p buffer in bytes.
+ * @param duration Duration in nanoseconds.
+ */
+void pcut_format_duration(char *buffer, size_t size, double duration) {
+	static const char *time_units[] = { "ns", "us", "ms", "s" };
+	int scale = 0;
+
+	while ((scale < 3) && ((duration >= 1000.0) || (duration <= -1000.0))) {
+		duration /= 1000.0;
+		scale++;
+	}
+	if ((scale == 0) && ((double) (long long) duration == duration)) {
+		pcut_snprintf(buffer, size, "%.0f ns", duration);
+	} else {
+		pcut_snprintf(buffer, size, "%.3f %s", duration, time_units[scale]);
+	}
+}
+
+/** Format measurement value in a human-readable form.
+ *
+ * Times in nanoseconds are converted to a more suitable unit and
+ * rates (units ending with /s) get a metric prefix.
+ *
+ * @param buffer Where to store the formatted value (including the unit).
+ * @param size Size of @p buffer in bytes.
+ * @param measurement Measurement to format.
+ */
+void pcut_format_measurement(char *buffer, size_t size,
+		const pcut_measurement_t *measurement) {
+	static const char *rate_prefixes[] = { "", "k", "M", "G", "T" };
+	double value = measurement->value;
+	const char *unit = measurement->unit;
+	int unit_len = pcut_str_size(unit);
+	int scale = 0;
+
+	if (pcut_str_equals(unit, "ns")) {
+		pcut_format_duration(buffer, size, value);
+		return;
+	}
+
+	if ((unit_len > 2) && pcut_str_equals(unit + unit_len - 2, "/s")) {
+		while ((scale < 4) && (value >= 1000.0)) {
+			value /= 1000.0;
+			scale++;
+		}
+		pcut_snprintf(buffer, size, "%.3f %s%s", value,
+				rate_prefixes[scale], unit);
+		return;
+	}
+
+	if ((double) (long long) value == value) {
+		pcut_snprintf(buffer, size, "%lld %s", (long long) value, unit);
+	} else {
+		pcut_snprintf(buffer, size, "%.3f %s", value, unit);
+	}
 }
 
 /** Size of buffer for storing error messages or extra test output. */
@@ -101,10 +288,12 @@ static char buffer_for_error_messages[BUFFER_SIZE];
  * @param stdio_buffer_size Size of @p stdio_buffer in bytes.
  * @param error_buffer Where to store error messages from the test.
  * @param error_buffer_size Size of @p error_buffer in bytes.
+ * @param measurements Where to store measurements from the test.
  */
 static void parse_command_output(const char *full_output, size_t full_output_size,
 		char *stdio_buffer, size_t stdio_buffer_size,
-		char *error_buffer, size_t error_buffer_size) {
+		char *error_buffer, size_t error_buffer_size,
+		pcut_measurements_t *measurements) {
 	memset(stdio_buffer, 0, stdio_buffer_size);
 	memset(error_buffer, 0, error_buffer_size);
 
@@ -131,6 +320,10 @@ static void parse_command_output(const char *full_output, size_t full_output_siz
 		/* Determine the length of the text after the zeros. */
 		message_length = pcut_str_size(full_output);
 
+		/*
+		 * Records have three zeros in front but the first one might
+		 * have been consumed as the terminator of the previous text.
+		 */
 		if (cont_zeros_count < 2) {
 			/* Okay, standard I/O. */
 			if (message_length > stdio_buffer_size) {
@@ -140,15 +333,23 @@ static void parse_command_output(const char *full_output, size_t full_output_siz
 			memcpy(stdio_buffer, full_output, message_length);
 			stdio_buffer += message_length;
 			stdio_buffer_size -= message_length;
+		} else if (full_output[0] == PCUT_RECORD_MEASUREMENT) {
+			parse_measurement(full_output + 1, measurements);
 		} else {
-			/* Error message. */
-			if (message_length > error_buffer_size) {
+			/* Error message (skip the record type). */
+			const char *message = full_output;
+			size_t length = message_length;
+			if (message[0] == PCUT_RECORD_ERROR) {
+				message++;
+				length--;
+			}
+			if (length > error_buffer_size) {
 				/* TODO: handle gracefully */
 				return;
 			}
-			memcpy(error_buffer, full_output, message_length);
-			error_buffer += message_length;
-			error_buffer_size -= message_length;
+			memcpy(error_buffer, message, length);
+			error_buffer += length;
+			error_buffer_size -= length;
 		}
 
 		full_output += message_length + 1;
@@ -169,14 +370,27 @@ void pcut_report_register_handler(pcut_report_ops_t *ops) {
  * @param all_items List of all tests that could be run.
  */
 void pcut_report_init(pcut_item_t *all_items) {
+	pcut_summary_init();
+	pcut_progress_init(all_items);
 	REPORT_CALL(init, all_items);
 }
 
+/** Report conditions the benchmarks run in.
+ *
+ * @param environment Information about the processors.
+ */
+void pcut_report_environment(const pcut_cpu_environment_t *environment) {
+	REPORT_CALL(environment, environment);
+}
+
 /** Report that a test suite was started.
  *
  * @param suite Suite that was just started.
  */
 void pcut_report_suite_start(pcut_item_t *suite) {
+	pcut_summary_suite_start(suite);
+	pcut_progress_suite_start(suite);
+	pcut_journal_suite_start(suite);
 	REPORT_CALL(suite_start, suite);
 }
 
@@ -185,6 +399,7 @@ void pcut_report_suite_start(pcut_item_t *suite) {
  * @param suite Suite that just completed.
  */
 void pcut_report_suite_done(pcut_item_t *suite) {
+	pcut_summary_suite_done(suite);
 	REPORT_CALL(suite_done, suite);
 }
 
@@ -193,6 +408,7 @@ void pcut_report_suite_done(pcut_item_t *suite) {
  * @param test Test to be run just about now.
  */
 void pcut_report_test_start(pcut_item_t *test) {
+	pcut_progress_test_start(test);
 	REPORT_CALL(test_start, test);
 }
 
@@ -203,12 +419,17 @@ void pcut_report_test_start(pcut_item_t *test) {
  * @param error_message Buffer with error message.
  * @param teardown_error_message Buffer with error message from a tear-down function.
  * @param extra_output Extra output from the test (stdout).
+ * @param measurements Values measured during the test (can be NULL).
  */
 void pcut_report_test_done(pcut_item_t *test, int outcome,
 		const char *error_message, const char *teardown_error_message,
-		const char *extra_output) {
+		const char *extra_output, const pcut_measurements_t *measurements) {
+	pcut_summary_test_done(test, measurements);
+	pcut_progress_test_done(test, outcome, measurements);
+	pcut_journal_test_done(test, outcome, error_message, teardown_error_message,
+			extra_output, measurements);
 	REPORT_CALL(test_done, test, outcome, error_message, teardown_error_message,
-			extra_output);
+			extra_output, measurements);
 }
 
 /** Report that a test was completed with unparsed test output.
@@ -217,21 +438,29 @@ void pcut_report_test_done(pcut_item_t *test, int outcome,
  * @param outcome Outcome of the test.
  * @param unparsed_output Buffer with all the output from the test.
  * @param unparsed_output_size Size of @p unparsed_output in bytes.
+ * @param measurements Measurements made by the launcher, measurements
+ * found in @p unparsed_output are appended to them.
  */
 void pcut_report_test_done_unparsed(pcut_item_t *test, int outcome,
-		const char *unparsed_output, size_t unparsed_output_size) {
+		const char *unparsed_output, size_t unparsed_output_size,
+		pcut_measurements_t *measurements) {
 
 	parse_command_output(unparsed_output, unparsed_output_size,
 			buffer_for_extra_output, BUFFER_SIZE,
-			buffer_for_error_messages, BUFFER_SIZE);
+			buffer_for_error_messages, BUFFER_SIZE,
+			measurements);
 
-	pcut_report_test_done(test, outcome, buffer_for_error_messages, NULL, buffer_for_extra_output);
+	pcut_report_test_done(test, outcome, buffer_for_error_messages, NULL,
+			buffer_for_extra_output, measurements);
 }
 
 /** Close the report.
  *
  */
 void pcut_report_done(void) {
+	pcut_summary_done();
 	REPORT_CALL_NO_ARGS(done);
+	pcut_progress_done();
+	pcut_journal_done();
 }
 
@@ -36,10 +36,71 @@
 
 #include "../internal.h"
 
+#pragma warning(push, 0)
+#include <stdio.h>
+#pragma warning(pop)
+
 /** Reporting functions for the test-anything-protocol. */
 extern pcut_report_ops_t pcut_report_tap;
 
 /** Reporting functions for XML report output. */
 extern pcut_report_ops_t pcut_report_xml;
 
+/** Number of buckets of the duration histogram. */
+#define PCUT_SUMMARY_HISTOGRAM_SIZE 64
+
+/** Entry in the list of slowest tests (suites). */
+typedef struct {
+	/** The test (or suite). */
+	pcut_item_t *item;
+	/** Suite the test belongs to (NULL for suites). */
+	pcut_item_t *suite;
+	/** Total duration as seen by the launcher in nanoseconds. */
+	double duration;
+	/** Duration of the test body only (negative when unknown). */
+	double body_time;
+} pcut_summary_entry_t;
+
+/** Timing statistics of the whole run. */
+typedef struct {
+	/** Wall-clock time of the whole run in nanoseconds. */
+	double wall_time;
+	/** Sum of durations of individual tests. */
+	double tests_time;
+	/** Sum of durations of test bodies. */
+	double body_time;
+	/** Number of tests with known duration. */
+	int test_count;
+	/** Histogram of test durations. */
+	int histogram[PCUT_SUMMARY_HISTOGRAM_SIZE];
+} pcut_summary_totals_t;
+
+void pcut_summary_init(void);
+void pcut_summary_suite_start(pcut_item_t *suite);
+void pcut_summary_suite_done(pcut_item_t *suite);
+void pcut_summary_test_done(pcut_item_t *test,
+		const pcut_measurements_t *measurements);
+void pcut_summary_done(void);
+
+int pcut_summary_get_slowest_tests(pcut_summary_entry_t **entries);
+int pcut_summary_get_slowest_suites(pcut_summary_entry_t **entries);
+const pcut_summary_totals_t *pcut_summary_get_totals(void);
+double pcut_summary_histogram_bucket_start(int bucket);
+
+void pcut_progress_set_terminal(FILE *output);
+void pcut_progress_set_history_file(const char *filename);
+void pcut_progress_init(pcut_item_t *all_items);
+void pcut_progress_suite_start(pcut_item_t *suite);
+void pcut_progress_test_start(pcut_item_t *test);
+void pcut_progress_set_in_flight(int count);
+void pcut_progress_test_done(pcut_item_t *test, int outcome,
+		const pcut_measurements_t *measurements);
+void pcut_progress_done(void);
+
+void pcut_journal_suite_start(pcut_item_t *suite);
+void pcut_journal_test_done(pcut_item_t *test, int outcome,
+		const char *error_message, const char *teardown_error_message,
+		const char *extra_output, const pcut_measurements_t *measurements);
+void pcut_journal_done(void);
+
 #endif
@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Collection of timing statistics for the end-of-run summary.
+ *
+ * Slowest tests and suites are kept in fixed-size min-heaps so that
+ * the collection has constant cost per test regardless of the number
+ * of tests.
+ */
+
+#include "../internal.h"
+#include "report.h"
+
+
+/** Fixed-size min-heap of the slowest items. */
+typedef struct {
+	/** Number of valid entries. */
+	int size;
+	/** Heap entries, entries[0] is the fastest one. */
+	pcut_summary_entry_t entries[PCUT_SUMMARY_MAX_SIZE];
+} slowest_heap_t;
+
+/** Slowest tests. */
+static slowest_heap_t slowest_tests;
+
+/** Slowest suites. */
+static slowest_heap_t slowest_suites;
+
+/** Overall statistics. */
+static pcut_summary_totals_t totals;
+
+/** Time when the run started. */
+static unsigned long long run_start_time;
+
+/** Currently running suite. */
+static pcut_item_t *current_suite;
+
+/** Accumulated duration of the current suite. */
+static double current_suite_duration;
+
+/** Accumulated body duration of the current suite (negative when unknown). */
+static double current_suite_body_time;
+
+/** Swap two heap entries.
+ *
+ * @param a First entry.
+ * @param b Second entry.
+ */
+static void swap_entries(pcut_summary_entry_t *a, pcut_summary_entry_t *b) {
+	pcut_summary_entry_t tmp = *a;
+	*a = *b;
+	*b = tmp;
+}
+
+/** Restore the heap property downwards from given index.
+ *
+ * @param heap The heap.
+ * @param index Index of the entry that might violate the heap property.
+ */
+static void heap_sift_down(slowest_heap_t *heap, int index) {
+	while (1) {
+		int smallest = index;
+		int left = 2 * index + 1;
+		int right = 2 * index + 2;
+
+		if ((left < heap->size) && (heap->entries[left].duration < heap->entries[smallest].duration)) {
+			smallest = left;
+		}
+		if ((right < heap->size) && (heap->entries[right].duration < heap->entries[smallest].duration)) {
+			smallest = right;
+		}
+		if (smallest == index) {
+			return;
+		}
+		swap_entries(&heap->entries[index], &heap->entries[smallest]);
+		index = smallest;
+	}
+}
+
+/** Offer a new entry to the heap of slowest items.
+ *
+ * @param heap The heap.
+ * @param entry New entry (copied).
+ */
+static void heap_offer(slowest_heap_t *heap, const pcut_summary_entry_t *entry) {
+	int index;
+
+	if (heap->size < pcut_summary_size) {
+		index = heap->size;
+		heap->entries[index] = *entry;
+		heap->size++;
+
+		while (index > 0) {
+			int parent = (index - 1) / 2;
+			if (heap->entries[parent].duration <= heap->entries[index].duration) {
+				break;
+			}
+			swap_entries(&heap->entries[parent], &heap->entries[index]);
+			index = parent;
+		}
+		return;
+	}
+
+	if ((heap->size == 0) || (entry->duration <= heap->entries[0].duration)) {
+		return;
+	}
+
+	heap->entries[0] = *entry;
+	heap_sift_down(heap, 0);
+}
+
+/** Sort the heap in place so that the slowest item is first.
+ *
+ * This destroys the heap property, no more entries can be added.
+ *
+ * @param heap The heap.
+ */
+static void heap_sort_descending(slowest_heap_t *heap) {
+	int count = heap->size;
+
+	while (heap->size > 1) {
+		swap_entries(&heap->entries[0], &heap->entries[heap->size - 1]);
+		heap->size--;
+		heap_sift_down(heap, 0);
+	}
+
+	heap->size = count;
+}
+
+/** Compute histogram bucket for given duration.
+ *
+ * Buckets are logarithmic, bucket @c i holds durations
+ * from 2^i to 2^(i+1) nanoseconds.
+ *
+ * @param duration Duration in nanoseconds.
+ * @return Bucket index.
+ */
+static int get_histogram_bucket(double duration) {
+	int bucket = 0;
+	while ((duration >= 2.0) && (bucket < PCUT_SUMMARY_HISTOGRAM_SIZE - 1)) {
+		duration /= 2.0;
+		bucket++;
+	}
+	return bucket;
+}
+
+/** Lower bound of given histogram bucket.
+ *
+ * @param bucket Bucket index.
+ * @return Shortest duration (in nanoseconds) in the bucket.
+ */
+double pcut_summary_histogram_bucket_start(int bucket) {
+	double result = 1.0;
+	while (bucket > 0) {
+		result *= 2.0;
+		bucket--;
+	}
+	return result;
+}
+
+/** Start collecting statistics for a new run. */
+void pcut_summary_init(void) {
+	int i;
+
+	slowest_tests.size = 0;
+	slowest_suites.size = 0;
+	totals.wall_time = 0;
+	totals.tests_time = 0;
+	totals.body_time = 0;
+	totals.test_count = 0;
+	for (i = 0; i < PCUT_SUMMARY_HISTOGRAM_SIZE; i++) {
+		totals.histogram[i] = 0;
+	}
+	current_suite = NULL;
+
+	if (pcut_measure_durations) {
+		run_start_time = pcut_timer_now();
+	}
+}
+
+/** Note that a new suite has started.
+ *
+ * @param suite The suite.
+ */
+void pcut_summary_suite_start(pcut_item_t *suite) {
+	current_suite = suite;
+	current_suite_duration = 0;
+	current_suite_body_time = -1;
+}
+
+/** Note that a suite was completed.
+ *
+ * @param suite The suite.
+ */
+void pcut_summary_suite_done(pcut_item_t *suite) {
+	pcut_summary_entry_t entry;
+
+	if (pcut_summary_size == 0) {
+		return;
+	}
+
+	entry.item = suite;
+	entry.suite = NULL;
+	entry.duration = current_suite_duration;
+	entry.body_time = current_suite_body_time;
+	heap_offer(&slowest_suites, &entry);
+
+	current_suite = NULL;
+}
+
+/** Record duration of a completed test.
+ *
+ * @param test The test.
+ * @param measurements Measurements of the test (can be NULL).
+ */
+void pcut_summary_test_done(pcut_item_t *test,
+		const pcut_measurements_t *measurements) {
+	const pcut_measurement_t *duration;
+	const pcut_measurement_t *body_time;
+	pcut_summary_entry_t entry;
+
+	if (pcut_summary_size == 0) {
+		return;
+	}
+
+	duration = pcut_measurements_find(measurements, "duration");
+	if (duration == NULL) {
+		return;
+	}
+	body_time = pcut_measurements_find(measurements, "body-time");
+
+	entry.item = test;
+	entry.suite = current_suite;
+	entry.duration = duration->value;
+	entry.body_time = body_time == NULL ? -1 : body_time->value;
+	heap_offer(&slowest_tests, &entry);
+
+	totals.test_count++;
+	totals.tests_time += entry.duration;
+	totals.histogram[get_histogram_bucket(entry.duration)]++;
+	current_suite_duration += entry.duration;
+	if (body_time != NULL) {
+		totals.body_time += body_time->value;
+		if (current_suite_body_time < 0) {
+			current_suite_body_time = 0;
+		}
+		current_suite_body_time += body_time->value;
+	}
+}
+
+/** Finish the statistics. */
+void pcut_summary_done(void) {
+	if (pcut_summary_size == 0) {
+		return;
+	}
+
+	totals.wall_time = (double) (pcut_timer_now() - run_start_time);
+	heap_sort_descending(&slowest_tests);
+	heap_sort_descending(&slowest_suites);
+}
+
+/** Get slowest tests.
+ *
+ * Only valid after pcut_summary_done() was called.
+ *
+ * @param entries Where to store pointer to the first entry.
+ * @return Number of entries (slowest test first).
+ */
+int pcut_summary_get_slowest_tests(pcut_summary_entry_t **entries) {
+	*entries = slowest_tests.entries;
+	return slowest_tests.size;
+}
+
+/** Get slowest suites.
+ *
+ * Only valid after pcut_summary_done() was called.
+ *
+ * @param entries Where to store pointer to the first entry.
+ * @return Number of entries (slowest suite first).
+ */
+int pcut_summary_get_slowest_suites(pcut_summary_entry_t **entries) {
+	*entries = slowest_suites.entries;
+	return slowest_suites.size;
+}
+
+/** Get overall timing statistics.
+ *
+ * @return Statistics of the whole run.
+ */
+const pcut_summary_totals_t *pcut_summary_get_totals(void) {
+	return &totals;
+}
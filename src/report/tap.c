@@ -69,6 +69,22 @@ static void tap_init(pcut_item_t *all_items) {
 	printf("1..%d\n", tests_total);
 }
 
+/** Report conditions the benchmarks run in.
+ *
+ * @param environment Information about the processors.
+ */
+static void tap_environment(const pcut_cpu_environment_t *environment) {
+	printf("# environment: governor %s, turbo %s, load ",
+		environment->governor[0] != 0 ? environment->governor : "unknown",
+		environment->turbo < 0 ? "unknown" : (environment->turbo ? "on" : "off"));
+	if (environment->load < 0.0) {
+		printf("unknown");
+	} else {
+		printf("%.2f", environment->load);
+	}
+	printf(" on %d CPUs\n", environment->cpu_count);
+}
+
 /** Report that a suite was started.
  *
  * @param suite Suite that just started.
@@ -129,6 +145,31 @@ static void print_by_lines(const char *message, const char *prefix) {
 	}
 }
 
+/** Describe measured body time against the time budget.
+ *
+ * @param buffer Where to store the description.
+ * @param size Size of @p buffer in bytes.
+ * @param measurements Values measured during the test (can be NULL).
+ */
+static void format_time_budget(char *buffer, size_t size,
+		const pcut_measurements_t *measurements) {
+	const pcut_measurement_t *median = pcut_measurements_find(measurements,
+		"budget-median");
+	const pcut_measurement_t *budget = pcut_measurements_find(measurements,
+		"time-budget");
+	char median_str[PCUT_MEASUREMENT_NAME_SIZE];
+	char budget_str[PCUT_MEASUREMENT_NAME_SIZE];
+
+	if ((median == NULL) || (budget == NULL)) {
+		buffer[0] = 0;
+		return;
+	}
+
+	pcut_format_measurement(median_str, PCUT_MEASUREMENT_NAME_SIZE, median);
+	pcut_format_measurement(budget_str, PCUT_MEASUREMENT_NAME_SIZE, budget);
+	pcut_snprintf(buffer, size, " (median %s, budget %s)", median_str, budget_str);
+}
+
 /** Report a completed test.
  *
  * @param test Test that just finished.
@@ -136,13 +177,17 @@ static void print_by_lines(const char *message, const char *prefix) {
  * @param error_message Buffer with error message.
  * @param teardown_error_message Buffer with error message from a tear-down function.
  * @param extra_output Extra output from the test (stdout).
+ * @param measurements Values measured during the test (can be NULL).
  */
 static void tap_test_done(pcut_item_t *test, int outcome,
 		const char *error_message, const char *teardown_error_message,
-		const char *extra_output) {
+		const char *extra_output, const pcut_measurements_t *measurements) {
 	const char *test_name = test->name;
 	const char *status_str = NULL;
 	const char *fail_error_str = NULL;
+	char budget_str[2 * PCUT_MEASUREMENT_NAME_SIZE];
+
+	budget_str[0] = 0;
 
 	if (outcome != PCUT_OUTCOME_PASS) {
 		failed_tests_in_suite++;
@@ -158,21 +203,140 @@ static void tap_test_done(pcut_item_t *test, int outcome,
 		status_str = "not ok";
 		fail_error_str = " failed";
 		break;
+	case PCUT_OUTCOME_MEMORY_LIMIT:
+		status_str = "not ok";
+		fail_error_str = " over memory limit";
+		break;
+	case PCUT_OUTCOME_TOO_SLOW:
+		status_str = "not ok";
+		fail_error_str = " too slow";
+		format_time_budget(budget_str, sizeof(budget_str), measurements);
+		break;
 	default:
 		status_str = "not ok";
 		fail_error_str = " aborted";
 		break;
 	}
-	printf("%s %d %s%s\n", status_str, test_counter, test_name, fail_error_str);
+	printf("%s %d %s%s%s\n", status_str, test_counter, test_name,
+		fail_error_str, budget_str);
 
 	print_by_lines(error_message, "# error: ");
 	print_by_lines(teardown_error_message, "# error: ");
 
 	print_by_lines(extra_output, "# stdio: ");
+
+	if (measurements != NULL) {
+		int i;
+		for (i = 0; i < measurements->count; i++) {
+			char value[PCUT_MEASUREMENT_NAME_SIZE];
+			pcut_format_measurement(value, PCUT_MEASUREMENT_NAME_SIZE,
+				&measurements->items[i]);
+			printf("# measure: %s %s\n", measurements->items[i].name, value);
+		}
+	}
+}
+
+/** Print list of slowest items.
+ *
+ * @param title Title of the list.
+ * @param entries The slowest items.
+ * @param count Number of @p entries.
+ */
+static void print_slowest(const char *title, pcut_summary_entry_t *entries,
+		int count) {
+	int i;
+
+	if (count == 0) {
+		return;
+	}
+
+	printf("#> %s:\n", title);
+	for (i = 0; i < count; i++) {
+		char duration[PCUT_MEASUREMENT_NAME_SIZE];
+		char body_time[PCUT_MEASUREMENT_NAME_SIZE];
+
+		pcut_format_duration(duration, PCUT_MEASUREMENT_NAME_SIZE, entries[i].duration);
+		printf("#>   %2d. ", i + 1);
+		if (entries[i].suite != NULL) {
+			printf("%s.", entries[i].suite->name);
+		}
+		printf("%s %s", entries[i].item->name, duration);
+		if (entries[i].body_time >= 0) {
+			pcut_format_duration(body_time, PCUT_MEASUREMENT_NAME_SIZE, entries[i].body_time);
+			printf(" (body %s)", body_time);
+		}
+		printf("\n");
+	}
+}
+
+/** Print the end-of-run timing summary. */
+static void print_summary(void) {
+	const pcut_summary_totals_t *totals = pcut_summary_get_totals();
+	pcut_summary_entry_t *entries;
+	char wall_time[PCUT_MEASUREMENT_NAME_SIZE];
+	char body_time[PCUT_MEASUREMENT_NAME_SIZE];
+	char overhead_time[PCUT_MEASUREMENT_NAME_SIZE];
+	double overhead;
+	int max_count = 0;
+	int first = PCUT_SUMMARY_HISTOGRAM_SIZE;
+	int last = -1;
+	int count;
+	int i;
+
+	count = pcut_summary_get_slowest_tests(&entries);
+	print_slowest("Slowest tests", entries, count);
+	count = pcut_summary_get_slowest_suites(&entries);
+	print_slowest("Slowest suites", entries, count);
+
+	for (i = 0; i < PCUT_SUMMARY_HISTOGRAM_SIZE; i++) {
+		if (totals->histogram[i] == 0) {
+			continue;
+		}
+		if (first > i) {
+			first = i;
+		}
+		last = i;
+		if (totals->histogram[i] > max_count) {
+			max_count = totals->histogram[i];
+		}
+	}
+	if (last >= 0) {
+		printf("#> Duration histogram:\n");
+	}
+	for (i = first; i <= last; i++) {
+		char bucket_start[PCUT_MEASUREMENT_NAME_SIZE];
+		int bar_length = (totals->histogram[i] * 40 + max_count - 1) / max_count;
+
+		pcut_format_duration(bucket_start, PCUT_MEASUREMENT_NAME_SIZE,
+			pcut_summary_histogram_bucket_start(i));
+		printf("#>   >= %11s %5d%s", bucket_start, totals->histogram[i],
+			bar_length > 0 ? " " : "");
+		while (bar_length > 0) {
+			printf("#");
+			bar_length--;
+		}
+		printf("\n");
+	}
+
+	overhead = totals->wall_time - totals->body_time;
+	if (overhead < 0) {
+		overhead = 0;
+	}
+	pcut_format_duration(wall_time, PCUT_MEASUREMENT_NAME_SIZE, totals->wall_time);
+	pcut_format_duration(body_time, PCUT_MEASUREMENT_NAME_SIZE, totals->body_time);
+	pcut_format_duration(overhead_time, PCUT_MEASUREMENT_NAME_SIZE, overhead);
+	printf("#> Wall time %s: test bodies %s (%.1f%%), runner overhead %s (%.1f%%).\n",
+		wall_time,
+		body_time, totals->wall_time > 0 ? 100.0 * totals->body_time / totals->wall_time : 0.0,
+		overhead_time, totals->wall_time > 0 ? 100.0 * overhead / totals->wall_time : 0.0);
 }
 
 /** Report testing done. */
 static void tap_done(void) {
+	if (pcut_summary_size > 0) {
+		print_summary();
+	}
+
 	if (failed_test_counter == 0) {
 		printf("#> Done: all tests passed.\n");
 	} else {
@@ -184,5 +348,6 @@ static void tap_done(void) {
 pcut_report_ops_t pcut_report_tap = {
 	tap_init, tap_done,
 	tap_suite_start, tap_suite_done,
-	tap_test_start, tap_test_done
+	tap_test_start, tap_test_done,
+	tap_environment
 };
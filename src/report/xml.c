@@ -66,6 +66,26 @@ static void xml_init(pcut_item_t *all_items) {
 	printf("<report tests-total=\"%d\">\n", tests_total);
 }
 
+/** Report conditions the benchmarks run in.
+ *
+ * Unknown values are omitted.
+ *
+ * @param environment Information about the processors.
+ */
+static void xml_environment(const pcut_cpu_environment_t *environment) {
+	printf("\t<environment cpus=\"%d\"", environment->cpu_count);
+	if (environment->governor[0] != 0) {
+		printf(" governor=\"%s\"", environment->governor);
+	}
+	if (environment->turbo >= 0) {
+		printf(" turbo=\"%s\"", environment->turbo ? "on" : "off");
+	}
+	if (environment->load >= 0.0) {
+		printf(" load=\"%.2f\"", environment->load);
+	}
+	printf(" />\n");
+}
+
 /** Report that a suite was started.
  *
  * @param suite Suite that just started.
@@ -127,6 +147,58 @@ static void print_by_lines(const char *message, const char *element_name) {
 	printf("]]></%s>\n", element_name);
 }
 
+/** Print string as a value of an XML attribute.
+ *
+ * Measurement names can be arbitrary (e.g. counters from
+ * PCUT_BENCHMARK_SET_COUNTER()) thus special characters are escaped.
+ *
+ * @param value The value to print.
+ */
+static void print_escaped_attribute(const char *value) {
+	for (; *value != 0; value++) {
+		switch (*value) {
+		case '&':
+			printf("&amp;");
+			break;
+		case '<':
+			printf("&lt;");
+			break;
+		case '>':
+			printf("&gt;");
+			break;
+		case '"':
+			printf("&quot;");
+			break;
+		case '\'':
+			printf("&apos;");
+			break;
+		default:
+			printf("%c", *value);
+			break;
+		}
+	}
+}
+
+/** Print measured body time next to the time budget.
+ *
+ * Nothing is printed for tests without a time budget.
+ *
+ * @param measurements Values measured during the test (can be NULL).
+ */
+static void print_time_budget(const pcut_measurements_t *measurements) {
+	const pcut_measurement_t *median = pcut_measurements_find(measurements,
+		"budget-median");
+	const pcut_measurement_t *budget = pcut_measurements_find(measurements,
+		"time-budget");
+
+	if ((median == NULL) || (budget == NULL)) {
+		return;
+	}
+
+	printf("\t\t\t<time-budget median=\"%.15g\" budget=\"%.15g\" unit=\"ns\" />\n",
+		median->value, budget->value);
+}
+
 /** Report a completed test.
  *
  * @param test Test that just finished.
@@ -134,10 +206,11 @@ static void print_by_lines(const char *message, const char *element_name) {
  * @param error_message Buffer with error message.
  * @param teardown_error_message Buffer with error message from a tear-down function.
  * @param extra_output Extra output from the test (stdout).
+ * @param measurements Values measured during the test (can be NULL).
  */
 static void xml_test_done(pcut_item_t *test, int outcome,
 		const char *error_message, const char *teardown_error_message,
-		const char *extra_output) {
+		const char *extra_output, const pcut_measurements_t *measurements) {
 	const char *test_name = test->name;
 	const char *status_str = NULL;
 
@@ -150,8 +223,12 @@ static void xml_test_done(pcut_item_t *test, int outcome,
 		status_str = "pass";
 		break;
 	case PCUT_OUTCOME_FAIL:
+	case PCUT_OUTCOME_TOO_SLOW:
 		status_str = "fail";
 		break;
+	case PCUT_OUTCOME_MEMORY_LIMIT:
+		status_str = "memory-limit";
+		break;
 	default:
 		status_str = "error";
 		break;
@@ -160,16 +237,82 @@ static void xml_test_done(pcut_item_t *test, int outcome,
 	printf("\t\t<testcase name=\"%s\" status=\"%s\">\n", test_name,
 		status_str);
 
+	print_time_budget(measurements);
+
 	print_by_lines(error_message, "error-message");
 	print_by_lines(teardown_error_message, "error-message");
 
 	print_by_lines(extra_output, "standard-output");
 
+	if (measurements != NULL) {
+		int i;
+		for (i = 0; i < measurements->count; i++) {
+			printf("\t\t\t<measurement name=\"");
+			print_escaped_attribute(measurements->items[i].name);
+			printf("\" value=\"%.15g\" unit=\"", measurements->items[i].value);
+			print_escaped_attribute(measurements->items[i].unit);
+			printf("\" />\n");
+		}
+	}
+
 	printf("\t\t</testcase><!-- %s -->\n", test_name);
 }
 
+/** Print list of slowest items.
+ *
+ * @param element_name Element name for each item.
+ * @param entries The slowest items.
+ * @param count Number of @p entries.
+ */
+static void print_slowest(const char *element_name,
+		pcut_summary_entry_t *entries, int count) {
+	int i;
+
+	for (i = 0; i < count; i++) {
+		printf("\t\t<%s ", element_name);
+		if (entries[i].suite != NULL) {
+			printf("suite=\"%s\" ", entries[i].suite->name);
+		}
+		printf("name=\"%s\" duration=\"%.0f\"", entries[i].item->name,
+			entries[i].duration);
+		if (entries[i].body_time >= 0) {
+			printf(" body-time=\"%.0f\"", entries[i].body_time);
+		}
+		printf(" />\n");
+	}
+}
+
+/** Print the end-of-run timing summary. */
+static void print_summary(void) {
+	const pcut_summary_totals_t *totals = pcut_summary_get_totals();
+	pcut_summary_entry_t *entries;
+	int count;
+	int i;
+
+	printf("\t<summary wall-time=\"%.0f\" tests-time=\"%.0f\" body-time=\"%.0f\">\n",
+		totals->wall_time, totals->tests_time, totals->body_time);
+
+	count = pcut_summary_get_slowest_tests(&entries);
+	print_slowest("slowest-test", entries, count);
+	count = pcut_summary_get_slowest_suites(&entries);
+	print_slowest("slowest-suite", entries, count);
+
+	for (i = 0; i < PCUT_SUMMARY_HISTOGRAM_SIZE; i++) {
+		if (totals->histogram[i] == 0) {
+			continue;
+		}
+		printf("\t\t<histogram-bucket from=\"%.0f\" count=\"%d\" />\n",
+			pcut_summary_histogram_bucket_start(i), totals->histogram[i]);
+	}
+
+	printf("\t</summary>\n");
+}
+
 /** Report testing done. */
 static void xml_done(void) {
+	if (pcut_summary_size > 0) {
+		print_summary();
+	}
 	printf("</report>\n");
 }
 
@@ -177,5 +320,6 @@ static void xml_done(void) {
 pcut_report_ops_t pcut_report_xml = {
 	xml_init, xml_done,
 	xml_suite_start, xml_suite_done,
-	xml_test_start, xml_test_done
+	xml_test_start, xml_test_done,
+	xml_environment
 };
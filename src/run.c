@@ -71,6 +71,44 @@ static pcut_item_t *current_test = NULL;
 /** Pointer to current test suite. */
 static pcut_item_t *current_suite = NULL;
 
+/** Measurements of the currently running test (single mode only). */
+static pcut_measurements_t current_measurements;
+
+/** When the current test was started (single mode only). */
+static unsigned long long current_test_start_time;
+
+/** Size of the buffer for description of leaked blocks. */
+#define PCUT_LEAK_MESSAGE_SIZE 256
+
+/** Description of blocks leaked by the current test. */
+static char leak_message[PCUT_LEAK_MESSAGE_SIZE];
+
+/** Size of the buffer for description of exceeded memory limit. */
+#define PCUT_MEMORY_MESSAGE_SIZE 256
+
+/** Description of the exceeded memory limit. */
+static char memory_message[PCUT_MEMORY_MESSAGE_SIZE];
+
+/** Peak resident set size when the current test was started. */
+static unsigned long long peak_rss_at_start;
+
+/** Size of the buffer for description of exceeded time budget. */
+#define PCUT_BUDGET_MESSAGE_SIZE 256
+
+/** Description of the exceeded time budget. */
+static char budget_message[PCUT_BUDGET_MESSAGE_SIZE];
+
+/** Size of the buffer for description of exceeded syscall budget. */
+#define PCUT_SYSCALL_MESSAGE_SIZE 256
+
+/** Description of the exceeded syscall budget. */
+static char syscall_message[PCUT_SYSCALL_MESSAGE_SIZE];
+
+/** Durations of the body of a test with a time budget. */
+static unsigned long long budget_body_times[PCUT_TIME_BUDGET_MAX_REPEATS];
+
+int pcut_time_budget_repeats = PCUT_TIME_BUDGET_DEFAULT_REPEATS;
+
 /** A NULL-like suite. */
 static pcut_item_t default_suite;
 static int default_suite_initialized = 0;
@@ -114,6 +152,214 @@ static void run_setup_teardown(pcut_setup_func_t func) {
 	}
 }
 
+/** Get the currently running test.
+ *
+ * @return The current test (NULL outside of a test).
+ */
+pcut_item_t *pcut_get_current_test(void) {
+	return current_test;
+}
+
+/** Get suite of the currently running test.
+ *
+ * @return The current suite (NULL outside of a test).
+ */
+pcut_item_t *pcut_get_current_suite(void) {
+	return current_suite;
+}
+
+/** Get how much the peak resident set size grew during the current test.
+ *
+ * @return Growth in bytes since the start of the test set-up.
+ * @retval -1 Resident set size is not available on this platform.
+ */
+long long pcut_get_peak_rss_growth(void) {
+	unsigned long long peak_rss = pcut_get_peak_rss();
+
+	if (peak_rss == 0) {
+		return -1;
+	}
+	if (peak_rss < peak_rss_at_start) {
+		return 0;
+	}
+	return (long long) (peak_rss - peak_rss_at_start);
+}
+
+/** Record a value measured during the current test.
+ *
+ * In forked mode, the measurement is printed for the launcher process,
+ * otherwise it is attached to the test report directly.
+ *
+ * @param name Name of the measured quantity.
+ * @param value Measured value.
+ * @param unit Unit of @p value.
+ */
+void pcut_record_measurement(const char *name, double value, const char *unit) {
+	if (report_test_result) {
+		pcut_measurements_add(&current_measurements, name, value, unit);
+	} else {
+		pcut_print_measurement(name, value, unit);
+	}
+}
+
+/** Record total duration of the current test (single mode only). */
+static void record_test_duration(void) {
+	if (pcut_measure_durations) {
+		pcut_measurements_add(&current_measurements, "duration",
+			(double) (pcut_timer_now() - current_test_start_time), "ns");
+	}
+}
+
+/** Start instrumentation of the test body.
+ *
+ * The profiler and system call counting run only in the process of
+ * a single test so that the launcher is not affected.
+ *
+ * @param test The test that is about to be executed.
+ */
+static void start_body_instrumentation(pcut_item_t *test) {
+	if (pcut_perf_counters) {
+		pcut_perf_counters_start();
+	}
+	pcut_alloc_begin();
+	pcut_lock_begin();
+	if (leave_means_exit) {
+		pcut_profile_begin();
+		pcut_syscalls_begin(test);
+	}
+}
+
+/** Stop instrumentation and record what was measured.
+ *
+ * Does nothing when the instrumentation is not running.
+ */
+static void stop_body_instrumentation(void) {
+	pcut_syscalls_end();
+	pcut_profile_end();
+	pcut_lock_end();
+	pcut_alloc_end();
+	pcut_perf_counters_stop();
+}
+
+/** Start accounting of memory used by a test.
+ *
+ * The address space is limited only when the test runs in its
+ * own process.
+ *
+ * @param test The test to be started.
+ */
+static void start_memory_accounting(pcut_item_t *test) {
+	unsigned long memory_limit = pcut_get_test_memory_limit(test);
+
+	peak_rss_at_start = pcut_get_peak_rss();
+
+	if ((memory_limit > 0) && leave_means_exit) {
+		pcut_set_memory_limit(memory_limit);
+	}
+}
+
+/** Check that the test stayed within its memory limit.
+ *
+ * @param test The finished test.
+ * @return Whether the limit was exceeded (@c memory_message is set).
+ */
+static int memory_limit_exceeded(pcut_item_t *test) {
+	unsigned long memory_limit = pcut_get_test_memory_limit(test);
+	long long growth;
+
+	if (memory_limit == 0) {
+		return 0;
+	}
+
+	growth = pcut_get_peak_rss_growth();
+	if (growth < 0) {
+		return 0;
+	}
+	pcut_record_measurement("peak-rss", (double) growth, "B");
+
+	if (growth <= (long long) memory_limit) {
+		return 0;
+	}
+
+	pcut_snprintf(memory_message, PCUT_MEMORY_MESSAGE_SIZE,
+		"Memory limit exceeded: peak RSS grew by %lld bytes (limit %lu bytes)",
+		growth, memory_limit);
+	return 1;
+}
+
+/** Get median of durations (the array is sorted).
+ *
+ * @param durations Durations in nanoseconds.
+ * @param count Number of @p durations (at least one).
+ * @return Median duration.
+ */
+static unsigned long long get_median_duration(unsigned long long *durations,
+		int count) {
+	int i, j;
+
+	for (i = 1; i < count; i++) {
+		unsigned long long current = durations[i];
+		for (j = i; (j > 0) && (durations[j - 1] > current); j--) {
+			durations[j] = durations[j - 1];
+		}
+		durations[j] = current;
+	}
+
+	if (count % 2 == 1) {
+		return durations[count / 2];
+	}
+	return (durations[count / 2 - 1] + durations[count / 2]) / 2;
+}
+
+/** Check that the test body fits into its time budget.
+ *
+ * The body is run again (each time with set-up and tear-down) until
+ * there are --budget-repeats durations.
+ *
+ * @param time_budget Time budget in milliseconds.
+ * @param first_body_time Duration of the first run of the body.
+ * @return Whether the budget was exceeded (@c budget_message is set).
+ */
+static int time_budget_exceeded(int time_budget,
+		unsigned long long first_body_time) {
+	unsigned long long budget = (unsigned long long) time_budget * 1000000ULL;
+	unsigned long long median;
+	char median_str[PCUT_BUDGET_MESSAGE_SIZE];
+	int count = pcut_time_budget_repeats;
+	int i;
+
+	if (count > PCUT_TIME_BUDGET_MAX_REPEATS) {
+		count = PCUT_TIME_BUDGET_MAX_REPEATS;
+	}
+
+	budget_body_times[0] = first_body_time;
+	for (i = 1; i < count; i++) {
+		unsigned long long body_start_time;
+
+		execute_teardown_on_failure = 1;
+		run_setup_teardown(current_suite->setup_func);
+		body_start_time = pcut_timer_now();
+		current_test->test_func();
+		budget_body_times[i] = pcut_timer_now() - body_start_time;
+		execute_teardown_on_failure = 0;
+		run_setup_teardown(current_suite->teardown_func);
+	}
+
+	median = get_median_duration(budget_body_times, count);
+	pcut_record_measurement("budget-median", (double) median, "ns");
+	pcut_record_measurement("time-budget", (double) budget, "ns");
+
+	if (median <= budget) {
+		return 0;
+	}
+
+	pcut_format_duration(median_str, PCUT_BUDGET_MESSAGE_SIZE, (double) median);
+	pcut_snprintf(budget_message, PCUT_BUDGET_MESSAGE_SIZE,
+		"Too slow: median body time %s exceeds budget of %d ms (%d runs)",
+		median_str, time_budget, count);
+	return 1;
+}
+
 /** Terminate current test with given outcome.
  *
  * @warning This function may execute a long jump or terminate
@@ -147,6 +393,8 @@ void pcut_failed_assertion(const char *message) {
 	 * inform the user and perform some clean-up. That could
 	 * include running the tear-down routine.
 	 */
+	stop_body_instrumentation();
+
 	if (print_test_error) {
 		pcut_print_fail_message(message);
 	}
@@ -155,16 +403,20 @@ void pcut_failed_assertion(const char *message) {
 		execute_teardown_on_failure = 0;
 		prev_message = message;
 		run_setup_teardown(current_suite->teardown_func);
+		pcut_leaks_end(leak_message, PCUT_LEAK_MESSAGE_SIZE);
 
 		/* Tear-down was okay. */
 		if (report_test_result) {
+			record_test_duration();
 			pcut_report_test_done(current_test, PCUT_OUTCOME_FAIL,
-				message, NULL, NULL);
+				message, NULL, NULL, &current_measurements);
 		}
 	} else {
+		pcut_leaks_end(leak_message, PCUT_LEAK_MESSAGE_SIZE);
 		if (report_test_result) {
+			record_test_duration();
 			pcut_report_test_done(current_test, PCUT_OUTCOME_FAIL,
-				prev_message, message, NULL);
+				prev_message, message, NULL, &current_measurements);
 		}
 	}
 
@@ -179,6 +431,10 @@ void pcut_failed_assertion(const char *message) {
  * @return Error status (zero means success).
  */
 static int run_test(pcut_item_t *test) {
+	unsigned long long body_start_time = 0;
+	unsigned long long body_time = 0;
+	int time_budget = pcut_get_test_time_budget(test);
+
 	/*
 	 * Set here as the returning point in case of test failure.
 	 * If we get here, it means something failed during the
@@ -195,10 +451,16 @@ static int run_test(pcut_item_t *test) {
 		pcut_report_test_start(test);
 	}
 
+	pcut_measurements_clear(&current_measurements);
+	if (pcut_measure_durations) {
+		current_test_start_time = pcut_timer_now();
+	}
+
 	current_suite = pcut_find_parent_suite(test);
 	current_test = test;
 
 	pcut_hook_before_test(test);
+	start_memory_accounting(test);
 
 	/*
 	 * If anything goes wrong, execute the tear-down function
@@ -210,12 +472,24 @@ static int run_test(pcut_item_t *test) {
 	 * Run the set-up function.
 	 */
 	run_setup_teardown(current_suite->setup_func);
+	pcut_leaks_begin();
 
 	/*
 	 * The setup function was performed, it is time to run
 	 * the actual test.
 	 */
+	if (pcut_measure_durations || (time_budget > 0)) {
+		body_start_time = pcut_timer_now();
+	}
+	start_body_instrumentation(test);
 	test->test_func();
+	stop_body_instrumentation();
+	if (pcut_measure_durations || (time_budget > 0)) {
+		body_time = pcut_timer_now() - body_start_time;
+	}
+	if (pcut_measure_durations) {
+		pcut_record_measurement("body-time", (double) body_time, "ns");
+	}
 
 	/*
 	 * Finally, run the tear-down function. We need to clear
@@ -224,13 +498,72 @@ static int run_test(pcut_item_t *test) {
 	execute_teardown_on_failure = 0;
 	run_setup_teardown(current_suite->teardown_func);
 
+	if (memory_limit_exceeded(test)) {
+		pcut_leaks_end(leak_message, PCUT_LEAK_MESSAGE_SIZE);
+		if (print_test_error) {
+			pcut_print_fail_message(memory_message);
+		}
+		if (report_test_result) {
+			record_test_duration();
+			pcut_report_test_done(current_test, PCUT_OUTCOME_MEMORY_LIMIT,
+				memory_message, NULL, NULL, &current_measurements);
+		}
+		return PCUT_OUTCOME_MEMORY_LIMIT;
+	}
+
+	/*
+	 * Blocks allocated after the set-up and not released by the
+	 * tear-down were leaked.
+	 */
+	if ((pcut_leaks_end(leak_message, PCUT_LEAK_MESSAGE_SIZE) > 0)
+			&& (pcut_leak_check == PCUT_LEAK_CHECK_FAIL)) {
+		if (print_test_error) {
+			pcut_print_fail_message(leak_message);
+		}
+		if (report_test_result) {
+			record_test_duration();
+			pcut_report_test_done(current_test, PCUT_OUTCOME_FAIL,
+				leak_message, NULL, NULL, &current_measurements);
+		}
+		return PCUT_OUTCOME_FAIL;
+	}
+
+	if (pcut_syscall_budget_exceeded(test, syscall_message, PCUT_SYSCALL_MESSAGE_SIZE)) {
+		if (print_test_error) {
+			pcut_print_fail_message(syscall_message);
+		}
+		if (report_test_result) {
+			record_test_duration();
+			pcut_report_test_done(current_test, PCUT_OUTCOME_FAIL,
+				syscall_message, NULL, NULL, &current_measurements);
+		}
+		return PCUT_OUTCOME_FAIL;
+	}
+
+	/*
+	 * The test is functionally correct, check that it is also
+	 * fast enough.
+	 */
+	if ((time_budget > 0) && time_budget_exceeded(time_budget, body_time)) {
+		if (print_test_error) {
+			pcut_print_fail_message(budget_message);
+		}
+		if (report_test_result) {
+			record_test_duration();
+			pcut_report_test_done(current_test, PCUT_OUTCOME_TOO_SLOW,
+				budget_message, NULL, NULL, &current_measurements);
+		}
+		return PCUT_OUTCOME_TOO_SLOW;
+	}
+
 	/*
 	 * If we got here, it means everything went well with
 	 * this test.
 	 */
 	if (report_test_result) {
+		record_test_duration();
 		pcut_report_test_done(current_test, PCUT_OUTCOME_PASS,
-			NULL, NULL, NULL);
+			NULL, NULL, NULL, &current_measurements);
 	}
 
 	return PCUT_OUTCOME_PASS;
@@ -301,3 +634,62 @@ int pcut_get_test_timeout(pcut_item_t *test) {
 
 	return timeout;
 }
+
+/** Tells memory limit for a given test.
+ *
+ * @param test Test for which the limit is questioned.
+ * @return Memory limit in bytes (zero when not limited).
+ */
+unsigned long pcut_get_test_memory_limit(pcut_item_t *test) {
+	unsigned long memory_limit = 0;
+	pcut_extra_t *extras = test->extras;
+
+	while (extras->type != PCUT_EXTRA_LAST) {
+		if (extras->type == PCUT_EXTRA_MEMORY_LIMIT) {
+			memory_limit = extras->memory_limit;
+		}
+		extras++;
+	}
+
+	return memory_limit;
+}
+
+/** Tells time budget for a given test.
+ *
+ * @param test Test for which the budget is questioned.
+ * @return Time budget of the test body in milliseconds (zero when none).
+ */
+int pcut_get_test_time_budget(pcut_item_t *test) {
+	int time_budget = 0;
+	pcut_extra_t *extras = test->extras;
+
+	while (extras->type != PCUT_EXTRA_LAST) {
+		if (extras->type == PCUT_EXTRA_TIME_BUDGET) {
+			time_budget = extras->time_budget;
+		}
+		extras++;
+	}
+
+	return time_budget;
+}
+
+/** Tell whether a test is a benchmark.
+ *
+ * Benchmarks stay marked even after they were converted to ordinary
+ * tests when benchmarks are run.
+ *
+ * @param test Test in question.
+ * @return Whether the test was defined by one of the PCUT_BENCHMARK macros.
+ */
+int pcut_is_benchmark(pcut_item_t *test) {
+	pcut_extra_t *extras = test->extras;
+
+	while (extras->type != PCUT_EXTRA_LAST) {
+		if (extras->type == PCUT_EXTRA_BENCHMARK) {
+			return 1;
+		}
+		extras++;
+	}
+
+	return 0;
+}
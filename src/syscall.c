@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Per-test accounting of system calls.
+ *
+ * The OS layer counts system calls made while the test body is
+ * running (nothing has to change in the test itself).
+ * Counting is done only in the process running a single test as it
+ * cannot be turned off completely once started.
+ *
+ * The counts are recorded as measurements (with --syscalls) and
+ * checked against budgets set by PCUT_TEST_SYSCALL_BUDGET().
+ * Where the calls cannot be counted, the budgets are recorded as
+ * unmeasured instead of failing the tests.
+ */
+
+#include "internal.h"
+
+#pragma warning(push, 0)
+#include <stdio.h>
+#pragma warning(pop)
+
+
+/** Whether to report system calls made by each test. */
+int pcut_syscall_report = 0;
+
+/** Number of calls of each system call in the current test. */
+static unsigned long syscall_counts[PCUT_SYSCALL_MAX_NUMBER];
+
+/** Whether the system calls are being counted. */
+static int counting_active = 0;
+
+/** Whether syscall_counts are valid for the current test. */
+static int counting_done = 0;
+
+/** Whether counting was needed but could not be started. */
+static int counting_failed = 0;
+
+/** Tell whether a test has a syscall budget.
+ *
+ * @param test The test.
+ * @return Whether there is at least one PCUT_TEST_SYSCALL_BUDGET().
+ */
+static int has_syscall_budget(pcut_item_t *test) {
+	pcut_extra_t *extras = test->extras;
+
+	while (extras->type != PCUT_EXTRA_LAST) {
+		if (extras->type == PCUT_EXTRA_SYSCALL_BUDGET) {
+			return 1;
+		}
+		extras++;
+	}
+
+	return 0;
+}
+
+/** Find number of a system call given in a budget.
+ *
+ * Besides names known to the OS layer, plain numbers are accepted
+ * for system calls that it does not know.
+ *
+ * @param name Name or number of the system call.
+ * @return System call number.
+ * @retval -1 Unknown system call.
+ */
+static int get_syscall_number(const char *name) {
+	const char *it;
+
+	if (*name == 0) {
+		return -1;
+	}
+	for (it = name; *it != 0; it++) {
+		if ((*it < '0') || (*it > '9')) {
+			return pcut_syscall_number(name);
+		}
+	}
+
+	return pcut_str_to_int(name);
+}
+
+/** Warn about syscall budgets that will not be checked.
+ *
+ * Budgets are ignored in the single-process mode (-u) and on platforms
+ * where system calls cannot be counted, --syscalls is ignored there too.
+ *
+ * @param items Head of the list of all items.
+ */
+void pcut_syscalls_check_support(pcut_item_t *items) {
+	pcut_item_t *it;
+	int any_budget = 0;
+
+	for (it = items; it != NULL; it = pcut_get_real_next(it)) {
+		if ((it->kind == PCUT_KIND_TEST) && has_syscall_budget(it)) {
+			any_budget = 1;
+			break;
+		}
+	}
+
+	if (!pcut_syscall_counting_available()) {
+		if (pcut_syscall_report) {
+			fprintf(stderr, "System calls cannot be counted on this platform, ignoring --syscalls.\n");
+			pcut_syscall_report = 0;
+		}
+		if (any_budget) {
+			fprintf(stderr, "System calls cannot be counted on this platform, syscall budgets are not checked.\n");
+		}
+	} else if (any_budget && (pcut_run_mode == PCUT_RUN_MODE_SINGLE)) {
+		fprintf(stderr, "Syscall budgets are not checked with -u.\n");
+	}
+}
+
+/** Start counting system calls of the test body.
+ *
+ * Does nothing unless the calls are reported or the test has
+ * a syscall budget.
+ *
+ * @param test The test that is about to be executed.
+ */
+void pcut_syscalls_begin(pcut_item_t *test) {
+	int i;
+
+	counting_done = 0;
+	counting_failed = 0;
+
+	if (!pcut_syscall_report && !has_syscall_budget(test)) {
+		return;
+	}
+
+	for (i = 0; i < PCUT_SYSCALL_MAX_NUMBER; i++) {
+		syscall_counts[i] = 0;
+	}
+
+	counting_active = pcut_syscall_counting_start(syscall_counts,
+		PCUT_SYSCALL_MAX_NUMBER);
+	counting_failed = !counting_active;
+}
+
+/** Tell whether a system call was already reported.
+ *
+ * @param reported Numbers of reported system calls.
+ * @param count Number of items in @p reported.
+ * @param number System call number.
+ * @return Whether @p number is in @p reported.
+ */
+static int was_reported(const int *reported, int count, int number) {
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (reported[i] == number) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/** Record the most frequent system calls as measurements. */
+static void record_syscalls(void) {
+	int reported[PCUT_SYSCALL_REPORT_COUNT];
+	unsigned long total = 0;
+	int count;
+	int i;
+
+	for (i = 0; i < PCUT_SYSCALL_MAX_NUMBER; i++) {
+		total += syscall_counts[i];
+	}
+	pcut_record_measurement("syscalls", (double) total, "x");
+
+	for (count = 0; count < PCUT_SYSCALL_REPORT_COUNT; count++) {
+		char name[PCUT_MEASUREMENT_NAME_SIZE];
+		const char *syscall_name;
+		int best = -1;
+
+		for (i = 0; i < PCUT_SYSCALL_MAX_NUMBER; i++) {
+			if ((syscall_counts[i] == 0) || was_reported(reported, count, i)) {
+				continue;
+			}
+			if ((best < 0) || (syscall_counts[i] > syscall_counts[best])) {
+				best = i;
+			}
+		}
+		if (best < 0) {
+			break;
+		}
+		reported[count] = best;
+
+		syscall_name = pcut_syscall_name(best);
+		if (syscall_name != NULL) {
+			pcut_snprintf(name, PCUT_MEASUREMENT_NAME_SIZE, "syscall:%s", syscall_name);
+		} else {
+			pcut_snprintf(name, PCUT_MEASUREMENT_NAME_SIZE, "syscall:%d", best);
+		}
+		pcut_record_measurement(name, (double) syscall_counts[best], "x");
+	}
+}
+
+/** Stop counting system calls and record them as measurements.
+ *
+ * Does nothing when the system calls are not being counted.
+ */
+void pcut_syscalls_end(void) {
+	if (!counting_active) {
+		return;
+	}
+	pcut_syscall_counting_stop();
+	counting_active = 0;
+	counting_done = 1;
+
+	if (pcut_syscall_report) {
+		record_syscalls();
+	}
+}
+
+/** Check that the test body stayed within its syscall budgets.
+ *
+ * Budgets are not checked when the test did not run in its own
+ * process (i.e. the calls were not counted at all).
+ * When counting failed to start, the budgets are recorded as
+ * unmeasured and the test does not fail.
+ *
+ * @param test The finished test.
+ * @param message Where to store description of the exceeded budget.
+ * @param size Size of @p message in bytes.
+ * @return Whether a budget was exceeded (or names an unknown call).
+ */
+int pcut_syscall_budget_exceeded(pcut_item_t *test, char *message, size_t size) {
+	pcut_extra_t *extras = test->extras;
+
+	for (; extras->type != PCUT_EXTRA_LAST; extras++) {
+		int number;
+
+		if (extras->type != PCUT_EXTRA_SYSCALL_BUDGET) {
+			continue;
+		}
+
+		if (counting_failed) {
+			char name[PCUT_MEASUREMENT_NAME_SIZE];
+			pcut_snprintf(name, PCUT_MEASUREMENT_NAME_SIZE, "syscall-budget:%s",
+				extras->syscall_name);
+			pcut_record_measurement(name, (double) extras->syscall_budget,
+				"unmeasured");
+			continue;
+		}
+		if (!counting_done) {
+			return 0;
+		}
+
+		number = get_syscall_number(extras->syscall_name);
+		if ((number < 0) || (number >= PCUT_SYSCALL_MAX_NUMBER)) {
+			pcut_snprintf(message, size, "Unknown system call %s",
+				extras->syscall_name);
+			return 1;
+		}
+		if (syscall_counts[number] > (unsigned long) extras->syscall_budget) {
+			pcut_snprintf(message, size,
+				"Syscall budget exceeded: %s called %lu times (budget %d)",
+				extras->syscall_name, syscall_counts[number],
+				extras->syscall_budget);
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * Platform-independent part of the timer.
+ *
+ * The clock itself is provided by the OS-specific part
+ * (pcut_timer_now() and pcut_timer_source()).
+ */
+
+#include "internal.h"
+
+
+/** Number of readings used for estimating the overhead. */
+#define OVERHEAD_READINGS 1000
+
+/** Number of rounds of OVERHEAD_READINGS (the fastest one is used). */
+#define OVERHEAD_ROUNDS 5
+
+/** Number of reading pairs used for estimating the resolution. */
+#define RESOLUTION_ROUNDS 16
+
+/** Measured resolution (zero until measured). */
+static double resolution = 0.0;
+
+/** Measured overhead (negative until measured). */
+static double overhead = -1.0;
+
+double pcut_timer_resolution(void) {
+	int i;
+
+	if (resolution > 0.0) {
+		return resolution;
+	}
+
+	for (i = 0; i < RESOLUTION_ROUNDS; i++) {
+		unsigned long long first = pcut_timer_now();
+		unsigned long long second;
+		do {
+			second = pcut_timer_now();
+		} while (second == first);
+		if ((resolution == 0.0) || ((double) (second - first) < resolution)) {
+			resolution = (double) (second - first);
+		}
+	}
+
+	return resolution;
+}
+
+double pcut_timer_overhead(void) {
+	int round, i;
+
+	if (overhead >= 0.0) {
+		return overhead;
+	}
+
+	for (round = 0; round < OVERHEAD_ROUNDS; round++) {
+		unsigned long long start = pcut_timer_now();
+		unsigned long long end = start;
+		double mean;
+
+		for (i = 0; i < OVERHEAD_READINGS; i++) {
+			end = pcut_timer_now();
+		}
+		mean = (double) (end - start) / OVERHEAD_READINGS;
+		if ((overhead < 0.0) || (mean < overhead)) {
+			overhead = mean;
+		}
+	}
+
+	return overhead;
+}
+
+void pcut_timer_start(pcut_timer_t *timer) {
+	timer->start = pcut_timer_now();
+}
+
+unsigned long long pcut_timer_elapsed(const pcut_timer_t *timer) {
+	return pcut_timer_now() - timer->start;
+}
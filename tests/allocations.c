@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Because of posix_memalign(). */
+#define _POSIX_C_SOURCE 200112L
+
+#include <pcut/pcut.h>
+#include <stdlib.h>
+
+PCUT_INIT
+
+static char *argv_patched[] = {
+	NULL, /* Will be patched at run-time. */
+	(char *) "--alloc-stats",
+	NULL
+};
+
+static void pre_init_hook(int *argc, char **argv[]) {
+	argv_patched[0] = (*argv)[0];
+	*argc = 2;
+	*argv = argv_patched;
+}
+
+/* Volatile to prevent the compiler from removing the allocations. */
+static void *volatile blocks[3];
+
+PCUT_TEST(no_allocation) {
+	PCUT_ASSERT_MAX_ALLOCATIONS(0);
+}
+
+PCUT_TEST(two_allocations) {
+	blocks[0] = malloc(16);
+	blocks[1] = calloc(2, 16);
+	free(blocks[0]);
+	free(blocks[1]);
+	PCUT_ASSERT_MAX_ALLOCATIONS(2);
+}
+
+PCUT_TEST(aligned_allocation) {
+	void *block;
+	PCUT_ASSERT_INT_EQUALS(0, posix_memalign(&block, 64, 64));
+	blocks[0] = block;
+	free(blocks[0]);
+	PCUT_ASSERT_MAX_ALLOCATIONS(1);
+}
+
+PCUT_TEST(too_many_allocations) {
+	int i;
+	for (i = 0; i < 3; i++) {
+		blocks[i] = malloc(8);
+	}
+	for (i = 0; i < 3; i++) {
+		free(blocks[i]);
+	}
+	PCUT_ASSERT_MAX_ALLOCATIONS(2);
+}
+
+PCUT_CUSTOM_MAIN(
+	PCUT_MAIN_SET_PREINIT_HOOK(pre_init_hook)
+)
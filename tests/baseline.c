@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pcut/pcut.h>
+#include <stdio.h>
+
+PCUT_INIT
+
+/*
+ * Baseline where one benchmark was incredibly fast and the other
+ * incredibly slow.
+ */
+static const char *baseline_content =
+	"comparing.regressed ns 5 0.001 0.001 0.001 0.001 0.001\n"
+	"comparing.improved ns 5 1e9 1e9 1e9 1e9 1e9\n";
+
+static char *argv_patched[] = {
+	NULL, /* Will be patched at run-time. */
+	(char *) "--benchmarks",
+	(char *) "--baseline=baseline.old",
+	(char *) "--save-baseline=baseline.new",
+	(char *) "--min-effect=10",
+	NULL
+};
+
+static void pre_init_hook(int *argc, char **argv[]) {
+	FILE *baseline = fopen("baseline.old", "w");
+	if (baseline != NULL) {
+		fputs(baseline_content, baseline);
+		fclose(baseline);
+	}
+
+	argv_patched[0] = (*argv)[0];
+	*argc = 5;
+	*argv = argv_patched;
+}
+
+static volatile int counter;
+
+PCUT_TEST_SUITE(comparing);
+
+PCUT_BENCHMARK(regressed) {
+	unsigned long i;
+	for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+		counter++;
+	}
+}
+
+PCUT_BENCHMARK(improved) {
+	unsigned long i;
+	for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+		counter++;
+	}
+}
+
+PCUT_BENCHMARK(not_in_baseline) {
+	unsigned long i;
+	for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+		counter++;
+	}
+}
+
+PCUT_CUSTOM_MAIN(
+	PCUT_MAIN_SET_PREINIT_HOOK(pre_init_hook)
+)
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pcut/pcut.h>
+#include <stdio.h>
+
+PCUT_INIT
+
+/*
+ * When the instruction counters are not available, the runner falls back
+ * to measuring time. The baseline thus has the benchmark under both
+ * metrics and with values so high that it is always an improvement.
+ */
+static const char *baseline_content =
+	"instructions.compared instructions 5 1e12 1e12 1e12 1e12 1e12\n"
+	"instructions.compared ns 5 1e12 1e12 1e12 1e12 1e12\n";
+
+static char *argv_patched[] = {
+	NULL, /* Will be patched at run-time. */
+	(char *) "--benchmarks",
+	(char *) "--benchmark-mode=instructions",
+	(char *) "--benchmark-iterations=100",
+	(char *) "--baseline=benchinstr.old",
+	NULL
+};
+
+static void pre_init_hook(int *argc, char **argv[]) {
+	FILE *baseline = fopen("benchinstr.old", "w");
+	if (baseline != NULL) {
+		fputs(baseline_content, baseline);
+		fclose(baseline);
+	}
+
+	argv_patched[0] = (*argv)[0];
+	*argc = 5;
+	*argv = argv_patched;
+}
+
+static volatile int counter;
+
+PCUT_TEST_SUITE(instructions);
+
+PCUT_BENCHMARK(increment) {
+	unsigned long i;
+	for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+		counter++;
+	}
+}
+
+PCUT_BENCHMARK(paused_preparation) {
+	unsigned long i;
+	int value = 0;
+	for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+		PCUT_BENCHMARK_PAUSE_TIMING();
+		value = (int) i;
+		pcut_clobber_memory();
+		PCUT_BENCHMARK_RESUME_TIMING();
+		value *= 3;
+		pcut_do_not_optimize(&value);
+	}
+}
+
+PCUT_BENCHMARK(compared) {
+	unsigned long i;
+	for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+		counter++;
+	}
+}
+
+PCUT_CUSTOM_MAIN(
+	PCUT_MAIN_SET_PREINIT_HOOK(pre_init_hook)
+)
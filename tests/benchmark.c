@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pcut/pcut.h>
+
+PCUT_INIT
+
+static char *argv_patched[] = {
+	NULL, /* Will be patched at run-time. */
+	(char *) "--benchmarks",
+	NULL
+};
+
+static void pre_init_hook(int *argc, char **argv[]) {
+	argv_patched[0] = (*argv)[0];
+	*argc = 2;
+	*argv = argv_patched;
+}
+
+static volatile int counter;
+static int set_up = 0;
+
+PCUT_TEST_SUITE(counting);
+
+PCUT_TEST_BEFORE {
+	set_up = 1;
+	counter = 0;
+}
+
+PCUT_TEST_AFTER {
+	set_up = 0;
+}
+
+PCUT_TEST(plain_test) {
+	PCUT_ASSERT_INT_EQUALS(1, set_up);
+}
+
+PCUT_BENCHMARK(increment) {
+	unsigned long i;
+	PCUT_ASSERT_INT_EQUALS(1, set_up);
+	for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+		counter++;
+	}
+}
+
+PCUT_BENCHMARK(paused_preparation) {
+	unsigned long i;
+	int value = 0;
+	for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+		PCUT_BENCHMARK_PAUSE_TIMING();
+		value = (int) i;
+		pcut_clobber_memory();
+		PCUT_BENCHMARK_RESUME_TIMING();
+		value *= 3;
+		pcut_do_not_optimize(&value);
+	}
+}
+
+PCUT_BENCHMARK(throughput) {
+	unsigned long i;
+	char buffer[64];
+	int checksum = 0;
+
+	PCUT_BENCHMARK_SET_BYTES_PROCESSED(sizeof(buffer));
+	PCUT_BENCHMARK_SET_ITEMS_PROCESSED(1);
+	PCUT_BENCHMARK_SET_COUNTER("checksums", 1);
+	for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+		size_t j;
+		for (j = 0; j < sizeof(buffer); j++) {
+			buffer[j] = (char) (i + j);
+			checksum += buffer[j];
+		}
+		pcut_do_not_optimize(&checksum);
+	}
+}
+
+static volatile unsigned long per_thread_counters[4];
+
+PCUT_BENCHMARK_THREADS(scaling, 3) {
+	unsigned long i;
+	for (i = 0; i < PCUT_BENCHMARK_ITERATIONS; i++) {
+		per_thread_counters[PCUT_BENCHMARK_THREAD_INDEX]++;
+	}
+}
+
+PCUT_BENCHMARK(skipped, PCUT_TEST_SKIP) {
+	PCUT_ASSERT_INT_EQUALS(0, (int) PCUT_BENCHMARK_ITERATIONS);
+}
+
+PCUT_CUSTOM_MAIN(
+	PCUT_MAIN_SET_PREINIT_HOOK(pre_init_hook)
+)
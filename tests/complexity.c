@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pcut/pcut.h>
+
+PCUT_INIT
+
+#define MAX_SIZE 1024
+
+static int data[MAX_SIZE];
+
+PCUT_TEST_SUITE(complexity);
+
+PCUT_BENCHMARK_VARIANT(binary_search) {
+	unsigned long low = 0;
+	unsigned long high = PCUT_BENCHMARK_N;
+
+	while (low + 1 < high) {
+		unsigned long middle = (low + high) / 2;
+		PCUT_BENCHMARK_COUNT_OPERATIONS(1);
+		if (middle > 3) {
+			high = middle;
+		} else {
+			low = middle;
+		}
+	}
+}
+
+PCUT_BENCHMARK_VARIANT(linear_scan) {
+	unsigned long i;
+	for (i = 0; i < PCUT_BENCHMARK_N; i++) {
+		PCUT_BENCHMARK_COUNT_OPERATIONS(1);
+	}
+}
+
+/* Insertion sort of reversed data is quadratic. */
+PCUT_BENCHMARK_VARIANT(insertion_sort) {
+	unsigned long i, j;
+
+	for (i = 0; i < PCUT_BENCHMARK_N; i++) {
+		data[i] = (int) (PCUT_BENCHMARK_N - i);
+	}
+	for (i = 1; i < PCUT_BENCHMARK_N; i++) {
+		int value = data[i];
+		for (j = i; j > 0; j--) {
+			PCUT_BENCHMARK_COUNT_OPERATIONS(1);
+			if (data[j - 1] <= value) {
+				break;
+			}
+			data[j] = data[j - 1];
+		}
+		data[j] = value;
+	}
+}
+
+PCUT_TEST(logarithmic) {
+	PCUT_MEASURE_COMPLEXITY(binary_search, 16, MAX_SIZE);
+	PCUT_ASSERT_COMPLEXITY_AT_MOST(PCUT_O_LOG_N);
+	PCUT_ASSERT_INT_EQUALS(PCUT_O_LOG_N, pcut_get_complexity());
+}
+
+PCUT_TEST(linear) {
+	PCUT_MEASURE_COMPLEXITY(linear_scan, 16, MAX_SIZE);
+	PCUT_ASSERT_COMPLEXITY_AT_MOST(PCUT_O_N);
+	PCUT_ASSERT_INT_EQUALS(PCUT_O_N, pcut_get_complexity());
+}
+
+PCUT_TEST(quadratic) {
+	PCUT_MEASURE_COMPLEXITY(insertion_sort, 16, MAX_SIZE);
+	PCUT_ASSERT_COMPLEXITY_AT_MOST(PCUT_O_N_LOG_N);
+}
+
+PCUT_TEST(not_measured) {
+	PCUT_ASSERT_COMPLEXITY_AT_MOST(PCUT_O_N);
+}
+
+PCUT_MAIN()
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** We need POSIX 2008 because of read-write locks. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <pcut/pcut.h>
+#include <pthread.h>
+#include <time.h>
+
+PCUT_INIT
+
+static char *argv_patched[] = {
+	NULL, /* Will be patched at run-time. */
+	(char *) "--lock-stats",
+	NULL
+};
+
+static void pre_init_hook(int *argc, char **argv[]) {
+	argv_patched[0] = (*argv)[0];
+	*argc = 2;
+	*argv = argv_patched;
+}
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+
+static volatile int signalled;
+
+static void *lock_mutex_in_thread(void *arg) {
+	(void) arg;
+	pthread_mutex_lock(&mutex);
+	pthread_mutex_unlock(&mutex);
+	return NULL;
+}
+
+static void *signal_in_thread(void *arg) {
+	(void) arg;
+	pthread_mutex_lock(&mutex);
+	signalled = 1;
+	pthread_cond_signal(&cond);
+	pthread_mutex_unlock(&mutex);
+	return NULL;
+}
+
+static void *read_lock_in_thread(void *arg) {
+	(void) arg;
+	pthread_rwlock_rdlock(&rwlock);
+	pthread_rwlock_unlock(&rwlock);
+	return NULL;
+}
+
+PCUT_TEST(uncontended) {
+	struct timespec deadline;
+
+	pthread_mutex_lock(&mutex);
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	pthread_cond_timedwait(&cond, &mutex, &deadline);
+	pthread_mutex_unlock(&mutex);
+
+	pthread_rwlock_rdlock(&rwlock);
+	pthread_rwlock_unlock(&rwlock);
+	pthread_rwlock_wrlock(&rwlock);
+	pthread_rwlock_unlock(&rwlock);
+
+	PCUT_ASSERT_MAX_CONTENDED_LOCKS(0);
+}
+
+PCUT_TEST(contended) {
+	struct timespec delay = { 0, 50 * 1000 * 1000 };
+	pthread_t thread;
+
+	pthread_mutex_lock(&mutex);
+	PCUT_ASSERT_INT_EQUALS(0, pthread_create(&thread, NULL, lock_mutex_in_thread, NULL));
+	/* Give the thread time to block on the mutex. */
+	nanosleep(&delay, NULL);
+	pthread_mutex_unlock(&mutex);
+	pthread_join(thread, NULL);
+
+	PCUT_ASSERT_MAX_CONTENDED_LOCKS(0);
+}
+
+PCUT_TEST(two_threads) {
+	struct timespec delay = { 0, 50 * 1000 * 1000 };
+	pthread_t thread;
+	int rc = 0;
+
+	/* The thread blocks on the mutex and then wakes us up. */
+	signalled = 0;
+	pthread_mutex_lock(&mutex);
+	PCUT_ASSERT_INT_EQUALS(0, pthread_create(&thread, NULL, signal_in_thread, NULL));
+	nanosleep(&delay, NULL);
+	while (!signalled && (rc == 0)) {
+		rc = pthread_cond_wait(&cond, &mutex);
+	}
+	pthread_mutex_unlock(&mutex);
+	pthread_join(thread, NULL);
+	PCUT_ASSERT_INT_EQUALS(0, rc);
+	PCUT_ASSERT_TRUE(signalled);
+
+	/* The thread blocks on the read-write lock. */
+	pthread_rwlock_wrlock(&rwlock);
+	PCUT_ASSERT_INT_EQUALS(0, pthread_create(&thread, NULL, read_lock_in_thread, NULL));
+	nanosleep(&delay, NULL);
+	pthread_rwlock_unlock(&rwlock);
+	pthread_join(thread, NULL);
+
+	PCUT_ASSERT_TRUE(pcut_get_contended_lock_count() >= 2);
+}
+
+PCUT_CUSTOM_MAIN(
+	PCUT_MAIN_SET_PREINIT_HOOK(pre_init_hook)
+)
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pcut/pcut.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+PCUT_INIT
+
+#define MB (1024 * 1024)
+
+/* Never touched before the test so it does not count into the RSS. */
+static char untouched[16 * MB];
+
+/* Volatile to prevent the compiler from removing the allocations. */
+static char *volatile block;
+
+PCUT_TEST_SUITE(memory_limits);
+
+PCUT_TEST(within_limit, PCUT_TEST_MEMORY_LIMIT(32 * MB)) {
+	block = malloc(MB);
+	PCUT_ASSERT_NOT_NULL(block);
+	memset(block, 1, MB);
+	free(block);
+}
+
+PCUT_TEST(resident_over_limit, PCUT_TEST_MEMORY_LIMIT(4 * MB)) {
+	memset(untouched, 1, sizeof(untouched));
+}
+
+PCUT_TEST(allocation_refused, PCUT_TEST_MEMORY_LIMIT(4 * MB)) {
+	block = malloc(64 * MB);
+	memset(block, 1, 64 * MB);
+}
+
+PCUT_TEST(crash_within_limit, PCUT_TEST_MEMORY_LIMIT(32 * MB)) {
+	/* Stale errno must not turn a crash into exceeded limit. */
+	errno = ENOMEM;
+	abort();
+}
+
+PCUT_TEST(peak_rss_below) {
+	block = malloc(MB);
+	PCUT_ASSERT_NOT_NULL(block);
+	memset(block, 1, MB);
+	free(block);
+	PCUT_ASSERT_PEAK_RSS_BELOW(32 * MB);
+}
+
+PCUT_TEST(peak_rss_above) {
+	block = malloc(4 * MB);
+	PCUT_ASSERT_NOT_NULL(block);
+	memset(block, 1, 4 * MB);
+	free(block);
+	PCUT_ASSERT_PEAK_RSS_BELOW(MB);
+}
+
+PCUT_MAIN()
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pcut/pcut.h>
+#include <stdio.h>
+#include <string.h>
+
+PCUT_INIT
+
+static char *argv_patched[] = {
+	NULL, /* Will be patched at run-time. */
+	(char *) "--profile=profile.folded",
+	NULL
+};
+
+static void pre_init_hook(int *argc, char **argv[]) {
+	argv_patched[0] = (*argv)[0];
+	*argc = 2;
+	*argv = argv_patched;
+}
+
+static volatile unsigned long counter;
+
+/* Not static so that the profiler finds its name. */
+void spin_hot_function(unsigned long iterations);
+
+void spin_hot_function(unsigned long iterations) {
+	unsigned long i;
+	for (i = 0; i < iterations; i++) {
+		counter++;
+	}
+}
+
+PCUT_TEST_SUITE(profiling);
+
+PCUT_TEST(hot_loop) {
+	spin_hot_function(100000000UL);
+}
+
+PCUT_TEST(folded_stacks_written) {
+	char line[4096];
+	int found = 0;
+	FILE *folded = fopen("profile.folded", "r");
+
+	PCUT_ASSERT_NOT_NULL(folded);
+	while (fgets(line, sizeof(line), folded) != NULL) {
+		if ((strncmp(line, "profiling.hot_loop;", 19) == 0)
+				&& (strstr(line, ";spin_hot_function ") != NULL)) {
+			found = 1;
+		}
+	}
+	fclose(folded);
+
+	PCUT_ASSERT_TRUE(found);
+}
+
+PCUT_CUSTOM_MAIN(
+	PCUT_MAIN_SET_PREINIT_HOOK(pre_init_hook)
+)
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pcut/pcut.h>
+#include <stdio.h>
+
+PCUT_INIT
+
+/*
+ * The journal claims that the first test passed and the run was
+ * interrupted while writing result of the second one.
+ */
+static const char *journal_content =
+	"{\"suite\":\"Default\",\"test\":\"recorded\",\"outcome\":0,"
+	"\"error\":\"\",\"teardown-error\":\"\",\"output\":\"Recorded output.\","
+	"\"measurements\":[]}\n"
+	"{\"suite\":\"Default\",\"test\":\"interrupted\",\"outc";
+
+static char *argv_patched[] = {
+	NULL, /* Will be patched at run-time. */
+	(char *) "--journal=resume.journal",
+	(char *) "--resume",
+	NULL
+};
+
+static void pre_init_hook(int *argc, char **argv[]) {
+	FILE *journal = fopen("resume.journal", "w");
+	if (journal != NULL) {
+		fputs(journal_content, journal);
+		fclose(journal);
+	}
+
+	argv_patched[0] = (*argv)[0];
+	*argc = 3;
+	*argv = argv_patched;
+}
+
+PCUT_TEST(recorded) {
+	PCUT_ASSERT_TRUE(0 && "not replayed from the journal");
+}
+
+PCUT_TEST(interrupted) {
+	printf("Running again.\n");
+}
+
+PCUT_TEST(not_started) {
+	PCUT_ASSERT_INT_EQUALS(1, 1);
+}
+
+PCUT_CUSTOM_MAIN(
+	PCUT_MAIN_SET_PREINIT_HOOK(pre_init_hook)
+)
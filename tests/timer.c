@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pcut/pcut.h>
+
+PCUT_INIT
+
+static volatile int counter;
+
+PCUT_TEST_SUITE(timer);
+
+PCUT_TEST(monotonic) {
+	unsigned long long previous = pcut_timer_now();
+	int i;
+
+	for (i = 0; i < 1000; i++) {
+		unsigned long long now = pcut_timer_now();
+		PCUT_ASSERT_TRUE(now >= previous);
+		previous = now;
+	}
+}
+
+PCUT_TEST(elapsed) {
+	pcut_timer_t timer;
+	unsigned long long elapsed;
+	unsigned long long later;
+
+	pcut_timer_start(&timer);
+	while (pcut_timer_elapsed(&timer) < 1000000) {
+		counter++;
+	}
+	elapsed = pcut_timer_elapsed(&timer);
+	later = pcut_timer_elapsed(&timer);
+
+	PCUT_ASSERT_TRUE(elapsed >= 1000000);
+	PCUT_ASSERT_TRUE(later >= elapsed);
+}
+
+PCUT_TEST(self_description) {
+	PCUT_ASSERT_NOT_NULL(pcut_timer_source());
+	PCUT_ASSERT_TRUE(pcut_timer_resolution() > 0.0);
+	PCUT_ASSERT_TRUE(pcut_timer_overhead() >= 0.0);
+	/* Reading the timer must be cheaper than a millisecond. */
+	PCUT_ASSERT_TRUE(pcut_timer_overhead() < 1000000.0);
+}
+
+PCUT_MAIN()